@@ -0,0 +1,675 @@
+// Copyright 2025
+// SPDX-License-Identifier: Apache-2.0
+
+#include "capture_device.h"
+#include "trace.h"
+
+// ANARI
+#include <anari/frontend/type_utility.h>
+
+// std
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+namespace agx2usd {
+
+CaptureDevice::CaptureDevice(ANARILibrary library) : anari::DeviceImpl(library)
+{
+}
+
+CaptureDevice::~CaptureDevice()
+{
+  // Drains the queue and saves the stage
+  writer.reset();
+  if (traceStarted)
+    stopTrace();
+
+  if (wrappedDevice)
+    anariRelease(wrappedDevice, wrappedDevice);
+  if (wrappedLibrary)
+    anariUnloadLibrary(wrappedLibrary);
+}
+
+// Helper functions ///////////////////////////////////////////////////////////
+
+// Errors of the capture device itself go to the status callback the
+// library was loaded with
+void CaptureDevice::reportError(const std::string &message)
+{
+  ANARIStatusCallback callback = defaultStatusCallback();
+  if (!callback) {
+    std::cerr << "Error: " << message << "\n";
+    return;
+  }
+  callback(defaultStatusCallbackUserPtr(),
+      this_device(),
+      this_device(),
+      ANARI_DEVICE,
+      ANARI_SEVERITY_ERROR,
+      ANARI_STATUS_UNKNOWN_ERROR,
+      message.c_str());
+}
+
+// The device that does the actual work: either the one passed as the
+// "wrappedDevice" parameter, or the default device of the library named by
+// AGX2USD_CAPTURE_WRAPPED (helide if unset), loaded on first use. Null if
+// that library cannot be loaded, in which case every call that creates an
+// object returns null and the others do nothing.
+ANARIDevice CaptureDevice::wrapped()
+{
+  if (wrappedDevice || wrappedFailed)
+    return wrappedDevice;
+
+  const char *libraryName = std::getenv("AGX2USD_CAPTURE_WRAPPED");
+  if (!libraryName)
+    libraryName = "helide";
+  wrappedLibrary = anariLoadLibrary(
+      libraryName, defaultStatusCallback(), defaultStatusCallbackUserPtr());
+  if (wrappedLibrary)
+    wrappedDevice = anariNewDevice(wrappedLibrary, "default");
+  if (!wrappedDevice) {
+    // Reported once, not on every call
+    wrappedFailed = true;
+    reportError(std::string("Failed to create a device of ANARI library '")
+        + libraryName + "' to wrap, nothing is rendered or captured");
+    return nullptr;
+  }
+  anariCommitParameters(wrappedDevice, wrappedDevice);
+  return wrappedDevice;
+}
+
+// Calls on the capture device itself go to the wrapped device
+ANARIObject CaptureDevice::forwarded(ANARIObject object)
+{
+  return object == this_device() ? wrapped() : object;
+}
+
+void CaptureDevice::setDeviceParameter(
+    const char *name, ANARIDataType type, const void *mem)
+{
+  if (!std::strcmp(name, "wrappedDevice") && type == ANARI_DEVICE) {
+    wrappedDevice = *static_cast<const ANARIDevice *>(mem);
+    anariRetain(wrappedDevice, wrappedDevice);
+  } else if (!std::strcmp(name, "outputFile") && type == ANARI_STRING) {
+    outputFile = static_cast<const char *>(mem);
+  } else if (!std::strcmp(name, "traceFile") && type == ANARI_STRING) {
+    traceFile = static_cast<const char *>(mem);
+  } else if (!std::strcmp(name, "quantizePositions") && type == ANARI_BOOL) {
+    options.quantizePositions = *static_cast<const bool *>(mem);
+  } else if (!std::strcmp(name, "positionPrecision") && type == ANARI_FLOAT32) {
+    options.positionPrecision = *static_cast<const float *>(mem);
+  } else if (!std::strcmp(name, "deltaKeyInterval") && type == ANARI_UINT32) {
+    options.deltaKeyInterval = *static_cast<const uint32_t *>(mem);
+  } else if (!std::strcmp(name, "sortPoints") && type == ANARI_BOOL) {
+    options.sortPoints = *static_cast<const bool *>(mem);
+  } else if (ANARIDevice device = wrapped()) {
+    anariSetParameter(device, device, name, type, mem);
+  }
+}
+
+// Shared arrays are compared against the last copy, so an unchanged array
+// keeps its snapshot and is not sent again
+std::shared_ptr<const std::vector<uint8_t>> CaptureDevice::currentData(
+    ArrayRecord &array)
+{
+  if (!array.appMemory)
+    return array.snapshot;
+
+  const size_t bytes = array.elementCount * anari::sizeOf(array.elementType);
+  if (array.snapshot && array.snapshot->size() == bytes
+      && std::memcmp(array.snapshot->data(), array.appMemory, bytes) == 0)
+    return array.snapshot;
+
+  const auto *begin = static_cast<const uint8_t *>(array.appMemory);
+  array.snapshot = std::make_shared<std::vector<uint8_t>>(begin, begin + bytes);
+  return array.snapshot;
+}
+
+void CaptureDevice::captureGeometry(GeometryRecord &geometry)
+{
+  TraceSpan span("capture commit");
+  CapturedCommit commit;
+  commit.geometryId = geometry.id;
+  commit.subtype = geometry.subtype;
+  commit.timeCode = static_cast<double>(frameIndex);
+
+  for (auto &[name, array] : geometry.arrays) {
+    auto data = currentData(*array);
+    if (!data || geometry.sent[name] == data)
+      continue;
+    geometry.sent[name] = data;
+
+    CapturedArray captured;
+    captured.name = name;
+    captured.elementType = array->elementType;
+    captured.elementCount = array->elementCount;
+    captured.data = std::move(data);
+    commit.arrays.push_back(std::move(captured));
+  }
+
+  if (commit.arrays.empty())
+    return;
+
+  if (!writer) {
+    if (!traceFile.empty())
+      traceStarted = startTrace(traceFile);
+    writer = std::make_unique<CaptureWriter>(
+        outputFile, options, kMaxQueuedBytes);
+    if (!writer->isValid())
+      reportError("Capture to " + outputFile + " disabled");
+  }
+  if (writer->isValid())
+    writer->push(std::move(commit));
+}
+
+// Data Arrays ////////////////////////////////////////////////////////////////
+
+ANARIArray1D CaptureDevice::newArray1D(const void *appMemory,
+    ANARIMemoryDeleter deleter,
+    const void *userdata,
+    ANARIDataType type,
+    uint64_t numItems1)
+{
+  ANARIDevice device = wrapped();
+  if (!device)
+    return nullptr;
+  ANARIArray1D array = anariNewArray1D(
+      device, appMemory, deleter, userdata, type, numItems1);
+  if (array) {
+    auto record = std::make_shared<ArrayRecord>();
+    record->elementType = type;
+    record->elementCount = numItems1;
+    record->appMemory = appMemory;
+    arrays[array] = std::move(record);
+  }
+  return array;
+}
+
+ANARIArray2D CaptureDevice::newArray2D(const void *appMemory,
+    ANARIMemoryDeleter deleter,
+    const void *userdata,
+    ANARIDataType type,
+    uint64_t numItems1,
+    uint64_t numItems2)
+{
+  ANARIDevice device = wrapped();
+  if (!device)
+    return nullptr;
+  return anariNewArray2D(
+      device, appMemory, deleter, userdata, type, numItems1, numItems2);
+}
+
+ANARIArray3D CaptureDevice::newArray3D(const void *appMemory,
+    ANARIMemoryDeleter deleter,
+    const void *userdata,
+    ANARIDataType type,
+    uint64_t numItems1,
+    uint64_t numItems2,
+    uint64_t numItems3)
+{
+  ANARIDevice device = wrapped();
+  if (!device)
+    return nullptr;
+  return anariNewArray3D(device,
+      appMemory,
+      deleter,
+      userdata,
+      type,
+      numItems1,
+      numItems2,
+      numItems3);
+}
+
+void *CaptureDevice::mapArray(ANARIArray array)
+{
+  ANARIDevice device = wrapped();
+  if (!device)
+    return nullptr;
+  void *mapped = anariMapArray(device, array);
+  auto it = arrays.find(array);
+  if (it != arrays.end())
+    it->second->mapped = mapped;
+  return mapped;
+}
+
+void CaptureDevice::unmapArray(ANARIArray array)
+{
+  ANARIDevice device = wrapped();
+  if (!device)
+    return;
+  // Copy managed data while it is still mapped
+  auto it = arrays.find(array);
+  if (it != arrays.end() && !it->second->appMemory && it->second->mapped) {
+    ArrayRecord &record = *it->second;
+    const auto *begin = static_cast<const uint8_t *>(record.mapped);
+    const size_t bytes = record.elementCount * anari::sizeOf(record.elementType);
+    record.snapshot =
+        std::make_shared<std::vector<uint8_t>>(begin, begin + bytes);
+    record.mapped = nullptr;
+  }
+  anariUnmapArray(device, array);
+}
+
+// Renderable Objects /////////////////////////////////////////////////////////
+
+ANARILight CaptureDevice::newLight(const char *type)
+{
+  ANARIDevice device = wrapped();
+  if (!device)
+    return nullptr;
+  return anariNewLight(device, type);
+}
+
+ANARICamera CaptureDevice::newCamera(const char *type)
+{
+  ANARIDevice device = wrapped();
+  if (!device)
+    return nullptr;
+  return anariNewCamera(device, type);
+}
+
+ANARIGeometry CaptureDevice::newGeometry(const char *type)
+{
+  ANARIDevice device = wrapped();
+  if (!device)
+    return nullptr;
+  ANARIGeometry geometry = anariNewGeometry(device, type);
+  if (geometry) {
+    GeometryRecord &record = geometries[geometry];
+    record = GeometryRecord();
+    record.id = nextGeometryId++;
+    record.subtype = type;
+  }
+  return geometry;
+}
+
+ANARISpatialField CaptureDevice::newSpatialField(const char *type)
+{
+  ANARIDevice device = wrapped();
+  if (!device)
+    return nullptr;
+  return anariNewSpatialField(device, type);
+}
+
+ANARISurface CaptureDevice::newSurface()
+{
+  ANARIDevice device = wrapped();
+  if (!device)
+    return nullptr;
+  return anariNewSurface(device);
+}
+
+ANARIVolume CaptureDevice::newVolume(const char *type)
+{
+  ANARIDevice device = wrapped();
+  if (!device)
+    return nullptr;
+  return anariNewVolume(device, type);
+}
+
+// Surface Meta-Data //////////////////////////////////////////////////////////
+
+ANARIMaterial CaptureDevice::newMaterial(const char *material_type)
+{
+  ANARIDevice device = wrapped();
+  if (!device)
+    return nullptr;
+  return anariNewMaterial(device, material_type);
+}
+
+ANARISampler CaptureDevice::newSampler(const char *type)
+{
+  ANARIDevice device = wrapped();
+  if (!device)
+    return nullptr;
+  return anariNewSampler(device, type);
+}
+
+// Instancing /////////////////////////////////////////////////////////////////
+
+ANARIGroup CaptureDevice::newGroup()
+{
+  ANARIDevice device = wrapped();
+  if (!device)
+    return nullptr;
+  return anariNewGroup(device);
+}
+
+ANARIInstance CaptureDevice::newInstance(const char *type)
+{
+  ANARIDevice device = wrapped();
+  if (!device)
+    return nullptr;
+  return anariNewInstance(device, type);
+}
+
+// Top-level Worlds ///////////////////////////////////////////////////////////
+
+ANARIWorld CaptureDevice::newWorld()
+{
+  ANARIDevice device = wrapped();
+  if (!device)
+    return nullptr;
+  return anariNewWorld(device);
+}
+
+// Query functions ////////////////////////////////////////////////////////////
+
+const char **CaptureDevice::getObjectSubtypes(ANARIDataType objectType)
+{
+  ANARIDevice device = wrapped();
+  if (!device)
+    return nullptr;
+  return anariGetObjectSubtypes(device, objectType);
+}
+
+const void *CaptureDevice::getObjectInfo(ANARIDataType objectType,
+    const char *objectSubtype,
+    const char *infoName,
+    ANARIDataType infoType)
+{
+  ANARIDevice device = wrapped();
+  if (!device)
+    return nullptr;
+  return anariGetObjectInfo(
+      device, objectType, objectSubtype, infoName, infoType);
+}
+
+const void *CaptureDevice::getParameterInfo(ANARIDataType objectType,
+    const char *objectSubtype,
+    const char *parameterName,
+    ANARIDataType parameterType,
+    const char *infoName,
+    ANARIDataType infoType)
+{
+  ANARIDevice device = wrapped();
+  if (!device)
+    return nullptr;
+  return anariGetParameterInfo(device,
+      objectType,
+      objectSubtype,
+      parameterName,
+      parameterType,
+      infoName,
+      infoType);
+}
+
+// Object + Parameter Lifetime Management /////////////////////////////////////
+
+int CaptureDevice::getProperty(ANARIObject object,
+    const char *name,
+    ANARIDataType type,
+    void *mem,
+    uint64_t size,
+    ANARIWaitMask mask)
+{
+  ANARIDevice device = wrapped();
+  if (!device)
+    return 0;
+  return anariGetProperty(
+      device, forwarded(object), name, type, mem, size, mask);
+}
+
+void CaptureDevice::setParameter(
+    ANARIObject object, const char *name, ANARIDataType type, const void *mem)
+{
+  if (object == this_device()) {
+    setDeviceParameter(name, type, mem);
+    return;
+  }
+  ANARIDevice device = wrapped();
+  if (!device)
+    return;
+
+  auto geometry = geometries.find(object);
+  if (geometry != geometries.end()) {
+    auto &params = geometry->second.arrays;
+    params.erase(name);
+    if (type == ANARI_ARRAY1D || type == ANARI_ARRAY) {
+      auto array = arrays.find(*static_cast<const ANARIArray *>(mem));
+      if (array != arrays.end())
+        params[name] = array->second;
+    }
+  }
+
+  anariSetParameter(device, object, name, type, mem);
+}
+
+void CaptureDevice::unsetParameter(ANARIObject object, const char *name)
+{
+  ANARIDevice device = wrapped();
+  if (!device)
+    return;
+  auto geometry = geometries.find(object);
+  if (geometry != geometries.end())
+    geometry->second.arrays.erase(name);
+  anariUnsetParameter(device, forwarded(object), name);
+}
+
+void CaptureDevice::unsetAllParameters(ANARIObject object)
+{
+  ANARIDevice device = wrapped();
+  if (!device)
+    return;
+  auto geometry = geometries.find(object);
+  if (geometry != geometries.end())
+    geometry->second.arrays.clear();
+  anariUnsetAllParameters(device, forwarded(object));
+}
+
+void *CaptureDevice::mapParameterArray1D(ANARIObject object,
+    const char *name,
+    ANARIDataType dataType,
+    uint64_t numElements1,
+    uint64_t *elementStride)
+{
+  ANARIDevice device = wrapped();
+  if (!device)
+    return nullptr;
+  void *mapped = anariMapParameterArray1D(
+      device, object, name, dataType, numElements1, elementStride);
+
+  // Treated as a managed array that is copied on unmap
+  auto geometry = geometries.find(object);
+  if (geometry != geometries.end() && mapped) {
+    auto record = std::make_shared<ArrayRecord>();
+    record->elementType = dataType;
+    record->elementCount = numElements1;
+    record->mapped = mapped;
+    geometry->second.mappedParameters[name] = std::move(record);
+  }
+  return mapped;
+}
+
+void *CaptureDevice::mapParameterArray2D(ANARIObject object,
+    const char *name,
+    ANARIDataType dataType,
+    uint64_t numElements1,
+    uint64_t numElements2,
+    uint64_t *elementStride)
+{
+  ANARIDevice device = wrapped();
+  if (!device)
+    return nullptr;
+  return anariMapParameterArray2D(device,
+      object,
+      name,
+      dataType,
+      numElements1,
+      numElements2,
+      elementStride);
+}
+
+void *CaptureDevice::mapParameterArray3D(ANARIObject object,
+    const char *name,
+    ANARIDataType dataType,
+    uint64_t numElements1,
+    uint64_t numElements2,
+    uint64_t numElements3,
+    uint64_t *elementStride)
+{
+  ANARIDevice device = wrapped();
+  if (!device)
+    return nullptr;
+  return anariMapParameterArray3D(device,
+      object,
+      name,
+      dataType,
+      numElements1,
+      numElements2,
+      numElements3,
+      elementStride);
+}
+
+void CaptureDevice::unmapParameterArray(ANARIObject object, const char *name)
+{
+  ANARIDevice device = wrapped();
+  if (!device)
+    return;
+  auto geometry = geometries.find(object);
+  if (geometry != geometries.end()) {
+    auto &pending = geometry->second.mappedParameters;
+    auto it = pending.find(name);
+    if (it != pending.end()) {
+      auto record = std::move(it->second);
+      pending.erase(it);
+      const auto *begin = static_cast<const uint8_t *>(record->mapped);
+      const size_t bytes =
+          record->elementCount * anari::sizeOf(record->elementType);
+      record->snapshot =
+          std::make_shared<std::vector<uint8_t>>(begin, begin + bytes);
+      record->mapped = nullptr;
+      geometry->second.arrays[name] = std::move(record);
+    }
+  }
+  anariUnmapParameterArray(device, object, name);
+}
+
+void CaptureDevice::commitParameters(ANARIObject object)
+{
+  ANARIDevice device = wrapped();
+  if (!device)
+    return;
+  if (object == this_device()) {
+    anariCommitParameters(device, device);
+    return;
+  }
+
+  auto geometry = geometries.find(object);
+  if (geometry != geometries.end())
+    captureGeometry(geometry->second);
+
+  anariCommitParameters(device, object);
+}
+
+void CaptureDevice::release(ANARIObject object)
+{
+  if (!object)
+    return;
+
+  if (object == this_device()) {
+    if (--refCount == 0)
+      delete this;
+    return;
+  }
+
+  auto array = arrays.find(object);
+  if (array != arrays.end() && --array->second->refCount == 0)
+    arrays.erase(array);
+  auto geometry = geometries.find(object);
+  if (geometry != geometries.end() && --geometry->second.refCount == 0)
+    geometries.erase(geometry);
+
+  if (ANARIDevice device = wrapped())
+    anariRelease(device, object);
+}
+
+void CaptureDevice::retain(ANARIObject object)
+{
+  if (!object)
+    return;
+
+  if (object == this_device()) {
+    ++refCount;
+    return;
+  }
+
+  auto array = arrays.find(object);
+  if (array != arrays.end())
+    ++array->second->refCount;
+  auto geometry = geometries.find(object);
+  if (geometry != geometries.end())
+    ++geometry->second.refCount;
+
+  if (ANARIDevice device = wrapped())
+    anariRetain(device, object);
+}
+
+// FrameBuffer Manipulation ///////////////////////////////////////////////////
+
+ANARIFrame CaptureDevice::newFrame()
+{
+  ANARIDevice device = wrapped();
+  if (!device)
+    return nullptr;
+  return anariNewFrame(device);
+}
+
+const void *CaptureDevice::frameBufferMap(ANARIFrame fb,
+    const char *channel,
+    uint32_t *width,
+    uint32_t *height,
+    ANARIDataType *pixelType)
+{
+  ANARIDevice device = wrapped();
+  if (!device)
+    return nullptr;
+  return anariMapFrame(device, fb, channel, width, height, pixelType);
+}
+
+void CaptureDevice::frameBufferUnmap(ANARIFrame fb, const char *channel)
+{
+  ANARIDevice device = wrapped();
+  if (!device)
+    return;
+  anariUnmapFrame(device, fb, channel);
+}
+
+// Frame Rendering ////////////////////////////////////////////////////////////
+
+ANARIRenderer CaptureDevice::newRenderer(const char *type)
+{
+  ANARIDevice device = wrapped();
+  if (!device)
+    return nullptr;
+  return anariNewRenderer(device, type);
+}
+
+// Geometry committed after this frame belongs to the next time code
+void CaptureDevice::renderFrame(ANARIFrame frame)
+{
+  ANARIDevice device = wrapped();
+  if (!device)
+    return;
+  anariRenderFrame(device, frame);
+  ++frameIndex;
+}
+
+int CaptureDevice::frameReady(ANARIFrame frame, ANARIWaitMask mask)
+{
+  ANARIDevice device = wrapped();
+  if (!device)
+    return 0;
+  return anariFrameReady(device, frame, mask);
+}
+
+void CaptureDevice::discardFrame(ANARIFrame frame)
+{
+  ANARIDevice device = wrapped();
+  if (!device)
+    return;
+  anariDiscardFrame(device, frame);
+}
+
+} // namespace agx2usd
@@ -0,0 +1,202 @@
+// Copyright 2025
+// SPDX-License-Identifier: Apache-2.0
+
+// ANARI pass-through device that records geometry to USD
+//
+// Every call is forwarded to a wrapped device, which does the actual
+// rendering; object handles are the wrapped device's own. Array parameters
+// of committed geometries are copied and handed to a CaptureWriter, which
+// authors them as USD time samples on a background thread. The time code is
+// the number of frames rendered so far.
+
+#pragma once
+
+#include "capture_writer.h"
+
+// ANARI
+#include <anari/backend/DeviceImpl.h>
+
+// std
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace agx2usd {
+
+class CaptureDevice : public anari::DeviceImpl
+{
+ public:
+  CaptureDevice(ANARILibrary library);
+  ~CaptureDevice() override;
+
+  // Data Arrays //////////////////////////////////////////////////////////////
+
+  ANARIArray1D newArray1D(const void *appMemory,
+      ANARIMemoryDeleter deleter,
+      const void *userdata,
+      ANARIDataType type,
+      uint64_t numItems1) override;
+  ANARIArray2D newArray2D(const void *appMemory,
+      ANARIMemoryDeleter deleter,
+      const void *userdata,
+      ANARIDataType type,
+      uint64_t numItems1,
+      uint64_t numItems2) override;
+  ANARIArray3D newArray3D(const void *appMemory,
+      ANARIMemoryDeleter deleter,
+      const void *userdata,
+      ANARIDataType type,
+      uint64_t numItems1,
+      uint64_t numItems2,
+      uint64_t numItems3) override;
+  void *mapArray(ANARIArray array) override;
+  void unmapArray(ANARIArray array) override;
+
+  // Renderable Objects ///////////////////////////////////////////////////////
+
+  ANARILight newLight(const char *type) override;
+  ANARICamera newCamera(const char *type) override;
+  ANARIGeometry newGeometry(const char *type) override;
+  ANARISpatialField newSpatialField(const char *type) override;
+  ANARISurface newSurface() override;
+  ANARIVolume newVolume(const char *type) override;
+
+  // Surface Meta-Data ////////////////////////////////////////////////////////
+
+  ANARIMaterial newMaterial(const char *material_type) override;
+  ANARISampler newSampler(const char *type) override;
+
+  // Instancing ///////////////////////////////////////////////////////////////
+
+  ANARIGroup newGroup() override;
+  ANARIInstance newInstance(const char *type) override;
+
+  // Top-level Worlds /////////////////////////////////////////////////////////
+
+  ANARIWorld newWorld() override;
+
+  // Query functions //////////////////////////////////////////////////////////
+
+  const char **getObjectSubtypes(ANARIDataType objectType) override;
+  const void *getObjectInfo(ANARIDataType objectType,
+      const char *objectSubtype,
+      const char *infoName,
+      ANARIDataType infoType) override;
+  const void *getParameterInfo(ANARIDataType objectType,
+      const char *objectSubtype,
+      const char *parameterName,
+      ANARIDataType parameterType,
+      const char *infoName,
+      ANARIDataType infoType) override;
+
+  // Object + Parameter Lifetime Management ///////////////////////////////////
+
+  int getProperty(ANARIObject object,
+      const char *name,
+      ANARIDataType type,
+      void *mem,
+      uint64_t size,
+      ANARIWaitMask mask) override;
+  void setParameter(ANARIObject object,
+      const char *name,
+      ANARIDataType type,
+      const void *mem) override;
+  void unsetParameter(ANARIObject object, const char *name) override;
+  void unsetAllParameters(ANARIObject object) override;
+  void *mapParameterArray1D(ANARIObject object,
+      const char *name,
+      ANARIDataType dataType,
+      uint64_t numElements1,
+      uint64_t *elementStride) override;
+  void *mapParameterArray2D(ANARIObject object,
+      const char *name,
+      ANARIDataType dataType,
+      uint64_t numElements1,
+      uint64_t numElements2,
+      uint64_t *elementStride) override;
+  void *mapParameterArray3D(ANARIObject object,
+      const char *name,
+      ANARIDataType dataType,
+      uint64_t numElements1,
+      uint64_t numElements2,
+      uint64_t numElements3,
+      uint64_t *elementStride) override;
+  void unmapParameterArray(ANARIObject object, const char *name) override;
+  void commitParameters(ANARIObject object) override;
+  void release(ANARIObject object) override;
+  void retain(ANARIObject object) override;
+
+  // FrameBuffer Manipulation /////////////////////////////////////////////////
+
+  ANARIFrame newFrame() override;
+  const void *frameBufferMap(ANARIFrame fb,
+      const char *channel,
+      uint32_t *width,
+      uint32_t *height,
+      ANARIDataType *pixelType) override;
+  void frameBufferUnmap(ANARIFrame fb, const char *channel) override;
+
+  // Frame Rendering //////////////////////////////////////////////////////////
+
+  ANARIRenderer newRenderer(const char *type) override;
+  void renderFrame(ANARIFrame frame) override;
+  int frameReady(ANARIFrame frame, ANARIWaitMask mask) override;
+  void discardFrame(ANARIFrame frame) override;
+
+ private:
+  // A 1D array created through this device. Shared arrays are read from the
+  // application memory at commit time, managed arrays are copied on unmap.
+  struct ArrayRecord
+  {
+    ANARIDataType elementType = ANARI_UNKNOWN;
+    uint64_t elementCount = 0;
+    const void *appMemory = nullptr;
+    void *mapped = nullptr;
+    std::shared_ptr<const std::vector<uint8_t>> snapshot;
+    int refCount = 1;
+  };
+
+  // Array parameters of a geometry and the data last sent for each of them
+  struct GeometryRecord
+  {
+    uint64_t id = 0;
+    std::string subtype;
+    std::map<std::string, std::shared_ptr<ArrayRecord>> arrays;
+    std::map<std::string, std::shared_ptr<const std::vector<uint8_t>>> sent;
+    std::map<std::string, std::shared_ptr<ArrayRecord>> mappedParameters;
+    int refCount = 1;
+  };
+
+  void reportError(const std::string &message);
+  ANARIDevice wrapped();
+  ANARIObject forwarded(ANARIObject object);
+  void setDeviceParameter(const char *name, ANARIDataType type, const void *mem);
+  void captureGeometry(GeometryRecord &geometry);
+  static std::shared_ptr<const std::vector<uint8_t>> currentData(
+      ArrayRecord &array);
+
+  // Commits queued for the writer beyond this many bytes of array data wait
+  // for it, so a slow writer slows the application down instead of
+  // buffering without bound
+  static constexpr uint64_t kMaxQueuedBytes = 256 << 20;
+
+  ANARIDevice wrappedDevice = nullptr;
+  ANARILibrary wrappedLibrary = nullptr;
+  bool wrappedFailed = false;
+  std::string outputFile = "capture.usdc";
+  std::string traceFile;
+  bool traceStarted = false;
+  ConvertOptions options;
+  std::unique_ptr<CaptureWriter> writer;
+
+  // Keyed by the base handle type, since the device API passes ANARIObject
+  std::unordered_map<ANARIObject, std::shared_ptr<ArrayRecord>> arrays;
+  std::unordered_map<ANARIObject, GeometryRecord> geometries;
+  uint64_t nextGeometryId = 0;
+  uint64_t frameIndex = 0;
+  int refCount = 1;
+};
+
+} // namespace agx2usd
@@ -0,0 +1,45 @@
+// Copyright 2025
+// SPDX-License-Identifier: Apache-2.0
+
+#include "capture_device.h"
+
+// ANARI
+#include <anari/backend/LibraryImpl.h>
+
+namespace agx2usd {
+
+struct CaptureLibrary : public anari::LibraryImpl
+{
+  CaptureLibrary(
+      void *lib, ANARIStatusCallback defaultStatusCB, const void *statusCBPtr);
+
+  ANARIDevice newDevice(const char *subtype) override;
+  const char **getDeviceExtensions(const char *deviceType) override;
+};
+
+CaptureLibrary::CaptureLibrary(
+    void *lib, ANARIStatusCallback defaultStatusCB, const void *statusCBPtr)
+    : anari::LibraryImpl(lib, defaultStatusCB, statusCBPtr)
+{
+}
+
+ANARIDevice CaptureLibrary::newDevice(const char * /*subtype*/)
+{
+  return (ANARIDevice) new CaptureDevice(this_library());
+}
+
+// Extensions are those of the wrapped device, which is not known until the
+// device is created
+const char **CaptureLibrary::getDeviceExtensions(const char * /*deviceType*/)
+{
+  return nullptr;
+}
+
+} // namespace agx2usd
+
+// Loaded with anariLoadLibrary("usdcapture", ...)
+extern "C" ANARI_DEFINE_LIBRARY_ENTRYPOINT(
+    usdcapture, handle, scb, scbPtr)
+{
+  return (ANARILibrary) new agx2usd::CaptureLibrary(handle, scb, scbPtr);
+}
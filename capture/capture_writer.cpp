@@ -0,0 +1,142 @@
+// Copyright 2025
+// SPDX-License-Identifier: Apache-2.0
+
+#include "capture_writer.h"
+#include "log.h"
+#include "trace.h"
+
+// std
+#include <algorithm>
+#include <iostream>
+
+namespace agx2usd {
+
+namespace {
+
+uint64_t arrayBytes(const CapturedCommit &commit)
+{
+  uint64_t bytes = 0;
+  for (const auto &array : commit.arrays)
+    bytes += array.data->size();
+  return bytes;
+}
+
+} // namespace
+
+CaptureWriter::CaptureWriter(const std::string &outputPath,
+    const ConvertOptions &options,
+    uint64_t maxQueuedBytes)
+    : outputPath(outputPath), options(options), maxQueuedBytes(maxQueuedBytes)
+{
+  stage = UsdStage::CreateNew(outputPath);
+  if (!stage) {
+    std::cerr << "Error: Failed to create USD stage " << outputPath << "\n";
+    return;
+  }
+  setupStage(stage, 0.0);
+
+  // The stage is only touched by the writer thread from here on
+  thread = std::thread([this]() { run(); });
+}
+
+CaptureWriter::~CaptureWriter()
+{
+  if (!thread.joinable())
+    return;
+
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    done = true;
+  }
+  condition.notify_one();
+  thread.join();
+
+  for (auto &mesh : geometries)
+    mesh.second->finish();
+  stage->SetEndTimeCode(endTime);
+  logInfo("Saving USD capture to: {}", outputPath);
+  TraceSpan span("save", outputPath);
+  if (!stage->GetRootLayer()->Save())
+    std::cerr << "Error: Failed to save " << outputPath << "\n";
+}
+
+bool CaptureWriter::isValid() const
+{
+  return bool(stage);
+}
+
+void CaptureWriter::push(CapturedCommit commit)
+{
+  const uint64_t bytes = arrayBytes(commit);
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+    auto hasRoom = [&]() {
+      return queue.empty() || queuedBytes + bytes <= maxQueuedBytes;
+    };
+    if (!hasRoom()) {
+      TraceSpan span("capture wait");
+      dequeued.wait(lock, hasRoom);
+    }
+    queuedBytes += bytes;
+    queue.push_back(std::move(commit));
+  }
+  condition.notify_one();
+}
+
+void CaptureWriter::run()
+{
+  std::unique_lock<std::mutex> lock(mutex);
+  while (true) {
+    condition.wait(lock, [this]() { return done || !queue.empty(); });
+    if (queue.empty())
+      break;
+
+    CapturedCommit commit = std::move(queue.front());
+    queue.pop_front();
+    queuedBytes -= arrayBytes(commit);
+    dequeued.notify_one();
+
+    // Author without holding the lock so the render thread never waits on USD
+    lock.unlock();
+    write(commit);
+    lock.lock();
+  }
+}
+
+void CaptureWriter::write(const CapturedCommit &commit)
+{
+  // Triangle geometries, and spheres with sortPoints, map onto the AGX
+  // geometry writers
+  if (commit.subtype != "triangle"
+      && !isPointsGeometry(commit.subtype, options))
+    return;
+
+  auto &writer = geometries[commit.geometryId];
+  if (!writer) {
+    SdfPath path("/Geometry/geom_" + std::to_string(commit.geometryId));
+    writer = makeGeometryWriter(commit.subtype, stage, path, options);
+  }
+
+  TraceSpan span("write commit", std::to_string(commit.geometryId));
+
+  // Present the captured arrays as AGX parameter views, so the capture is
+  // converted by exactly the same code as a recorded AGX file
+  writer->beginTimeStep(commit.timeCode);
+  for (const auto &array : commit.arrays) {
+    AGXParamView pv{};
+    pv.name = array.name.c_str();
+    pv.nameLength = static_cast<uint32_t>(array.name.size());
+    pv.type = ANARI_ARRAY1D;
+    pv.isArray = 1;
+    pv.elementType = array.elementType;
+    pv.elementCount = array.elementCount;
+    pv.data = array.data->data();
+    pv.dataBytes = array.data->size();
+    writer->setTimeStepParam(pv);
+  }
+  writer->endTimeStep();
+
+  endTime = std::max(endTime, commit.timeCode);
+}
+
+} // namespace agx2usd
@@ -0,0 +1,86 @@
+// Copyright 2025
+// SPDX-License-Identifier: Apache-2.0
+
+// Authors geometry captured from an ANARI application to USD on a
+// background thread
+
+#pragma once
+
+#include "geometry_writer.h"
+
+// std
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace agx2usd {
+
+// A copy of one array parameter of a geometry, taken at commit time. The
+// bytes are shared so an unchanged array is not copied again per frame.
+struct CapturedArray
+{
+  std::string name;
+  ANARIDataType elementType = ANARI_UNKNOWN;
+  uint64_t elementCount = 0;
+  std::shared_ptr<const std::vector<uint8_t>> data;
+};
+
+// The array parameters of a geometry that changed with one commit
+struct CapturedCommit
+{
+  uint64_t geometryId = 0;
+  std::string subtype;
+  double timeCode = 0.0;
+  std::vector<CapturedArray> arrays;
+};
+
+// Queue of captured commits drained by a writer thread. Each geometry is
+// written by its own GeometryWriter to /Geometry/geom_<id>, so the resulting
+// stage has the same layout as a converted AGX file. The stage is saved when
+// the writer is destroyed.
+//
+// The queue holds at most 'maxQueuedBytes' of array data: push() blocks
+// while the commits waiting for the writer thread exceed it. A single
+// larger commit is still accepted once the queue is empty.
+class CaptureWriter
+{
+ public:
+  CaptureWriter(const std::string &outputPath,
+      const ConvertOptions &options,
+      uint64_t maxQueuedBytes);
+  ~CaptureWriter();
+
+  CaptureWriter(const CaptureWriter &) = delete;
+  CaptureWriter &operator=(const CaptureWriter &) = delete;
+
+  bool isValid() const;
+  void push(CapturedCommit commit);
+
+ private:
+  void run();
+  void write(const CapturedCommit &commit);
+
+  std::string outputPath;
+  ConvertOptions options;
+  UsdStageRefPtr stage;
+  std::map<uint64_t, std::unique_ptr<GeometryWriter>> geometries;
+  double endTime = 0.0;
+
+  std::mutex mutex;
+  std::condition_variable condition;
+  // Signalled by the writer thread whenever it takes a commit off the queue
+  std::condition_variable dequeued;
+  std::deque<CapturedCommit> queue;
+  uint64_t queuedBytes = 0;
+  uint64_t maxQueuedBytes;
+  bool done = false;
+  std::thread thread;
+};
+
+} // namespace agx2usd
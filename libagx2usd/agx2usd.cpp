@@ -0,0 +1,324 @@
+// Copyright 2025
+// SPDX-License-Identifier: Apache-2.0
+
+// AGX to USD Converter - Converts animated geometry from AGX format to USD
+
+// AGX (the reader implementation is compiled into this translation unit)
+#define AGX_READ_IMPL
+#include "agx/agx_read.h"
+
+#include "agx2usd.h"
+#include "checksum.h"
+#include "geometry_writer.h"
+#include "input.h"
+#include "log.h"
+#include "memory.h"
+#include "page_cache.h"
+#include "param_filter.h"
+#include "perf_counters.h"
+#include "trace.h"
+#include "usdz.h"
+
+// std
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstdio>
+#include <cstring>
+
+PXR_NAMESPACE_USING_DIRECTIVE
+
+namespace agx2usd {
+
+namespace {
+
+// Convert AGX mesh data to USD mesh
+bool convertToUSDMesh(AGXReader reader,
+    const UsdStageRefPtr &stage,
+    const ConvertOptions &options,
+    SceneMemoryLimit *sceneMemory)
+{
+  PerfCounters perf;
+  InputProgress *progress = getInputProgress(reader);
+  ChecksumTable *checksums = progress ? progress->checksums.get() : nullptr;
+  const ParamFilter filter(options.includeParams, options.excludeParams);
+  uint64_t skippedBytes = 0;
+
+  // Read header
+  AGXHeader hdr{};
+  int headerResult = 0;
+  {
+    TraceSpan span("read header");
+    PerfScope perfScope(perf, PerfPhase::Read, sizeof(hdr));
+    headerResult = agxReaderGetHeader(reader, &hdr);
+  }
+  if (headerResult != 0) {
+    std::cerr << "Error: Failed to read AGX header\n";
+    return false;
+  }
+
+  logInfo("AGX File Info:");
+  logInfo("  Version: {}", hdr.version);
+  logInfo("  Time Steps: {}", hdr.timeSteps);
+  logInfo("  Constants: {}", hdr.constantParamCount);
+  logInfo("  Object Type: {}", anari::toString(hdr.objectType));
+
+  const char *subtype = agxReaderGetSubtype(reader);
+  if (subtype && strlen(subtype) > 0) {
+    logInfo("  Subtype: {}", subtype);
+  }
+
+  // The objects of a scene share one limit, each tracks only its own report
+  MemoryTracker memory(sceneMemory ? 0 : options.maxMemoryBytes,
+      hdr.timeSteps,
+      isLogEnabled(LogLevel::Info));
+  if (sceneMemory)
+    sceneMemory->addTimeSteps(hdr.timeSteps);
+
+  auto endTime = static_cast<double>(hdr.timeSteps > 0 ? hdr.timeSteps - 1 : 0);
+  setupStage(stage, endTime);
+
+  // Create mesh or points
+  const std::string_view geometrySubtype = subtype ? subtype : "";
+  auto writerPtr = makeGeometryWriter(geometrySubtype,
+      stage,
+      SdfPath(isPointsGeometry(geometrySubtype, options) ? "/Geometry/points"
+                                                         : "/Geometry/mesh"),
+      options);
+  GeometryWriter &writer = *writerPtr;
+
+  // Read constant parameters
+  logInfo("\nReading constant parameters...");
+  agxReaderResetConstants(reader);
+  AGXParamView pv{};
+  
+  if (checksums)
+    checksums->beginSection();
+  
+  while (true) {
+    int rc = 0;
+    {
+      TraceSpan span("read constant");
+      PerfScope perfScope(perf, PerfPhase::Read);
+      rc = agxReaderNextConstant(reader, &pv);
+      if (rc == 1) {
+        perfScope.addBytes(pv.dataBytes);
+        if (progress)
+          progress->advance(pv.nameLength + pv.dataBytes);
+        if (checksums)
+          checksums->add(pv);
+      }
+    }
+    if (rc < 0) {
+      std::cerr << "Error reading constant parameters\n";
+      return false;
+    }
+    if (rc == 0)
+      break;
+    if (!filter.accepts(std::string_view(pv.name, pv.nameLength))) {
+      logTrace("  -> Skipped {}", std::string_view(pv.name, pv.nameLength));
+      skippedBytes += pv.dataBytes;
+      continue;
+    }
+
+    TraceSpan span("convert constant", std::string_view(pv.name, pv.nameLength));
+    PerfScope perfScope(perf, PerfPhase::Convert, pv.dataBytes);
+    writer.setConstant(pv);
+  }
+  if (checksums && !checksums->endSection())
+    return false;
+
+  // Process time steps
+  logInfo("\nProcessing time steps...");
+  agxReaderResetTimeSteps(reader);
+  
+  uint32_t stepIndex = 0;
+  uint32_t paramCount = 0;
+  
+  while (true) {
+    int rc = 0;
+    {
+      TraceSpan span("read timestep header");
+      PerfScope perfScope(perf, PerfPhase::Read);
+      rc = agxReaderBeginNextTimeStep(reader, &stepIndex, &paramCount);
+    }
+    if (rc != 1)
+      break;
+
+    TraceSpan stepSpan("timestep", std::to_string(stepIndex));
+    logDebug("Time step {} ({} parameters)", stepIndex, paramCount);
+    writer.beginTimeStep(static_cast<double>(stepIndex));
+    if (checksums)
+      checksums->beginSection();
+    
+    // Read and convert parameters for this timestep
+    uint64_t stepBytes = 0;
+    while (true) {
+      {
+        TraceSpan span("read");
+        PerfScope perfScope(perf, PerfPhase::Read);
+        rc = agxReaderNextTimeStepParam(reader, &pv);
+        if (rc == 1) {
+          perfScope.addBytes(pv.dataBytes);
+          if (progress)
+            progress->advance(pv.nameLength + pv.dataBytes);
+          if (checksums)
+            checksums->add(pv);
+        }
+      }
+      if (rc < 0) {
+        std::cerr << "Error reading timestep parameters\n";
+        return false;
+      }
+      if (rc == 0)
+        break;
+      if (!filter.accepts(std::string_view(pv.name, pv.nameLength))) {
+        logTrace("  -> Skipped {}", std::string_view(pv.name, pv.nameLength));
+        skippedBytes += pv.dataBytes;
+        continue;
+      }
+
+      TraceSpan span("convert", std::string_view(pv.name, pv.nameLength));
+      PerfScope perfScope(perf, PerfPhase::Convert, pv.dataBytes);
+      writer.setTimeStepParam(pv);
+      stepBytes += pv.dataBytes;
+    }
+    // Checked before authoring, so corrupt data never reaches the stage
+    if (checksums && !checksums->endSection())
+      return false;
+
+    // Encode and author the converted values
+    {
+      TraceSpan span("author");
+      PerfScope perfScope(perf, PerfPhase::Author, stepBytes);
+      writer.endTimeStep();
+    }
+
+    // Account memory at the timestep boundary, and stop before running out
+    if ((memory.isActive()
+            && !memory.sample(
+                stepBytes, writer.getBufferBytes(), writer.getLayerBytes()))
+        || (sceneMemory && !sceneMemory->sample())) {
+      std::cerr << "Error: Stopped at time step " << stepIndex
+                << " by the memory limit\n";
+      return false;
+    }
+  }
+
+  // Also catches files that end early, which the reader takes as the end
+  if (checksums && !checksums->finish())
+    return false;
+
+  {
+    TraceSpan span("finish");
+    PerfScope perfScope(perf, PerfPhase::Author);
+    writer.finish();
+  }
+  if (skippedBytes > 0) {
+    logInfo("Skipped {} of parameters excluded by the parameter filters",
+        formatBytes(skippedBytes));
+  }
+  memory.setLayerBytes(writer.getLayerBytes());
+  if (isLogEnabled(LogLevel::Info)) {
+    std::ostringstream report;
+    perf.report(report);
+    memory.report(report);
+    std::string text = report.str();
+    text.pop_back(); // the log adds the final newline
+    logInfo("{}", text);
+  }
+
+  return true;
+}
+
+} // namespace
+
+bool convert(AGXReader reader,
+    const UsdStageRefPtr &stage,
+    const ConvertOptions &options)
+{
+  if (!reader || !stage) {
+    std::cerr << "Error: Invalid AGX reader or USD stage\n";
+    return false;
+  }
+  return convertToUSDMesh(reader, stage, options, nullptr);
+}
+
+SdfLayerRefPtr convertToLayer(AGXReader reader, const ConvertOptions &options)
+{
+  auto layer = SdfLayer::CreateAnonymous("agx2usd.usdc");
+  auto stage = UsdStage::Open(layer);
+  if (!stage || !convert(reader, stage, options))
+    return SdfLayerRefPtr();
+  return layer;
+}
+
+bool convertToFile(AGXReader reader,
+    const std::string &outputPath,
+    const ConvertOptions &options)
+{
+  return convertToFile(reader, outputPath, options, nullptr);
+}
+
+bool convertToFile(AGXReader reader,
+    const std::string &outputPath,
+    const ConvertOptions &options,
+    SceneMemoryLimit *sceneMemory)
+{
+  if (!reader) {
+    std::cerr << "Error: Invalid AGX reader\n";
+    return false;
+  }
+  // A .usdz output is authored as a crate next to it and packaged on save
+  const bool usdz = outputPath.size() > 5
+      && outputPath.compare(outputPath.size() - 5, 5, ".usdz") == 0;
+  const std::string layerPath =
+      usdz ? outputPath + ".partial.usdc" : outputPath;
+
+  // The intermediate crate of a .usdz is not left behind on errors
+  auto fail = [&]() {
+    if (usdz)
+      std::remove(layerPath.c_str());
+    return false;
+  };
+
+  // Create USD stage (binary format with .usdc extension)
+  auto stage = UsdStage::CreateNew(layerPath);
+  if (!stage) {
+    std::cerr << "Error: Failed to create USD stage\n";
+    return fail();
+  }
+
+  if (!convertToUSDMesh(reader, stage, options, sceneMemory))
+    return fail();
+
+  // Save the stage
+  logInfo("\nSaving USD file to: {}", outputPath);
+  {
+    TraceSpan span("save", layerPath);
+    if (!stage->GetRootLayer()->Save()) {
+      std::cerr << "Error: Failed to save " << layerPath << "\n";
+      return fail();
+    }
+  }
+  if (usdz) {
+    TraceSpan span("package usdz", outputPath);
+    if (!writeUsdzPackage(layerPath, outputPath, options.bypassPageCache))
+      return fail();
+  } else if (options.bypassPageCache) {
+    // USD writes the crate through its own file handles, so it can only be
+    // dropped once it is saved
+    dropFromPageCache(outputPath);
+  }
+  
+  logInfo("Conversion complete!");
+  logInfo("Time range: {} to {}",
+      stage->GetStartTimeCode(),
+      stage->GetEndTimeCode());
+  
+  return true;
+}
+
+} // namespace agx2usd
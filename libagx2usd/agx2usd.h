@@ -0,0 +1,110 @@
+// Copyright 2025
+// SPDX-License-Identifier: Apache-2.0
+
+// libagx2usd - converts animated geometry from AGX format to USD
+//
+// The conversion can target a caller-provided stage or an in-memory layer,
+// so it can be used in-process without writing and reloading files.
+
+#pragma once
+
+// AGX
+#include "agx/agx_read.h"
+
+// USD
+#include <pxr/pxr.h>
+#include <pxr/usd/sdf/layer.h>
+#include <pxr/usd/usd/stage.h>
+
+// std
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace agx2usd {
+
+// Options controlling how geometry is written to USD
+struct ConvertOptions
+{
+  // Store positions as per-frame bounds plus 16-bit normalized integers
+  bool quantizePositions = false;
+  // Snap positions to a grid with this spacing before writing (0 = off)
+  float positionPrecision = 0.f;
+  // Write positions and normals as keyframes every N samples plus quantized
+  // deltas in between (0 = off)
+  uint32_t deltaKeyInterval = 0;
+  // Quantization step of the deltas
+  float deltaPrecision = 1e-5f;
+  // Store normals octahedrally encoded with 16 or 8 bits per coordinate in
+  // primvars:agx:octNormals (0 = float normals)
+  uint32_t octNormalBits = 0;
+  // Reorder triangles for the vertex cache and vertices for fetch locality
+  bool optimizeVertexOrder = false;
+  // Simplified levels of detail, as fractions of the triangle count. Each is
+  // written to a variant of the 'lod' VariantSet of the mesh, next to the
+  // 'full' variant (empty = off).
+  std::vector<float> lodRatios;
+  // Generate smooth vertex normals for timesteps without vertex.normal
+  bool computeNormals = false;
+  // Write the points of sphere geometry in Morton order, stable across
+  // frames when vertex.id is present
+  bool sortPoints = false;
+  // Write objects whose positions follow the first frame under a rigid
+  // transform (within this distance) as a static mesh plus a time-sampled
+  // transform (0 = off)
+  float rigidTolerance = 0.f;
+  // Only convert the parameters whose names match one of these glob
+  // patterns, e.g. "vertex.*" (empty = all)
+  std::vector<std::string> includeParams;
+  // Skip the parameters whose names match one of these glob patterns
+  std::vector<std::string> excludeParams;
+  // MiB of the input requested into the page cache ahead of the AGX reader
+  // by inputs opened with openInput() (Linux, at most 128, 0 = off)
+  uint32_t readAheadMiB = 0;
+  // Keep the page cache footprint bounded for one-shot conversions of huge
+  // files: input pages are evicted once read, outputs once written
+  bool bypassPageCache = false;
+  // Check the CRC32C of the constants and of every timestep of inputs opened
+  // with openInput() against the sidecar '<input>.crc32c', or write that
+  // sidecar if there is none yet
+  bool verifyChecksums = false;
+  // Stop with an error once the process resident size exceeds this many
+  // bytes, or is projected to before the last timestep (0 = no limit)
+  uint64_t maxMemoryBytes = 0;
+  // Scenes: objects that are identical up to a translation are converted
+  // once and referenced as instances of that prototype
+  bool instanceDuplicates = true;
+  // Grid on which positions relative to the first frame centroid are
+  // compared to detect duplicates
+  float instanceTolerance = 1e-5f;
+};
+
+// Convert the AGX data of 'reader' into 'stage', authoring on its current
+// edit target. Stage metadata (up axis, time codes, default prim) is set and
+// the geometry is defined under /Geometry. The stage is not saved.
+bool convert(AGXReader reader,
+    const PXR_NS::UsdStageRefPtr &stage,
+    const ConvertOptions &options = ConvertOptions());
+
+// Convert into a new anonymous in-memory layer. Returns null on failure.
+PXR_NS::SdfLayerRefPtr convertToLayer(
+    AGXReader reader, const ConvertOptions &options = ConvertOptions());
+
+// Convert and save to 'outputPath'. A path ending in .usdz is written as a
+// usdz package, anything else with the file format of its extension.
+bool convertToFile(AGXReader reader,
+    const std::string &outputPath,
+    const ConvertOptions &options = ConvertOptions());
+
+// Assemble a scene from several AGX files, one object each. The inputs are
+// converted concurrently, each into its own layer in '<output stem>_objects/'
+// next to 'outputPath'. The root stage at 'outputPath' only references these
+// layers, one prim per input under /Geometry named after the input file, so
+// it opens without reading any geometry. All objects share the time codes of
+// the root stage (one per AGX timestep). With options.instanceDuplicates,
+// duplicate objects share one layer through instanceable references.
+bool convertScene(const std::vector<std::string> &inputPaths,
+    const std::string &outputPath,
+    const ConvertOptions &options = ConvertOptions());
+
+} // namespace agx2usd
@@ -0,0 +1,178 @@
+// Copyright 2025
+// SPDX-License-Identifier: Apache-2.0
+
+// Header-only decoders for the compact encodings written by agx2usd.
+//
+// The functions only operate on raw arrays so consumers can use them without
+// depending on USD: fetch the attribute values with the USD API of your choice
+// and pass pointers to the element data.
+
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#endif
+
+namespace agx2usd {
+
+// Decode 'agx:quantizedPoints' using 'agx:quantizedPointsBounds'.
+//
+//   q      : 3 * numPoints values in [0, 65535]
+//   bounds : min.x, min.y, min.z, max.x, max.y, max.z
+//   out    : 3 * numPoints floats
+inline void decodeQuantizedPoints(
+    const uint32_t *q, size_t numPoints, const float bounds[6], float *out)
+{
+  float step[3];
+  for (int c = 0; c < 3; ++c)
+    step[c] = (bounds[3 + c] - bounds[c]) / 65535.f;
+
+  for (size_t i = 0; i < numPoints; ++i) {
+    for (int c = 0; c < 3; ++c)
+      out[i * 3 + c] = bounds[c] + q[i * 3 + c] * step[c];
+  }
+}
+
+// Apply one frame of temporal deltas ('agx:<attr>Delta') in place:
+//
+//   values[i] += deltas[i] * precision
+//
+// 'values' holds the previous frame (the keyframe value of the attribute, or
+// the result of the previous call) and 'count' is the number of scalars, i.e.
+// 3 * number of vertices. Decoding a frame is a single streaming pass.
+inline void applyDeltas(
+    const int32_t *deltas, size_t count, float precision, float *values)
+{
+  size_t i = 0;
+#if defined(__AVX2__)
+  const __m256 scale8 = _mm256_set1_ps(precision);
+  for (; i + 8 <= count; i += 8) {
+    const __m256i d =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i *>(deltas + i));
+    const __m256 v = _mm256_loadu_ps(values + i);
+    const __m256 r =
+        _mm256_add_ps(v, _mm256_mul_ps(_mm256_cvtepi32_ps(d), scale8));
+    _mm256_storeu_ps(values + i, r);
+  }
+#endif
+#if defined(__AVX2__) || defined(__SSE2__) || defined(_M_X64)
+  const __m128 scale4 = _mm_set1_ps(precision);
+  for (; i + 4 <= count; i += 4) {
+    const __m128i d =
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(deltas + i));
+    const __m128 v = _mm_loadu_ps(values + i);
+    const __m128 r = _mm_add_ps(v, _mm_mul_ps(_mm_cvtepi32_ps(d), scale4));
+    _mm_storeu_ps(values + i, r);
+  }
+#endif
+  for (; i < count; ++i)
+    values[i] = values[i] + static_cast<float>(deltas[i]) * precision;
+}
+
+namespace detail {
+
+// Unfold octahedral coordinates in [-1, 1] to a unit vector
+inline void octDecode(float x, float y, float *out)
+{
+  const float z = 1.f - std::fabs(x) - std::fabs(y);
+  if (z < 0.f) {
+    const float fx = (1.f - std::fabs(y)) * (x >= 0.f ? 1.f : -1.f);
+    const float fy = (1.f - std::fabs(x)) * (y >= 0.f ? 1.f : -1.f);
+    x = fx;
+    y = fy;
+  }
+  const float invLength = 1.f / std::sqrt(x * x + y * y + z * z);
+  out[0] = x * invLength;
+  out[1] = y * invLength;
+  out[2] = z * invLength;
+}
+
+#if defined(__AVX2__) || defined(__SSE2__) || defined(_M_X64)
+// Four normals at a time from integer coordinates in [0, maxValue]
+inline void octDecode4(__m128i qx, __m128i qy, float maxValue, float *out)
+{
+  const __m128 signMask = _mm_set1_ps(-0.f);
+  const __m128 one = _mm_set1_ps(1.f);
+  const __m128 scale = _mm_set1_ps(2.f / maxValue);
+
+  const __m128 x = _mm_sub_ps(_mm_mul_ps(_mm_cvtepi32_ps(qx), scale), one);
+  const __m128 y = _mm_sub_ps(_mm_mul_ps(_mm_cvtepi32_ps(qy), scale), one);
+  const __m128 ax = _mm_andnot_ps(signMask, x);
+  const __m128 ay = _mm_andnot_ps(signMask, y);
+  const __m128 z = _mm_sub_ps(_mm_sub_ps(one, ax), ay);
+
+  const __m128 lower = _mm_cmplt_ps(z, _mm_setzero_ps());
+  const __m128 fx = _mm_or_ps(_mm_sub_ps(one, ay), _mm_and_ps(signMask, x));
+  const __m128 fy = _mm_or_ps(_mm_sub_ps(one, ax), _mm_and_ps(signMask, y));
+  const __m128 ux = _mm_or_ps(_mm_and_ps(lower, fx), _mm_andnot_ps(lower, x));
+  const __m128 uy = _mm_or_ps(_mm_and_ps(lower, fy), _mm_andnot_ps(lower, y));
+
+  const __m128 length = _mm_sqrt_ps(_mm_add_ps(
+      _mm_add_ps(_mm_mul_ps(ux, ux), _mm_mul_ps(uy, uy)), _mm_mul_ps(z, z)));
+  alignas(16) float n[3][4];
+  _mm_store_ps(n[0], _mm_div_ps(ux, length));
+  _mm_store_ps(n[1], _mm_div_ps(uy, length));
+  _mm_store_ps(n[2], _mm_div_ps(z, length));
+  for (int k = 0; k < 4; ++k) {
+    out[3 * k] = n[0][k];
+    out[3 * k + 1] = n[1][k];
+    out[3 * k + 2] = n[2][k];
+  }
+}
+#endif
+
+} // namespace detail
+
+// Decode 16-bit octahedral normals ('primvars:agx:octNormals', uint[]): the
+// low 16 bits of each value hold x, the high 16 bits y, both mapped from
+// [-1, 1] to [0, 65535]. Writes 3 * count floats of unit normals to 'out'.
+inline void decodeOctNormals16(const uint32_t *q, size_t count, float *out)
+{
+  size_t i = 0;
+#if defined(__AVX2__) || defined(__SSE2__) || defined(_M_X64)
+  const __m128i lowMask = _mm_set1_epi32(0xffff);
+  for (; i + 4 <= count; i += 4) {
+    const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(q + i));
+    detail::octDecode4(_mm_and_si128(v, lowMask),
+        _mm_srli_epi32(v, 16),
+        65535.f,
+        out + 3 * i);
+  }
+#endif
+  for (; i < count; ++i) {
+    detail::octDecode((q[i] & 0xffff) * (2.f / 65535.f) - 1.f,
+        (q[i] >> 16) * (2.f / 65535.f) - 1.f,
+        out + 3 * i);
+  }
+}
+
+// Decode 8-bit octahedral normals ('primvars:agx:octNormals', uchar[] with
+// element size 2): x then y per normal, mapped from [-1, 1] to [0, 255].
+inline void decodeOctNormals8(const uint8_t *q, size_t count, float *out)
+{
+  size_t i = 0;
+#if defined(__AVX2__) || defined(__SSE2__) || defined(_M_X64)
+  const __m128i lowMask = _mm_set1_epi32(0xffff);
+  for (; i + 4 <= count; i += 4) {
+    // x0 y0 .. x3 y3 widened to 16 bits are 32-bit lanes of x | y << 16
+    const __m128i bytes =
+        _mm_loadl_epi64(reinterpret_cast<const __m128i *>(q + 2 * i));
+    const __m128i v = _mm_unpacklo_epi8(bytes, _mm_setzero_si128());
+    detail::octDecode4(
+        _mm_and_si128(v, lowMask), _mm_srli_epi32(v, 16), 255.f, out + 3 * i);
+  }
+#endif
+  for (; i < count; ++i) {
+    detail::octDecode(q[2 * i] * (2.f / 255.f) - 1.f,
+        q[2 * i + 1] * (2.f / 255.f) - 1.f,
+        out + 3 * i);
+  }
+}
+
+} // namespace agx2usd
@@ -0,0 +1,294 @@
+// Copyright 2025
+// SPDX-License-Identifier: Apache-2.0
+
+#include "checksum.h"
+#include "log.h"
+
+#if defined(__x86_64__) && defined(__GNUC__)
+#include <nmmintrin.h>
+#define AGX2USD_CRC32C_SSE42
+#elif defined(__aarch64__) && defined(__ARM_FEATURE_CRC32)
+#include <arm_acle.h>
+#define AGX2USD_CRC32C_ARM
+#endif
+
+// std
+#include <array>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+namespace agx2usd {
+
+namespace {
+
+constexpr uint32_t kPolynomial = 0x82F63B78u; // reflected Castagnoli
+constexpr const char *kSidecarHeader = "# agx2usd crc32c v1";
+
+// Slice-by-8 tables of the portable implementation
+using CrcTables = std::array<std::array<uint32_t, 256>, 8>;
+
+const CrcTables &getTables()
+{
+  static const CrcTables tables = [] {
+    CrcTables t{};
+    for (uint32_t i = 0; i < 256; ++i) {
+      uint32_t crc = i;
+      for (int bit = 0; bit < 8; ++bit)
+        crc = (crc >> 1) ^ (kPolynomial & (0u - (crc & 1)));
+      t[0][i] = crc;
+    }
+    for (uint32_t i = 0; i < 256; ++i) {
+      for (int k = 1; k < 8; ++k)
+        t[k][i] = (t[k - 1][i] >> 8) ^ t[0][t[k - 1][i] & 0xFF];
+    }
+    return t;
+  }();
+  return tables;
+}
+
+uint32_t crc32cSoftware(uint32_t crc, const uint8_t *p, size_t size)
+{
+  const CrcTables &t = getTables();
+  while (size >= 8) {
+    uint64_t word;
+    std::memcpy(&word, p, 8); // little endian, as on all supported targets
+    word ^= crc;
+    crc = t[7][word & 0xFF] ^ t[6][(word >> 8) & 0xFF]
+        ^ t[5][(word >> 16) & 0xFF] ^ t[4][(word >> 24) & 0xFF]
+        ^ t[3][(word >> 32) & 0xFF] ^ t[2][(word >> 40) & 0xFF]
+        ^ t[1][(word >> 48) & 0xFF] ^ t[0][word >> 56];
+    p += 8;
+    size -= 8;
+  }
+  while (size-- > 0)
+    crc = (crc >> 8) ^ t[0][(crc ^ *p++) & 0xFF];
+  return crc;
+}
+
+#ifdef AGX2USD_CRC32C_SSE42
+
+// Bytes per stream of the interleaved loop
+constexpr size_t kStrideBytes = 2048;
+
+__attribute__((target("sse4.2"))) uint32_t crc32cSerial(
+    uint32_t crc, const uint8_t *p, size_t size)
+{
+  uint64_t crc64 = crc;
+  while (size >= 8) {
+    uint64_t word;
+    std::memcpy(&word, p, 8);
+    crc64 = _mm_crc32_u64(crc64, word);
+    p += 8;
+    size -= 8;
+  }
+  uint32_t crc32 = static_cast<uint32_t>(crc64);
+  while (size-- > 0)
+    crc32 = _mm_crc32_u8(crc32, *p++);
+  return crc32;
+}
+
+// Advancing a CRC register over kStrideBytes zero bytes is linear in the
+// register, so it is tabulated per register byte
+using ShiftTables = std::array<std::array<uint32_t, 256>, 4>;
+
+const ShiftTables &getShiftTables()
+{
+  static const ShiftTables tables = [] {
+    ShiftTables t{};
+    const std::vector<uint8_t> zeros(kStrideBytes);
+    for (uint32_t k = 0; k < 4; ++k) {
+      for (uint32_t b = 0; b < 256; ++b)
+        t[k][b] = crc32cSerial(b << (8 * k), zeros.data(), kStrideBytes);
+    }
+    return t;
+  }();
+  return tables;
+}
+
+uint32_t shiftStride(const ShiftTables &t, uint32_t crc)
+{
+  return t[0][crc & 0xFF] ^ t[1][(crc >> 8) & 0xFF]
+      ^ t[2][(crc >> 16) & 0xFF] ^ t[3][crc >> 24];
+}
+
+// The crc32 instruction has a latency of 3 cycles but a throughput of 1, so
+// three independent streams are computed together and then combined
+__attribute__((target("sse4.2"))) uint32_t crc32cHardware(
+    uint32_t crc, const uint8_t *p, size_t size)
+{
+  if (size >= 3 * kStrideBytes) {
+    const ShiftTables &t = getShiftTables();
+    while (size >= 3 * kStrideBytes) {
+      uint64_t a = crc;
+      uint64_t b = 0;
+      uint64_t c = 0;
+      for (size_t i = 0; i < kStrideBytes; i += 8) {
+        uint64_t words[3];
+        std::memcpy(&words[0], p + i, 8);
+        std::memcpy(&words[1], p + kStrideBytes + i, 8);
+        std::memcpy(&words[2], p + 2 * kStrideBytes + i, 8);
+        a = _mm_crc32_u64(a, words[0]);
+        b = _mm_crc32_u64(b, words[1]);
+        c = _mm_crc32_u64(c, words[2]);
+      }
+      crc = shiftStride(t,
+                shiftStride(t, static_cast<uint32_t>(a))
+                    ^ static_cast<uint32_t>(b))
+          ^ static_cast<uint32_t>(c);
+      p += 3 * kStrideBytes;
+      size -= 3 * kStrideBytes;
+    }
+  }
+  return crc32cSerial(crc, p, size);
+}
+
+bool hasHardwareCrc()
+{
+  static const bool supported = __builtin_cpu_supports("sse4.2");
+  return supported;
+}
+
+#elif defined(AGX2USD_CRC32C_ARM)
+
+uint32_t crc32cHardware(uint32_t crc, const uint8_t *p, size_t size)
+{
+  while (size >= 8) {
+    uint64_t word;
+    std::memcpy(&word, p, 8);
+    crc = __crc32cd(crc, word);
+    p += 8;
+    size -= 8;
+  }
+  while (size-- > 0)
+    crc = __crc32cb(crc, *p++);
+  return crc;
+}
+
+bool hasHardwareCrc()
+{
+  return true;
+}
+
+#endif
+
+std::string formatCrc(uint32_t crc)
+{
+  char text[16];
+  std::snprintf(text, sizeof(text), "%08x", crc);
+  return text;
+}
+
+} // namespace
+
+uint32_t crc32c(uint32_t crc, const void *data, size_t size)
+{
+  const uint8_t *p = static_cast<const uint8_t *>(data);
+  crc = ~crc;
+#if defined(AGX2USD_CRC32C_SSE42) || defined(AGX2USD_CRC32C_ARM)
+  if (hasHardwareCrc())
+    return ~crc32cHardware(crc, p, size);
+#endif
+  return ~crc32cSoftware(crc, p, size);
+}
+
+ChecksumTable::ChecksumTable(const std::string &inputPath)
+    : inputPath(inputPath), sidecarPath(inputPath + ".crc32c")
+{
+  verifying = load();
+}
+
+bool ChecksumTable::isVerifying() const
+{
+  return verifying;
+}
+
+void ChecksumTable::beginSection()
+{
+  crc = 0;
+}
+
+void ChecksumTable::add(const AGXParamView &pv)
+{
+  crc = crc32c(crc, pv.name, pv.nameLength);
+  crc = crc32c(crc, pv.data, pv.dataBytes);
+}
+
+bool ChecksumTable::endSection()
+{
+  const size_t section = sections.size();
+  sections.push_back(crc);
+  if (!verifying)
+    return true;
+
+  if (section >= expected.size()) {
+    std::cerr << "Error: " << inputPath << " has more sections than "
+              << sidecarPath << " lists (" << expected.size() << ")\n";
+    return false;
+  }
+  if (crc != expected[section]) {
+    std::cerr << "Error: Checksum mismatch in "
+              << (section == 0 ? std::string("the constants")
+                               : "time step " + std::to_string(section - 1))
+              << " of " << inputPath << ": " << formatCrc(crc) << ", expected "
+              << formatCrc(expected[section]) << "\n";
+    return false;
+  }
+  return true;
+}
+
+bool ChecksumTable::finish()
+{
+  if (verifying) {
+    if (sections.size() != expected.size()) {
+      std::cerr << "Error: " << inputPath << " ends after "
+                << sections.size() << " of " << expected.size()
+                << " checksummed sections, it may be truncated\n";
+      return false;
+    }
+    logInfo("Verified {} checksums of {}", sections.size(), inputPath);
+    return true;
+  }
+
+  std::ofstream out(sidecarPath);
+  out << kSidecarHeader << "\n";
+  for (size_t i = 0; i < sections.size(); ++i) {
+    out << (i == 0 ? std::string("constants") : std::to_string(i - 1)) << " "
+        << formatCrc(sections[i]) << "\n";
+  }
+  if (!out) {
+    std::cerr << "Error: Failed to write " << sidecarPath << "\n";
+    return false;
+  }
+  logInfo("Wrote {} checksums to {}", sections.size(), sidecarPath);
+  return true;
+}
+
+bool ChecksumTable::load()
+{
+  std::ifstream in(sidecarPath);
+  if (!in)
+    return false;
+
+  std::string line;
+  bool valid = std::getline(in, line) && line == kSidecarHeader;
+  std::string section;
+  std::string value;
+  while (valid && in >> section >> value) {
+    char *end = nullptr;
+    const unsigned long crc = std::strtoul(value.c_str(), &end, 16);
+    valid = value.size() == 8 && *end == '\0';
+    expected.push_back(static_cast<uint32_t>(crc));
+  }
+  if (!valid) {
+    std::cerr << "Warning: Ignoring " << sidecarPath
+              << ", not an agx2usd checksum table\n";
+    expected.clear();
+  }
+  return valid;
+}
+
+} // namespace agx2usd
@@ -0,0 +1,55 @@
+// Copyright 2025
+// SPDX-License-Identifier: Apache-2.0
+
+// Integrity checksums of AGX payloads
+
+#pragma once
+
+// AGX
+#include "agx/agx_read.h"
+
+// std
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace agx2usd {
+
+// CRC32C (Castagnoli) of 'data', continuing from 'crc' (0 to start). Uses
+// the SSE4.2 or ARMv8 CRC instructions when the CPU has them.
+uint32_t crc32c(uint32_t crc, const void *data, size_t size);
+
+// One CRC32C per section of an AGX file (the constants, then every
+// timestep) over the names and payloads of its parameters, kept in a text
+// sidecar '<input>.crc32c'. If the sidecar exists, the sections are
+// verified against it as they are read; otherwise the checksums are
+// recorded and the sidecar is written once the whole file was read.
+class ChecksumTable
+{
+ public:
+  explicit ChecksumTable(const std::string &inputPath);
+
+  bool isVerifying() const;
+
+  void beginSection();
+  void add(const AGXParamView &pv);
+  // Returns false (and reports it) if a verified section does not match
+  bool endSection();
+
+  // After the last section: writes the sidecar when recording, or checks
+  // that no section is missing when verifying
+  bool finish();
+
+ private:
+  bool load();
+
+  std::string inputPath;
+  std::string sidecarPath;
+  std::vector<uint32_t> expected;
+  std::vector<uint32_t> sections;
+  uint32_t crc = 0;
+  bool verifying = false;
+};
+
+} // namespace agx2usd
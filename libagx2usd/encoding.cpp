@@ -0,0 +1,260 @@
+// Copyright 2025
+// SPDX-License-Identifier: Apache-2.0
+
+#include "encoding.h"
+#include "agx2usd_decode.h"
+
+// USD
+#include <pxr/usd/sdf/types.h>
+
+// std
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#endif
+
+namespace agx2usd {
+
+namespace {
+
+// Octahedral projection of one normal to integers in [0, maxValue]. Rounds
+// to nearest even, like the SIMD path below.
+void octEncode(const float *n, float maxValue, int &qx, int &qy)
+{
+  const float sum = std::max(
+      std::fabs(n[0]) + std::fabs(n[1]) + std::fabs(n[2]), 1e-30f);
+  float x = n[0] / sum;
+  float y = n[1] / sum;
+  if (n[2] < 0.f) {
+    const float fx = (1.f - std::fabs(y)) * std::copysign(1.f, x);
+    const float fy = (1.f - std::fabs(x)) * std::copysign(1.f, y);
+    x = fx;
+    y = fy;
+  }
+  qx = static_cast<int>(std::nearbyint((x * 0.5f + 0.5f) * maxValue));
+  qy = static_cast<int>(std::nearbyint((y * 0.5f + 0.5f) * maxValue));
+}
+
+#if defined(__SSE2__) || defined(_M_X64)
+// Four normals at a time; 'n' points to 12 packed floats
+void octEncode4(const float *n, float maxValue, __m128i &qx, __m128i &qy)
+{
+  const __m128 x = _mm_setr_ps(n[0], n[3], n[6], n[9]);
+  const __m128 y = _mm_setr_ps(n[1], n[4], n[7], n[10]);
+  const __m128 z = _mm_setr_ps(n[2], n[5], n[8], n[11]);
+
+  const __m128 signMask = _mm_set1_ps(-0.f);
+  const __m128 one = _mm_set1_ps(1.f);
+  const __m128 half = _mm_set1_ps(0.5f);
+
+  const __m128 sum = _mm_max_ps(
+      _mm_add_ps(_mm_add_ps(_mm_andnot_ps(signMask, x),
+                     _mm_andnot_ps(signMask, y)),
+          _mm_andnot_ps(signMask, z)),
+      _mm_set1_ps(1e-30f));
+  const __m128 px = _mm_div_ps(x, sum);
+  const __m128 py = _mm_div_ps(y, sum);
+
+  // Fold the lower hemisphere: (1 - |y|) * sign(x), (1 - |x|) * sign(y)
+  const __m128 fx = _mm_or_ps(
+      _mm_sub_ps(one, _mm_andnot_ps(signMask, py)), _mm_and_ps(signMask, px));
+  const __m128 fy = _mm_or_ps(
+      _mm_sub_ps(one, _mm_andnot_ps(signMask, px)), _mm_and_ps(signMask, py));
+  const __m128 lower = _mm_cmplt_ps(z, _mm_setzero_ps());
+  const __m128 ox = _mm_or_ps(_mm_and_ps(lower, fx), _mm_andnot_ps(lower, px));
+  const __m128 oy = _mm_or_ps(_mm_and_ps(lower, fy), _mm_andnot_ps(lower, py));
+
+  const __m128 scale = _mm_set1_ps(maxValue);
+  qx = _mm_cvtps_epi32(
+      _mm_mul_ps(_mm_add_ps(_mm_mul_ps(ox, half), half), scale));
+  qy = _mm_cvtps_epi32(
+      _mm_mul_ps(_mm_add_ps(_mm_mul_ps(oy, half), half), scale));
+}
+#endif
+
+} // namespace
+
+// Convert unsigned 32-bit indices to USD's signed index type
+VtArray<int> convertIndices(const void *src, size_t count)
+{
+  const auto *in = static_cast<const uint32_t *>(src);
+  VtArray<int> out;
+  out.resize(count, [&](int *begin, int *) {
+    parallelRange(count, [&](size_t b, size_t e) {
+      for (size_t i = b; i < e; ++i)
+        begin[i] = static_cast<int>(in[i]);
+    });
+  });
+  return out;
+}
+
+// Snap every coordinate to the nearest multiple of 'precision'. Repeated
+// values make the crate's array compression considerably more effective.
+void snapToGrid(VtArray<GfVec3f> &points, float precision)
+{
+  const float invPrecision = 1.f / precision;
+  GfVec3f *data = points.data();
+  parallelRange(points.size(), [&](size_t b, size_t e) {
+    for (size_t i = b; i < e; ++i) {
+      for (int c = 0; c < 3; ++c)
+        data[i][c] = std::round(data[i][c] * invPrecision) * precision;
+    }
+  });
+}
+
+QuantizedPoints quantizePoints(const VtArray<GfVec3f> &points)
+{
+  GfVec3f lo(0.f, 0.f, 0.f);
+  GfVec3f hi(0.f, 0.f, 0.f);
+  if (!points.empty()) {
+    lo = hi = points[0];
+    for (const auto &p : points) {
+      for (int c = 0; c < 3; ++c) {
+        lo[c] = std::min(lo[c], p[c]);
+        hi[c] = std::max(hi[c], p[c]);
+      }
+    }
+  }
+
+  float scale[3];
+  for (int c = 0; c < 3; ++c) {
+    const float range = hi[c] - lo[c];
+    scale[c] = range > 0.f ? 65535.f / range : 0.f;
+  }
+
+  QuantizedPoints result;
+  result.bounds = {lo, hi};
+  result.values.resize(points.size() * 3);
+  unsigned int *out = result.values.data();
+  const GfVec3f *in = points.cdata();
+  parallelRange(points.size(), [&](size_t b, size_t e) {
+    for (size_t i = b; i < e; ++i) {
+      for (int c = 0; c < 3; ++c) {
+        const float q = std::round((in[i][c] - lo[c]) * scale[c]);
+        out[i * 3 + c] =
+            static_cast<unsigned int>(std::min(std::max(q, 0.f), 65535.f));
+      }
+    }
+  });
+  return result;
+}
+
+void encodeOctNormals16(
+    const VtArray<GfVec3f> &normals, VtArray<unsigned int> &out)
+{
+  const size_t count = normals.size();
+  const float *in = count > 0 ? normals.cdata()->data() : nullptr;
+  out.resize(count);
+  unsigned int *dst = out.data();
+  parallelRange(count, [&](size_t b, size_t e) {
+    size_t i = b;
+#if defined(__SSE2__) || defined(_M_X64)
+    for (; i + 4 <= e; i += 4) {
+      __m128i qx, qy;
+      octEncode4(in + 3 * i, 65535.f, qx, qy);
+      _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i),
+          _mm_or_si128(qx, _mm_slli_epi32(qy, 16)));
+    }
+#endif
+    for (; i < e; ++i) {
+      int qx, qy;
+      octEncode(in + 3 * i, 65535.f, qx, qy);
+      dst[i] = static_cast<unsigned int>(qx)
+          | (static_cast<unsigned int>(qy) << 16);
+    }
+  });
+}
+
+void encodeOctNormals8(
+    const VtArray<GfVec3f> &normals, VtArray<unsigned char> &out)
+{
+  const size_t count = normals.size();
+  const float *in = count > 0 ? normals.cdata()->data() : nullptr;
+  out.resize(2 * count);
+  unsigned char *dst = out.data();
+  parallelRange(count, [&](size_t b, size_t e) {
+    size_t i = b;
+#if defined(__SSE2__) || defined(_M_X64)
+    for (; i + 4 <= e; i += 4) {
+      __m128i qx, qy;
+      octEncode4(in + 3 * i, 255.f, qx, qy);
+      // Narrow to bytes x0..x3 y0..y3, then interleave to x0 y0 .. x3 y3
+      const __m128i bytes =
+          _mm_packus_epi16(_mm_packs_epi32(qx, qy), _mm_setzero_si128());
+      _mm_storel_epi64(reinterpret_cast<__m128i *>(dst + 2 * i),
+          _mm_unpacklo_epi8(bytes, _mm_srli_si128(bytes, 4)));
+    }
+#endif
+    for (; i < e; ++i) {
+      int qx, qy;
+      octEncode(in + 3 * i, 255.f, qx, qy);
+      dst[2 * i] = static_cast<unsigned char>(qx);
+      dst[2 * i + 1] = static_cast<unsigned char>(qy);
+    }
+  });
+}
+
+void DeltaEncoder::encode(const VtArray<GfVec3f> &values)
+{
+  // Deltas beyond this magnitude force a keyframe instead of overflowing
+  constexpr float maxDelta = 1 << 30;
+
+  const size_t count = values.size() * 3;
+  const float *src = values.empty() ? nullptr : values.cdata()->data();
+
+  keyframe = decoded.size() != count || sinceKey + 1 >= keyInterval;
+
+  if (!keyframe) {
+    deltas.resize(count);
+    int *out = deltas.data();
+    const float invPrecision = 1.f / precision;
+    std::atomic<bool> overflow{false};
+    parallelRange(count, [&](size_t b, size_t e) {
+      for (size_t i = b; i < e; ++i) {
+        const float d = std::round((src[i] - decoded[i]) * invPrecision);
+        if (!(std::fabs(d) < maxDelta)) {
+          overflow = true;
+          return;
+        }
+        out[i] = static_cast<int>(d);
+      }
+    });
+    keyframe = overflow;
+  }
+
+  if (keyframe) {
+    deltas = VtArray<int>();
+    decoded.assign(src, src + count);
+    sinceKey = 0;
+    return;
+  }
+
+  // Reconstruct exactly as a consumer will, so the next delta is taken
+  // against the decoded values rather than the original ones
+  agx2usd::applyDeltas(reinterpret_cast<const int32_t *>(deltas.cdata()),
+      count,
+      precision,
+      decoded.data());
+  ++sinceKey;
+}
+
+void DeltaEncoder::author(const UsdPrim &prim,
+    const UsdAttribute &attr,
+    const VtArray<GfVec3f> &values,
+    double timeCode) const
+{
+  if (!deltaAttr) {
+    deltaAttr = prim.CreateAttribute(deltaName, SdfValueTypeNames->IntArray);
+    prim.CreateAttribute(precisionName, SdfValueTypeNames->Float).Set(precision);
+  }
+
+  // An empty delta array marks the frame as a keyframe
+  deltaAttr.Set(deltas, timeCode);
+  if (keyframe)
+    attr.Set(values, timeCode);
+}
+
+} // namespace agx2usd
@@ -0,0 +1,127 @@
+// Copyright 2025
+// SPDX-License-Identifier: Apache-2.0
+
+// Conversion kernels and compact encodings of per-vertex data
+
+#pragma once
+
+#include "parallel.h"
+
+// USD
+#include <pxr/pxr.h>
+#include <pxr/usd/usd/prim.h>
+#include <pxr/usd/usd/attribute.h>
+#include <pxr/base/vt/array.h>
+#include <pxr/base/gf/vec3f.h>
+#include <pxr/base/tf/token.h>
+
+// std
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace agx2usd {
+
+PXR_NAMESPACE_USING_DIRECTIVE
+
+// Copy 'count' tightly packed tuples of floats into a VtArray of Gf vectors
+// (or floats). The destination is filled in place without zero-initializing.
+template <typename T>
+VtArray<T> convertFloatArray(const void *src, size_t count)
+{
+  static_assert(sizeof(T) % sizeof(float) == 0, "T must be a float tuple");
+  const auto *in = static_cast<const uint8_t *>(src);
+  VtArray<T> out;
+  out.resize(count, [&](T *begin, T *) {
+    parallelRange(count, [&](size_t b, size_t e) {
+      std::memcpy(begin + b, in + b * sizeof(T), (e - b) * sizeof(T));
+    });
+  });
+  return out;
+}
+
+// Same as above, but refills 'out' in place when it already holds 'count'
+// elements. Callers only keep arrays across timesteps that were not handed to
+// the layer, so 'out' is unique and writing to it never triggers a copy.
+template <typename T>
+void convertFloatArray(const void *src, size_t count, VtArray<T> &out)
+{
+  if (out.size() != count) {
+    out = convertFloatArray<T>(src, count);
+    return;
+  }
+  const auto *in = static_cast<const uint8_t *>(src);
+  T *dst = out.data();
+  parallelRange(count, [&](size_t b, size_t e) {
+    std::memcpy(dst + b, in + b * sizeof(T), (e - b) * sizeof(T));
+  });
+}
+
+// Convert unsigned 32-bit indices to USD's signed index type
+VtArray<int> convertIndices(const void *src, size_t count);
+
+// Snap every coordinate to the nearest multiple of 'precision'. Repeated
+// values make the crate's array compression considerably more effective.
+void snapToGrid(VtArray<GfVec3f> &points, float precision);
+
+// Positions as quantized integers (see README, "Quantized positions"):
+//   agx:quantizedPoints       uint[]   3 values in [0, 65535] per vertex
+//   agx:quantizedPointsBounds float3[] per-frame [min, max] of the positions
+struct QuantizedPoints
+{
+  VtArray<unsigned int> values;
+  VtArray<GfVec3f> bounds;
+};
+
+QuantizedPoints quantizePoints(const VtArray<GfVec3f> &points);
+
+// Normals as octahedral coordinates (see README, "Octahedral normals"): the
+// unit vector is projected onto the octahedron |x| + |y| + |z| = 1, the lower
+// half folded over the upper one, and the resulting (x, y) in [-1, 1]
+// stored as normalized integers.
+//   16 bits: one uint per normal, x in the low and y in the high 16 bits
+//    8 bits: two uchar per normal, x then y
+void encodeOctNormals16(
+    const VtArray<GfVec3f> &normals, VtArray<unsigned int> &out);
+void encodeOctNormals8(
+    const VtArray<GfVec3f> &normals, VtArray<unsigned char> &out);
+
+// Temporal delta encoder for one per-vertex vec3 attribute (see README,
+// "Delta-encoded attributes"). Every 'keyInterval' samples, and whenever the
+// vertex count changes, the full array is written to the attribute itself.
+// In between only 'agx:<name>Delta' is written: the difference to the
+// previous frame in units of 'precision'. The encoder mirrors the decoder's
+// reconstruction so quantization error does not accumulate across deltas.
+struct DeltaEncoder
+{
+  DeltaEncoder(const std::string &name, uint32_t keyInterval, float precision)
+      : deltaName("agx:" + name + "Delta"),
+        precisionName("agx:" + name + "DeltaPrecision"),
+        keyInterval(keyInterval),
+        precision(precision)
+  {}
+
+  // Encode one sample into 'keyframe' and 'deltas'. Safe to run concurrently
+  // with other encoders; USD is only touched by author().
+  void encode(const VtArray<GfVec3f> &values);
+
+  // Write the most recently encoded sample
+  void author(const UsdPrim &prim,
+      const UsdAttribute &attr,
+      const VtArray<GfVec3f> &values,
+      double timeCode) const;
+
+  TfToken deltaName;
+  TfToken precisionName;
+  uint32_t keyInterval;
+  float precision;
+  uint32_t sinceKey = 0;
+  std::vector<float> decoded;
+
+  bool keyframe = true;
+  VtArray<int> deltas;
+  mutable UsdAttribute deltaAttr;
+};
+
+} // namespace agx2usd
@@ -0,0 +1,54 @@
+// Copyright 2025
+// SPDX-License-Identifier: Apache-2.0
+
+#include "geometry_writer.h"
+#include "mesh_writer.h"
+#include "points_writer.h"
+
+// USD
+#include <pxr/usd/usdGeom/metrics.h>
+
+namespace agx2usd {
+
+bool isPositionParam(std::string_view name)
+{
+  return name == "vertex.position" || name == "position"
+      || name == "vertex.positions" || name == "positions";
+}
+
+UsdGeomXform setupStage(const UsdStageRefPtr &stage, double endTime)
+{
+  // Set standard USD metadata
+  UsdGeomSetStageUpAxis(stage, TfToken("Y"));       // Y-up coordinate system
+  UsdGeomSetStageMetersPerUnit(stage, 1.0);          // 1 unit = 1 meter
+  
+  // Set up time code settings
+  stage->SetStartTimeCode(0.0);
+  stage->SetEndTimeCode(endTime);
+  stage->SetTimeCodesPerSecond(24.0); // Standard framerate
+  stage->SetFramesPerSecond(24.0);
+
+  // Create root transform
+  auto xform = UsdGeomXform::Define(stage, SdfPath("/Geometry"));
+  
+  // Set as default prim for the stage
+  stage->SetDefaultPrim(xform.GetPrim());
+  return xform;
+}
+
+bool isPointsGeometry(std::string_view subtype, const ConvertOptions &options)
+{
+  return subtype == "sphere" && options.sortPoints;
+}
+
+std::unique_ptr<GeometryWriter> makeGeometryWriter(std::string_view subtype,
+    const UsdStageRefPtr &stage,
+    const SdfPath &path,
+    const ConvertOptions &options)
+{
+  if (isPointsGeometry(subtype, options))
+    return std::make_unique<PointsWriter>(stage, path, options);
+  return std::make_unique<MeshWriter>(stage, path, options);
+}
+
+} // namespace agx2usd
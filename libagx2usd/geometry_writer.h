@@ -0,0 +1,85 @@
+// Copyright 2025
+// SPDX-License-Identifier: Apache-2.0
+
+// Writers of one AGX / ANARI geometry object to USD
+
+#pragma once
+
+#include "agx2usd.h"
+
+// USD
+#include <pxr/usd/usdGeom/xform.h>
+#include <pxr/usd/sdf/path.h>
+
+// std
+#include <memory>
+#include <string>
+#include <string_view>
+
+namespace agx2usd {
+
+PXR_NAMESPACE_USING_DIRECTIVE
+
+class SceneMemoryLimit;
+
+// convertToFile() for an object of a scene, which checks the limit shared by
+// all objects instead of options.maxMemoryBytes
+bool convertToFile(AGXReader reader,
+    const std::string &outputPath,
+    const ConvertOptions &options,
+    SceneMemoryLimit *sceneMemory);
+
+// Parameter names that carry vertex positions
+bool isPositionParam(std::string_view name);
+
+// Set the stage metadata used for all conversions (Y up, meters, 24 fps,
+// time range [0, endTime]) and define the /Geometry root as default prim
+UsdGeomXform setupStage(const UsdStageRefPtr &stage, double endTime);
+
+// Writes the parameters of one geometry object to a USD prim, one AGX
+// parameter view at a time. The file converter feeds it from an AGXReader,
+// the ANARI capture device from the arrays of committed geometries.
+class GeometryWriter
+{
+ public:
+  virtual ~GeometryWriter() = default;
+
+  // A parameter that holds for all timesteps
+  virtual void setConstant(const AGXParamView &pv) = 0;
+
+  // The parameters of one timestep are converted as they are passed to
+  // setTimeStepParam(), then encoded and authored together by endTimeStep()
+  virtual void beginTimeStep(double timeCode) = 0;
+  virtual void setTimeStepParam(const AGXParamView &pv) = 0;
+  virtual void endTimeStep() = 0;
+
+  // Author what is held back until all timesteps are known; call once after
+  // the last timestep
+  virtual void finish() = 0;
+
+  // Bytes held by the writer between timesteps: constants, scratch arrays
+  // and the state of encoders and other optional steps
+  virtual size_t getBufferBytes() const = 0;
+
+  // Estimated bytes of array data authored to the layer so far, which USD
+  // keeps in memory until the layer is saved
+  size_t getLayerBytes() const
+  {
+    return layerBytes;
+  }
+
+ protected:
+  size_t layerBytes = 0;
+};
+
+// Whether geometry of this ANARI subtype is written as UsdGeomPoints rather
+// than a mesh: spheres, when options.sortPoints is set
+bool isPointsGeometry(std::string_view subtype, const ConvertOptions &options);
+
+// A UsdGeomPoints writer for points geometry, a UsdGeomMesh writer otherwise
+std::unique_ptr<GeometryWriter> makeGeometryWriter(std::string_view subtype,
+    const UsdStageRefPtr &stage,
+    const SdfPath &path,
+    const ConvertOptions &options);
+
+} // namespace agx2usd
@@ -0,0 +1,685 @@
+// Copyright 2025
+// SPDX-License-Identifier: Apache-2.0
+
+#include "input.h"
+#include "checksum.h"
+#include "log.h"
+#include "memory.h"
+#include "page_cache.h"
+#include "parallel.h"
+#include "read_ahead.h"
+#include "trace.h"
+
+#ifdef AGX2USD_USE_ZSTD
+#include <zstd.h>
+#endif
+#ifdef AGX2USD_USE_LZ4
+#include <lz4.h>
+#include <lz4frame.h>
+#endif
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// std
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace agx2usd {
+
+namespace {
+
+enum class Compression
+{
+  None,
+  Zstd,
+  Lz4
+};
+
+constexpr uint32_t kZstdMagic = 0xFD2FB528u;
+constexpr uint32_t kLz4Magic = 0x184D2204u;
+// Skippable frames (both formats) use the magic numbers 0x184D2A5?
+constexpr uint32_t kSkippableMagic = 0x184D2A50u;
+constexpr uint32_t kSkippableMask = 0xFFFFFFF0u;
+
+// Progress of the files opened by openInput(), by reader
+struct Inputs
+{
+  std::mutex mutex;
+  std::map<AGXReader, std::unique_ptr<InputProgress>> progress;
+};
+
+Inputs &getInputs()
+{
+  static Inputs inputs;
+  return inputs;
+}
+
+uint32_t readLE32(const uint8_t *p)
+{
+  return uint32_t(p[0]) | uint32_t(p[1]) << 8 | uint32_t(p[2]) << 16
+      | uint32_t(p[3]) << 24;
+}
+
+// Looks past leading skippable frames, with which pzstd starts its output
+Compression detectCompression(const std::string &path)
+{
+  std::ifstream in(path, std::ios::binary);
+  uint8_t header[8] = {};
+  for (;;) {
+    if (!in.read(reinterpret_cast<char *>(header), 4))
+      return Compression::None;
+    const uint32_t magic = readLE32(header);
+    if (magic == kZstdMagic)
+      return Compression::Zstd;
+    if (magic == kLz4Magic)
+      return Compression::Lz4;
+    if ((magic & kSkippableMask) != kSkippableMagic
+        || !in.read(reinterpret_cast<char *>(header + 4), 4)) {
+      return Compression::None;
+    }
+    in.seekg(readLE32(header + 4), std::ios::cur);
+  }
+}
+
+#ifdef __linux__
+
+constexpr size_t kUnknownSize = ~size_t(0);
+
+// An independently decompressible piece of the input
+struct Chunk
+{
+  enum Kind
+  {
+    ZstdFrame,
+    Lz4Block, // raw LZ4 block of an independent-block frame
+    Lz4Frame, // whole frame with linked blocks or a dictionary
+    Stored // uncompressed LZ4 block
+  };
+
+  const uint8_t *data;
+  size_t size;
+  // Decompressed size (kUnknownSize if the frame does not record it), or
+  // the maximum block size for Lz4Block
+  size_t outputSize;
+  Kind kind;
+};
+
+class MappedFile
+{
+ public:
+  ~MappedFile()
+  {
+    if (data)
+      munmap(const_cast<uint8_t *>(data), size);
+  }
+
+  bool open(const std::string &path)
+  {
+    const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+      return false;
+    struct stat info;
+    if (fstat(fd, &info) == 0 && info.st_size > 0) {
+      void *map = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (map != MAP_FAILED) {
+        data = static_cast<const uint8_t *>(map);
+        size = static_cast<size_t>(info.st_size);
+        madvise(map, size, MADV_SEQUENTIAL);
+      }
+    }
+    close(fd);
+    return data != nullptr;
+  }
+
+  const uint8_t *data = nullptr;
+  size_t size = 0;
+};
+
+#ifdef AGX2USD_USE_ZSTD
+
+// Every frame is a chunk. Files written by pzstd or in the zstd seekable
+// format consist of many frames; the plain zstd tool writes a single one.
+bool findZstdChunks(const uint8_t *data, size_t size, std::vector<Chunk> &chunks)
+{
+  size_t pos = 0;
+  while (pos < size) {
+    const size_t frameSize = ZSTD_findFrameCompressedSize(data + pos, size - pos);
+    if (ZSTD_isError(frameSize))
+      return false;
+    if ((readLE32(data + pos) & kSkippableMask) != kSkippableMagic) {
+      const unsigned long long contentSize =
+          ZSTD_getFrameContentSize(data + pos, frameSize);
+      if (contentSize == ZSTD_CONTENTSIZE_ERROR)
+        return false;
+      chunks.push_back({data + pos,
+          frameSize,
+          contentSize == ZSTD_CONTENTSIZE_UNKNOWN
+              ? kUnknownSize
+              : static_cast<size_t>(contentSize),
+          Chunk::ZstdFrame});
+    }
+    pos += frameSize;
+  }
+  return true;
+}
+
+bool decompressZstdStream(const Chunk &chunk, std::vector<uint8_t> &out)
+{
+  ZSTD_DCtx *context = ZSTD_createDCtx();
+  ZSTD_inBuffer input{chunk.data, chunk.size, 0};
+  size_t filled = 0;
+  size_t result = 1;
+  while (result != 0) {
+    if (filled == out.size())
+      out.resize(std::max(2 * out.size(), ZSTD_DStreamOutSize()));
+    ZSTD_outBuffer output{out.data(), out.size(), filled};
+    const size_t consumed = input.pos;
+    result = ZSTD_decompressStream(context, &output, &input);
+    if (ZSTD_isError(result)
+        || (output.pos == filled && input.pos == consumed)) {
+      break;
+    }
+    filled = output.pos;
+  }
+  ZSTD_freeDCtx(context);
+  out.resize(filled);
+  return result == 0;
+}
+
+#endif
+
+#ifdef AGX2USD_USE_LZ4
+
+// Walks the block headers of every frame. The blocks of frames with
+// independent blocks (the default of the lz4 tool) are chunks of their own;
+// other frames are decompressed as a whole. The optional xxHash checksums
+// are skipped on the block path, LZ4_decompress_safe() still rejects
+// malformed blocks.
+bool findLz4Chunks(const uint8_t *data, size_t size, std::vector<Chunk> &chunks)
+{
+  size_t pos = 0;
+  while (pos < size) {
+    if (size - pos < 8)
+      return false;
+    const uint32_t magic = readLE32(data + pos);
+    if ((magic & kSkippableMask) == kSkippableMagic) {
+      const size_t skip = readLE32(data + pos + 4);
+      if (size - pos - 8 < skip)
+        return false;
+      pos += 8 + skip;
+      continue;
+    }
+    if (magic != kLz4Magic)
+      return false;
+
+    const uint8_t flags = data[pos + 4];
+    const uint8_t blockDescriptor = data[pos + 5];
+    if ((flags >> 6) != 1)
+      return false;
+    const bool independent = flags & 0x20;
+    const bool blockChecksum = flags & 0x10;
+    const bool contentSize = flags & 0x08;
+    const bool contentChecksum = flags & 0x04;
+    const bool dictionary = flags & 0x01;
+    // 4 = 64 KB, 5 = 256 KB, 6 = 1 MB, 7 = 4 MB
+    const int blockSizeId = (blockDescriptor >> 4) & 7;
+    if (blockSizeId < 4)
+      return false;
+    const size_t maxBlockSize = size_t(1) << (8 + 2 * blockSizeId);
+
+    const size_t headerSize = 7 + (contentSize ? 8 : 0) + (dictionary ? 4 : 0);
+    if (size - pos < headerSize)
+      return false;
+
+    const size_t frameBegin = pos;
+    const size_t firstChunk = chunks.size();
+    pos += headerSize;
+    for (;;) {
+      if (size - pos < 4)
+        return false;
+      const uint32_t word = readLE32(data + pos);
+      pos += 4;
+      if (word == 0) // end mark
+        break;
+      const size_t blockSize = word & 0x7FFFFFFFu;
+      const size_t blockEnd = blockSize + (blockChecksum ? 4 : 0);
+      if (blockSize > maxBlockSize || size - pos < blockEnd)
+        return false;
+      if (word & 0x80000000u)
+        chunks.push_back({data + pos, blockSize, blockSize, Chunk::Stored});
+      else
+        chunks.push_back({data + pos, blockSize, maxBlockSize, Chunk::Lz4Block});
+      pos += blockEnd;
+    }
+    if (contentChecksum) {
+      if (size - pos < 4)
+        return false;
+      pos += 4;
+    }
+
+    if (!independent || dictionary) {
+      chunks.resize(firstChunk);
+      chunks.push_back(
+          {data + frameBegin, pos - frameBegin, kUnknownSize, Chunk::Lz4Frame});
+    }
+  }
+  return true;
+}
+
+bool decompressLz4Frame(const Chunk &chunk, std::vector<uint8_t> &out)
+{
+  LZ4F_dctx *context = nullptr;
+  if (LZ4F_isError(LZ4F_createDecompressionContext(&context, LZ4F_VERSION)))
+    return false;
+  size_t consumed = 0;
+  size_t filled = 0;
+  size_t result = 1;
+  while (result != 0) {
+    if (filled == out.size())
+      out.resize(std::max<size_t>(2 * out.size(), 64 * 1024));
+    size_t outputSize = out.size() - filled;
+    size_t inputSize = chunk.size - consumed;
+    result = LZ4F_decompress(context,
+        out.data() + filled,
+        &outputSize,
+        chunk.data + consumed,
+        &inputSize,
+        nullptr);
+    if (LZ4F_isError(result) || (outputSize == 0 && inputSize == 0))
+      break;
+    filled += outputSize;
+    consumed += inputSize;
+  }
+  LZ4F_freeDecompressionContext(context);
+  out.resize(filled);
+  return result == 0;
+}
+
+#endif
+
+bool decompressChunk(const Chunk &chunk, std::vector<uint8_t> &out)
+{
+  switch (chunk.kind) {
+  case Chunk::Stored:
+    out.assign(chunk.data, chunk.data + chunk.size);
+    return true;
+#ifdef AGX2USD_USE_ZSTD
+  case Chunk::ZstdFrame:
+    if (chunk.outputSize == kUnknownSize)
+      return decompressZstdStream(chunk, out);
+    out.resize(chunk.outputSize);
+    return ZSTD_decompress(out.data(), out.size(), chunk.data, chunk.size)
+        == out.size();
+#endif
+#ifdef AGX2USD_USE_LZ4
+  case Chunk::Lz4Block: {
+    out.resize(chunk.outputSize);
+    const int result =
+        LZ4_decompress_safe(reinterpret_cast<const char *>(chunk.data),
+            reinterpret_cast<char *>(out.data()),
+            static_cast<int>(chunk.size),
+            static_cast<int>(out.size()));
+    if (result < 0)
+      return false;
+    out.resize(static_cast<size_t>(result));
+    return true;
+  }
+  case Chunk::Lz4Frame:
+    return decompressLz4Frame(chunk, out);
+#endif
+  default:
+    return false;
+  }
+}
+
+bool writeAll(int fd, const uint8_t *data, size_t size)
+{
+  size_t written = 0;
+  while (written < size) {
+    const ssize_t n = write(fd, data + written, size - written);
+    if (n < 0 && errno != EINTR)
+      return false;
+    if (n > 0)
+      written += static_cast<size_t>(n);
+  }
+  return true;
+}
+
+void reportDecompressLimit(const std::string &name, uint64_t maxBytes)
+{
+  std::cerr << "Error: " << name << " decompresses to more than the memory "
+            << "limit of " << formatBytes(maxBytes) << "; compressed input is "
+            << "decompressed in memory in full before it is converted\n";
+}
+
+// Decompress 'path' into a memfd and return its descriptor, or -1. 'name'
+// is the input as given by the user, for messages. Chunks
+// are decompressed in parallel batches of a few per thread and appended in
+// order, so at most one batch of output is buffered besides the memfd.
+// Fails once the output would exceed 'maxBytes' (0 = no limit): the pages
+// of the memfd are not part of the resident size that --max-memory samples.
+int decompressToMemory(const std::string &path,
+    const std::string &name,
+    Compression compression,
+    uint64_t maxBytes)
+{
+  TraceSpan span("decompress", name);
+
+  MappedFile file;
+  if (!file.open(path)) {
+    std::cerr << "Error: Failed to map compressed file: " << name << "\n";
+    return -1;
+  }
+
+  std::vector<Chunk> chunks;
+  bool parsed = false;
+#ifdef AGX2USD_USE_ZSTD
+  if (compression == Compression::Zstd)
+    parsed = findZstdChunks(file.data, file.size, chunks);
+#endif
+#ifdef AGX2USD_USE_LZ4
+  if (compression == Compression::Lz4)
+    parsed = findLz4Chunks(file.data, file.size, chunks);
+#endif
+  if (!parsed) {
+    std::cerr << "Error: Corrupt or truncated compressed file: " << name
+              << "\n";
+    return -1;
+  }
+
+  // Sizes recorded in the frames fail early, before anything is decompressed
+  if (maxBytes > 0) {
+    uint64_t knownBytes = 0;
+    for (const Chunk &chunk : chunks) {
+      if (chunk.kind == Chunk::ZstdFrame || chunk.kind == Chunk::Stored)
+        knownBytes += chunk.outputSize == kUnknownSize ? 0 : chunk.outputSize;
+    }
+    if (knownBytes > maxBytes) {
+      reportDecompressLimit(name, maxBytes);
+      return -1;
+    }
+  }
+
+  const int fd = memfd_create("agx2usd-input", MFD_CLOEXEC);
+  if (fd < 0) {
+    std::cerr << "Error: Failed to create an in-memory file for " << name
+              << "\n";
+    return -1;
+  }
+
+  const size_t batchSize =
+      4 * static_cast<size_t>(std::max(1u, std::thread::hardware_concurrency()));
+  std::vector<std::vector<uint8_t>> outputs(std::min(batchSize, chunks.size()));
+  uint64_t totalBytes = 0;
+  for (size_t begin = 0; begin < chunks.size(); begin += batchSize) {
+    const size_t count = std::min(batchSize, chunks.size() - begin);
+    std::atomic<bool> failed{false};
+    parallelForEach(count, [&](size_t i) {
+      if (!decompressChunk(chunks[begin + i], outputs[i]))
+        failed = true;
+    });
+    if (failed) {
+      std::cerr << "Error: Failed to decompress " << name << "\n";
+      close(fd);
+      return -1;
+    }
+    for (size_t i = 0; i < count; ++i) {
+      if (maxBytes > 0 && totalBytes + outputs[i].size() > maxBytes) {
+        reportDecompressLimit(name, maxBytes);
+        close(fd);
+        return -1;
+      }
+      if (!writeAll(fd, outputs[i].data(), outputs[i].size())) {
+        std::cerr << "Error: Out of memory decompressing " << name << "\n";
+        close(fd);
+        return -1;
+      }
+      totalBytes += outputs[i].size();
+    }
+  }
+
+  logInfo("Decompressed {} ({} blocks) into {} in memory",
+      name,
+      chunks.size(),
+      formatBytes(totalBytes));
+  return fd;
+}
+
+// Copy a pipe, FIFO or terminal into a memfd and return its descriptor, or
+// -1. splice() moves pipe pages without copying them through user space.
+// Fails once more than 'maxBytes' were read (0 = no limit).
+int spoolToMemory(const std::string &path, uint64_t maxBytes)
+{
+  TraceSpan span("spool", path);
+
+  const bool standardInput = path == "-";
+  const int input =
+      standardInput ? STDIN_FILENO : ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (input < 0) {
+    std::cerr << "Error: Failed to open " << path << "\n";
+    return -1;
+  }
+  const int fd = memfd_create("agx2usd-spool", MFD_CLOEXEC);
+  if (fd < 0) {
+    std::cerr << "Error: Failed to create an in-memory file for " << path
+              << "\n";
+    if (!standardInput)
+      close(input);
+    return -1;
+  }
+
+  constexpr size_t kSpliceBytes = 1 << 20;
+  uint64_t totalBytes = 0;
+  bool useSplice = true;
+  std::vector<uint8_t> buffer;
+  int error = 0;
+  for (;;) {
+    ssize_t n = 0;
+    if (useSplice) {
+      n = splice(input, nullptr, fd, nullptr, kSpliceBytes, SPLICE_F_MOVE);
+      if (n < 0 && errno == EINVAL) {
+        // Not a pipe, or the kernel cannot splice into the memfd
+        useSplice = false;
+        buffer.resize(kSpliceBytes);
+        continue;
+      }
+    } else {
+      n = read(input, buffer.data(), buffer.size());
+      if (n > 0 && !writeAll(fd, buffer.data(), static_cast<size_t>(n)))
+        n = -1;
+    }
+    if (n < 0 && errno == EINTR)
+      continue;
+    if (n < 0)
+      error = errno;
+    if (n <= 0)
+      break;
+    totalBytes += static_cast<uint64_t>(n);
+    if (maxBytes > 0 && totalBytes > maxBytes)
+      break;
+  }
+  if (!standardInput)
+    close(input);
+  if (error != 0) {
+    std::cerr << "Error: Failed to read " << path << ": "
+              << std::strerror(error) << "\n";
+    close(fd);
+    return -1;
+  }
+  if (maxBytes > 0 && totalBytes > maxBytes) {
+    std::cerr << "Error: " << (standardInput ? "Standard input" : path)
+              << " exceeds the memory limit of " << formatBytes(maxBytes)
+              << "; streamed input is buffered in memory in full before it "
+                 "is converted\n";
+    close(fd);
+    return -1;
+  }
+
+  logInfo("Read {} from {} into memory",
+      formatBytes(totalBytes),
+      standardInput ? "standard input" : path);
+  return fd;
+}
+
+// Standard input ("-"), FIFOs, character devices and sockets can only be
+// read once from front to back
+bool isStream(const std::string &path)
+{
+  if (path == "-")
+    return true;
+  struct stat info;
+  return stat(path.c_str(), &info) == 0
+      && (S_ISFIFO(info.st_mode) || S_ISCHR(info.st_mode)
+          || S_ISSOCK(info.st_mode));
+}
+
+// The reader opens a memfd through procfs, which gives it a reference of its
+// own, so ours can be closed right away
+std::string getProcPath(int fd)
+{
+  return "/proc/self/fd/" + std::to_string(fd);
+}
+
+#endif
+
+// Read-ahead and page cache control only apply to files the reader reads
+// directly, not to decompressed or spooled in-memory copies. Checksums
+// apply to every input with a name for the sidecar, so not to standard
+// input.
+void addProgress(AGXReader reader,
+    const std::string &path,
+    const ConvertOptions &options,
+    bool inMemory)
+{
+  auto progress = std::make_unique<InputProgress>();
+  if (!inMemory) {
+    progress->readAhead = ReadAhead::create(path, options.readAheadMiB);
+    if (options.bypassPageCache)
+      progress->dropBehind = DropBehind::create(path);
+  }
+  if (options.verifyChecksums && path != "-")
+    progress->checksums = std::make_unique<ChecksumTable>(path);
+  if (progress->readAhead || progress->dropBehind || progress->checksums) {
+    Inputs &inputs = getInputs();
+    std::lock_guard<std::mutex> lock(inputs.mutex);
+    inputs.progress[reader] = std::move(progress);
+  }
+}
+
+// 'name' is the input as given by the user, 'path' where it is read from:
+// the same for files, the spooled in-memory copy for streams ('stream')
+AGXReader openFile(const std::string &path,
+    const std::string &name,
+    const ConvertOptions &options,
+    bool stream)
+{
+  const Compression compression = detectCompression(path);
+  if (compression == Compression::None) {
+    AGXReader reader = agxNewReader(path.c_str());
+    if (reader)
+      addProgress(reader, name, options, stream);
+    return reader;
+  }
+
+  const char *format = compression == Compression::Zstd ? "zstd" : "LZ4";
+#ifdef AGX2USD_USE_ZSTD
+  const bool zstd = true;
+#else
+  const bool zstd = false;
+#endif
+#ifdef AGX2USD_USE_LZ4
+  const bool lz4 = true;
+#else
+  const bool lz4 = false;
+#endif
+  if (!(compression == Compression::Zstd ? zstd : lz4)) {
+    std::cerr << "Error: " << name << " is " << format
+              << " compressed, but agx2usd was built without " << format
+              << " support\n";
+    return nullptr;
+  }
+
+#ifdef __linux__
+  const int fd =
+      decompressToMemory(path, name, compression, options.maxMemoryBytes);
+  if (fd < 0)
+    return nullptr;
+  AGXReader reader = agxNewReader(getProcPath(fd).c_str());
+  close(fd);
+  if (reader)
+    addProgress(reader, name, options, true);
+  return reader;
+#else
+  std::cerr << "Error: Reading " << format << " compressed files requires "
+            << "Linux: " << name << "\n";
+  return nullptr;
+#endif
+}
+
+} // namespace
+
+InputProgress::~InputProgress() = default;
+
+void InputProgress::advance(uint64_t bytes)
+{
+  if (readAhead)
+    readAhead->advance(bytes);
+  if (dropBehind)
+    dropBehind->advance(bytes);
+}
+
+AGXReader openInput(const std::string &path, const ConvertOptions &options)
+{
+#ifdef __linux__
+  // The AGX reader seeks, so streams are read to the end first. The spooled
+  // data may itself be compressed.
+  if (isStream(path)) {
+    const int fd = spoolToMemory(path, options.maxMemoryBytes);
+    if (fd < 0)
+      return nullptr;
+    AGXReader reader = openFile(getProcPath(fd), path, options, true);
+    close(fd);
+    return reader;
+  }
+#endif
+  return openFile(path, path, options, false);
+}
+
+InputProgress *getInputProgress(AGXReader reader)
+{
+  Inputs &inputs = getInputs();
+  std::lock_guard<std::mutex> lock(inputs.mutex);
+  auto it = inputs.progress.find(reader);
+  return it != inputs.progress.end() ? it->second.get() : nullptr;
+}
+
+void closeInput(AGXReader reader)
+{
+  std::unique_ptr<InputProgress> progress;
+  {
+    Inputs &inputs = getInputs();
+    std::lock_guard<std::mutex> lock(inputs.mutex);
+    auto it = inputs.progress.find(reader);
+    if (it != inputs.progress.end()) {
+      progress = std::move(it->second);
+      inputs.progress.erase(it);
+    }
+  }
+  agxReleaseReader(reader);
+}
+
+} // namespace agx2usd
@@ -0,0 +1,58 @@
+// Copyright 2025
+// SPDX-License-Identifier: Apache-2.0
+
+// Opening AGX inputs, including ones the AGX reader cannot read directly
+
+#pragma once
+
+#include "agx2usd.h"
+
+// std
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace agx2usd {
+
+class ChecksumTable;
+class DropBehind;
+class ReadAhead;
+
+// Follows the read position of the AGX reader in a plain input file, to read
+// ahead of it (options.readAheadMiB) and to evict the pages behind it from
+// the page cache (options.bypassPageCache). Also holds the checksum table of
+// the input (options.verifyChecksums), which the converter feeds.
+struct InputProgress
+{
+  std::unique_ptr<ReadAhead> readAhead;
+  std::unique_ptr<DropBehind> dropBehind;
+  std::unique_ptr<ChecksumTable> checksums;
+
+  ~InputProgress();
+
+  // The reader consumed about 'bytes' more of the file. Called by whoever
+  // reads the parameters, with their name and data size.
+  void advance(uint64_t bytes);
+};
+
+// Open 'path' with the AGX reader. Files compressed with zstd or LZ4 (frame
+// format), recognized by their magic number, are decompressed into an
+// in-memory file first, without writing to disk, up to
+// options.maxMemoryBytes of decompressed data. Independent zstd frames and
+// independent LZ4 blocks are decompressed in parallel. "-" (standard input),
+// FIFOs and other streams are not streamed: the reader seeks, so they are
+// buffered in memory in full, up to options.maxMemoryBytes, before the
+// reader is opened. Plain files get an InputProgress as configured by
+// 'options'. Compressed files and streams are read from memory, so theirs
+// only holds the checksums; standard input has no sidecar and gets none.
+// Returns null on failure; errors are reported on std::cerr.
+AGXReader openInput(
+    const std::string &path, const ConvertOptions &options = ConvertOptions());
+
+// The InputProgress of a reader from openInput(), or null if it has none
+InputProgress *getInputProgress(AGXReader reader);
+
+// Release a reader from openInput() and its InputProgress
+void closeInput(AGXReader reader);
+
+} // namespace agx2usd
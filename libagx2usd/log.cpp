@@ -0,0 +1,220 @@
+// Copyright 2025
+// SPDX-License-Identifier: Apache-2.0
+
+#include "log.h"
+
+// std
+#include <charconv>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <thread>
+
+namespace agx2usd {
+
+namespace detail {
+
+void LogRecord::add(std::string_view value)
+{
+  LogArg &arg = args[argCount++];
+  arg.size = static_cast<uint32_t>(value.size());
+  if (textSize + value.size() <= kLogTextBytes) {
+    arg.type = LogArg::Text;
+    arg.offset = textSize;
+    std::memcpy(text + textSize, value.data(), value.size());
+    textSize += arg.size;
+  } else {
+    arg.type = LogArg::LongText;
+    arg.offset = static_cast<uint32_t>(longText.size());
+    longText.append(value);
+  }
+}
+
+} // namespace detail
+
+namespace {
+
+using detail::LogArg;
+using detail::LogRecord;
+
+// Records are handed from any number of converting threads to the single log
+// thread through a bounded queue (Vyukov's MPMC ring, used with a single
+// consumer): producers claim a cell with one CAS on the enqueue position and
+// publish it through the cell sequence number. When the queue is full the
+// producers yield until the log thread catches up, so no line is lost.
+class Logger
+{
+ public:
+  Logger() : cells(new Cell[kCapacity])
+  {
+    for (size_t i = 0; i < kCapacity; ++i)
+      cells[i].sequence.store(i, std::memory_order_relaxed);
+    thread = std::thread([this] { run(); });
+  }
+
+  ~Logger()
+  {
+    stopping.store(true, std::memory_order_release);
+    thread.join();
+  }
+
+  void push(LogRecord &&record)
+  {
+    size_t pos = enqueuePos.load(std::memory_order_relaxed);
+    Cell *cell;
+    for (;;) {
+      cell = &cells[pos & (kCapacity - 1)];
+      const size_t sequence = cell->sequence.load(std::memory_order_acquire);
+      const auto diff = static_cast<std::ptrdiff_t>(sequence)
+          - static_cast<std::ptrdiff_t>(pos);
+      if (diff == 0) {
+        if (enqueuePos.compare_exchange_weak(
+                pos, pos + 1, std::memory_order_relaxed))
+          break;
+      } else {
+        if (diff < 0)
+          std::this_thread::yield(); // full
+        pos = enqueuePos.load(std::memory_order_relaxed);
+      }
+    }
+    cell->record = std::move(record);
+    cell->sequence.store(pos + 1, std::memory_order_release);
+  }
+
+  void flush()
+  {
+    const size_t target = enqueuePos.load(std::memory_order_acquire);
+    while (written.load(std::memory_order_acquire) < target)
+      std::this_thread::sleep_for(std::chrono::microseconds(100));
+  }
+
+ private:
+  static constexpr size_t kCapacity = 1024; // power of two
+
+  struct Cell
+  {
+    std::atomic<size_t> sequence;
+    LogRecord record;
+  };
+
+  void run()
+  {
+    std::string buffer;
+    for (;;) {
+      // Read the flag first so records pushed before stopping are drained
+      const bool stop = stopping.load(std::memory_order_acquire);
+      size_t count = 0;
+      Cell *cell;
+      while ((cell = &cells[dequeuePos & (kCapacity - 1)])
+                 ->sequence.load(std::memory_order_acquire)
+          == dequeuePos + 1) {
+        format(cell->record, buffer);
+        cell->record.longText.clear();
+        cell->sequence.store(dequeuePos + kCapacity, std::memory_order_release);
+        ++dequeuePos;
+        ++count;
+      }
+      if (count > 0) {
+        std::cout.write(buffer.data(), buffer.size());
+        std::cout.flush();
+        buffer.clear();
+        written.fetch_add(count, std::memory_order_release);
+      } else if (stop) {
+        return;
+      } else {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+      }
+    }
+  }
+
+  static void format(const LogRecord &record, std::string &out)
+  {
+    char number[32];
+    int next = 0;
+    for (const char *c = record.format; *c; ++c) {
+      if (c[0] != '{' || c[1] != '}' || next == record.argCount) {
+        out.push_back(*c);
+        continue;
+      }
+      const LogArg &arg = record.args[next++];
+      ++c;
+      switch (arg.type) {
+      case LogArg::Int:
+        out.append(
+            number, std::to_chars(number, number + sizeof(number), arg.i).ptr);
+        break;
+      case LogArg::UInt:
+        out.append(
+            number, std::to_chars(number, number + sizeof(number), arg.u).ptr);
+        break;
+      case LogArg::Double:
+        // Same as the default formatting of std::ostream
+        out.append(number, std::snprintf(number, sizeof(number), "%g", arg.d));
+        break;
+      case LogArg::Text:
+        out.append(record.text + arg.offset, arg.size);
+        break;
+      case LogArg::LongText:
+        out.append(record.longText, arg.offset, arg.size);
+        break;
+      }
+    }
+    out.push_back('\n');
+  }
+
+  std::unique_ptr<Cell[]> cells;
+  alignas(64) std::atomic<size_t> enqueuePos{0};
+  alignas(64) size_t dequeuePos = 0; // log thread only
+  std::atomic<size_t> written{0};
+  std::atomic<bool> stopping{false};
+  std::thread thread;
+};
+
+Logger &getLogger()
+{
+  // Started on the first record, joined after main() returns
+  static Logger logger;
+  return logger;
+}
+
+} // namespace
+
+void setLogLevel(LogLevel level)
+{
+  detail::logLevel.store(static_cast<uint8_t>(level), std::memory_order_relaxed);
+}
+
+LogLevel getLogLevel()
+{
+  return static_cast<LogLevel>(detail::logLevel.load(std::memory_order_relaxed));
+}
+
+bool parseLogLevel(std::string_view name, LogLevel &level)
+{
+  if (name == "quiet")
+    level = LogLevel::Quiet;
+  else if (name == "info")
+    level = LogLevel::Info;
+  else if (name == "debug")
+    level = LogLevel::Debug;
+  else if (name == "trace")
+    level = LogLevel::Trace;
+  else
+    return false;
+  return true;
+}
+
+void flushLog()
+{
+  if (getLogLevel() != LogLevel::Quiet)
+    getLogger().flush();
+}
+
+void detail::pushLog(LogRecord &&record)
+{
+  getLogger().push(std::move(record));
+}
+
+} // namespace agx2usd
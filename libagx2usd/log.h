@@ -0,0 +1,150 @@
+// Copyright 2025
+// SPDX-License-Identifier: Apache-2.0
+
+// Leveled progress logging, formatted and written on a background thread
+
+#pragma once
+
+// std
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+namespace agx2usd {
+
+// Each level includes the ones before it. Errors are not logged but written
+// to std::cerr directly, so they are shown at every level.
+enum class LogLevel : uint8_t
+{
+  Quiet, // nothing
+  Info, // file summaries and progress of the phases (default)
+  Debug, // one line per timestep and attribute written
+  Trace // every parameter read and how it was converted
+};
+
+void setLogLevel(LogLevel level);
+LogLevel getLogLevel();
+
+// Parse "quiet", "info", "debug" or "trace"
+bool parseLogLevel(std::string_view name, LogLevel &level);
+
+// Block until every record logged so far has been written to std::cout
+void flushLog();
+
+namespace detail {
+
+inline std::atomic<uint8_t> logLevel{static_cast<uint8_t>(LogLevel::Info)};
+
+constexpr int kMaxLogArgs = 6;
+constexpr size_t kLogTextBytes = 96;
+
+struct LogArg
+{
+  enum Type : uint8_t
+  {
+    Int,
+    UInt,
+    Double,
+    Text, // [offset, offset + size) of LogRecord::text
+    LongText // [offset, offset + size) of LogRecord::longText
+  };
+
+  Type type;
+  uint32_t offset;
+  uint32_t size;
+  union
+  {
+    int64_t i;
+    uint64_t u;
+    double d;
+  };
+};
+
+// A format string with '{}' placeholders and the values to substitute. The
+// format must outlive the record (a string literal); text arguments are
+// copied inline, only text that does not fit in 'text' allocates.
+struct LogRecord
+{
+  const char *format = nullptr;
+  LogLevel level = LogLevel::Info;
+  uint8_t argCount = 0;
+  uint32_t textSize = 0;
+  LogArg args[kMaxLogArgs];
+  char text[kLogTextBytes];
+  std::string longText;
+
+  void add(std::string_view value);
+  void add(const char *value)
+  {
+    add(std::string_view(value ? value : ""));
+  }
+  void add(const std::string &value)
+  {
+    add(std::string_view(value));
+  }
+  template <typename T>
+  std::enable_if_t<std::is_arithmetic_v<T>> add(T value)
+  {
+    LogArg &arg = args[argCount++];
+    if constexpr (std::is_floating_point_v<T>) {
+      arg.type = LogArg::Double;
+      arg.d = static_cast<double>(value);
+    } else if constexpr (std::is_signed_v<T>) {
+      arg.type = LogArg::Int;
+      arg.i = static_cast<int64_t>(value);
+    } else {
+      arg.type = LogArg::UInt;
+      arg.u = static_cast<uint64_t>(value);
+    }
+  }
+};
+
+void pushLog(LogRecord &&record);
+
+} // namespace detail
+
+inline bool isLogEnabled(LogLevel level)
+{
+  return static_cast<uint8_t>(level)
+      <= detail::logLevel.load(std::memory_order_relaxed);
+}
+
+// Queue a line for the log thread, e.g.
+//   logDebug("  -> Set {} normals at time {}", count, timeCode);
+// Below the current level this is a single relaxed load. Otherwise the
+// arguments are copied into a fixed-size record pushed onto a lock-free
+// queue; formatting and writing happen on the log thread.
+template <typename... Args>
+void logAt(LogLevel level, const char *format, const Args &...args)
+{
+  static_assert(sizeof...(Args) <= detail::kMaxLogArgs, "too many arguments");
+  if (!isLogEnabled(level))
+    return;
+  detail::LogRecord record;
+  record.format = format;
+  record.level = level;
+  (record.add(args), ...);
+  detail::pushLog(std::move(record));
+}
+
+template <typename... Args>
+void logInfo(const char *format, const Args &...args)
+{
+  logAt(LogLevel::Info, format, args...);
+}
+
+template <typename... Args>
+void logDebug(const char *format, const Args &...args)
+{
+  logAt(LogLevel::Debug, format, args...);
+}
+
+template <typename... Args>
+void logTrace(const char *format, const Args &...args)
+{
+  logAt(LogLevel::Trace, format, args...);
+}
+
+} // namespace agx2usd
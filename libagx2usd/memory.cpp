@@ -0,0 +1,203 @@
+// Copyright 2025
+// SPDX-License-Identifier: Apache-2.0
+
+#include "memory.h"
+
+// std
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+
+namespace agx2usd {
+
+ProcessMemory readProcessMemory()
+{
+  ProcessMemory memory;
+  std::ifstream status("/proc/self/status");
+  std::string line;
+  while (std::getline(status, line)) {
+    // Lines look like "VmRSS:     123456 kB"
+    uint64_t *target = nullptr;
+    if (line.compare(0, 6, "VmRSS:") == 0)
+      target = &memory.residentBytes;
+    else if (line.compare(0, 6, "VmHWM:") == 0)
+      target = &memory.peakResidentBytes;
+    if (target)
+      *target = std::strtoull(line.c_str() + 6, nullptr, 10) * 1024;
+  }
+  return memory;
+}
+
+bool parseByteSize(const std::string &text, uint64_t &bytes)
+{
+  char *end = nullptr;
+  const double value = std::strtod(text.c_str(), &end);
+  if (end == text.c_str() || !(value > 0.0))
+    return false;
+
+  double scale = 1.0;
+  switch (*end) {
+  case '\0':
+    break;
+  case 'k':
+  case 'K':
+    scale = 1024.0;
+    break;
+  case 'm':
+  case 'M':
+    scale = 1024.0 * 1024.0;
+    break;
+  case 'g':
+  case 'G':
+    scale = 1024.0 * 1024.0 * 1024.0;
+    break;
+  case 't':
+  case 'T':
+    scale = 1024.0 * 1024.0 * 1024.0 * 1024.0;
+    break;
+  default:
+    return false;
+  }
+  if (*end != '\0' && end[1] != '\0' && !(end[1] == 'B' && end[2] == '\0'))
+    return false;
+
+  bytes = static_cast<uint64_t>(value * scale);
+  return true;
+}
+
+std::string formatBytes(uint64_t bytes)
+{
+  const char *units[] = {"B", "KiB", "MiB", "GiB", "TiB"};
+  double value = static_cast<double>(bytes);
+  int unit = 0;
+  while (value >= 1024.0 && unit < 4) {
+    value /= 1024.0;
+    ++unit;
+  }
+  char text[32];
+  std::snprintf(text, sizeof(text), unit == 0 ? "%.0f %s" : "%.1f %s",
+      value, units[unit]);
+  return text;
+}
+
+namespace {
+
+// Whether 'residentBytes' after 'samples' of 'timeSteps' timesteps exceeds
+// 'limitBytes', now or by the end; reports it if so
+bool exceedsLimit(uint64_t limitBytes,
+    uint64_t residentBytes,
+    uint64_t firstResidentBytes,
+    uint64_t samples,
+    uint64_t timeSteps)
+{
+  if (residentBytes > limitBytes) {
+    std::cerr << "Error: Memory use " << formatBytes(residentBytes)
+              << " exceeds the limit of " << formatBytes(limitBytes) << "\n";
+    return true;
+  }
+
+  // The layer keeps every sample until it is saved, so memory grows roughly
+  // linearly with the timesteps converted. The rate is only trusted after a
+  // few timesteps (2% of them), past the allocations of the first ones.
+  const uint64_t minSamples = std::max<uint64_t>(4, timeSteps / 50);
+  if (samples >= minSamples && samples < timeSteps
+      && residentBytes > firstResidentBytes) {
+    const double growth =
+        double(residentBytes - firstResidentBytes) / (samples - 1);
+    const double projected = residentBytes + growth * (timeSteps - samples);
+    if (projected > static_cast<double>(limitBytes)) {
+      std::cerr << "Error: Memory use " << formatBytes(residentBytes)
+                << " after " << samples << " of " << timeSteps
+                << " timesteps is growing by " << formatBytes(uint64_t(growth))
+                << " per timestep and would reach about "
+                << formatBytes(uint64_t(projected)) << ", above the limit of "
+                << formatBytes(limitBytes) << "\n";
+      return true;
+    }
+  }
+  return false;
+}
+
+} // namespace
+
+MemoryTracker::MemoryTracker(
+    uint64_t limitBytes, uint32_t timeSteps, bool report)
+    : limitBytes(limitBytes), timeSteps(timeSteps), reportEnabled(report)
+{}
+
+bool MemoryTracker::isActive() const
+{
+  return limitBytes > 0 || reportEnabled;
+}
+
+bool MemoryTracker::sample(
+    uint64_t agxBytes, uint64_t bufferBytes, uint64_t newLayerBytes)
+{
+  peakAgxBytes = std::max(peakAgxBytes, agxBytes);
+  peakBufferBytes = std::max(peakBufferBytes, bufferBytes);
+  layerBytes = newLayerBytes;
+  if (limitBytes == 0)
+    return true;
+
+  const ProcessMemory process = readProcessMemory();
+  if (samples++ == 0)
+    firstResidentBytes = process.residentBytes;
+  return process.residentBytes == 0
+      || !exceedsLimit(limitBytes,
+          process.residentBytes,
+          firstResidentBytes,
+          samples,
+          timeSteps);
+}
+
+SceneMemoryLimit::SceneMemoryLimit(uint64_t limitBytes)
+    : limitBytes(limitBytes)
+{}
+
+void SceneMemoryLimit::addTimeSteps(uint32_t steps)
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  timeSteps += steps;
+}
+
+bool SceneMemoryLimit::sample()
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  if (exceeded)
+    return false;
+
+  const ProcessMemory process = readProcessMemory();
+  if (samples++ == 0)
+    firstResidentBytes = process.residentBytes;
+  exceeded = process.residentBytes > 0
+      && exceedsLimit(limitBytes,
+          process.residentBytes,
+          firstResidentBytes,
+          samples,
+          timeSteps);
+  return !exceeded;
+}
+
+void MemoryTracker::setLayerBytes(uint64_t bytes)
+{
+  layerBytes = bytes;
+}
+
+void MemoryTracker::report(std::ostream &out) const
+{
+  const ProcessMemory process = readProcessMemory();
+  out << "Memory:\n";
+  if (process.peakResidentBytes > 0) {
+    out << "  Process RSS:         " << formatBytes(process.residentBytes)
+        << " (peak " << formatBytes(process.peakResidentBytes) << ")\n";
+  }
+  out << "  AGX timestep data:   " << formatBytes(peakAgxBytes)
+      << " (largest timestep)\n";
+  out << "  Converter buffers:   " << formatBytes(peakBufferBytes)
+      << " (peak)\n";
+  out << "  USD layer (est.):    " << formatBytes(layerBytes) << "\n";
+}
+
+} // namespace agx2usd
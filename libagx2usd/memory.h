@@ -0,0 +1,114 @@
+// Copyright 2025
+// SPDX-License-Identifier: Apache-2.0
+
+// Memory accounting of a conversion: process RSS, converter buffers and the
+// estimated size of the data handed to the USD layer
+
+#pragma once
+
+// USD
+#include <pxr/pxr.h>
+#include <pxr/base/vt/array.h>
+
+// std
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace agx2usd {
+
+PXR_NAMESPACE_USING_DIRECTIVE
+
+// Resident set size and its high-water mark, from /proc/self/status. Both
+// are 0 where that is not available.
+struct ProcessMemory
+{
+  uint64_t residentBytes = 0;
+  uint64_t peakResidentBytes = 0;
+};
+
+ProcessMemory readProcessMemory();
+
+// "1536", "512K", "800M", "16G" (powers of 1024). Returns false on errors.
+bool parseByteSize(const std::string &text, uint64_t &bytes);
+
+std::string formatBytes(uint64_t bytes);
+
+template <typename T>
+size_t arrayBytes(const VtArray<T> &values)
+{
+  return values.size() * sizeof(T);
+}
+
+template <typename T>
+size_t arrayBytes(const std::vector<T> &values)
+{
+  return values.capacity() * sizeof(T);
+}
+
+// Sampled at every timestep boundary. With a limit, sample() fails as soon as
+// the resident size exceeds it, or when the growth per timestep so far
+// projects past it before the last timestep, so a job that is going to run
+// out of memory stops early instead of being killed by the kernel at the end.
+// The resident size is only read with a limit; 'report' keeps the peaks for
+// report(). Without either, the tracker is inactive and need not be sampled.
+class MemoryTracker
+{
+ public:
+  MemoryTracker(uint64_t limitBytes, uint32_t timeSteps, bool report);
+
+  bool isActive() const;
+
+  // 'agxBytes' is the parameter data the reader returned for the timestep,
+  // 'bufferBytes' what the converter holds, 'layerBytes' the estimated total
+  // handed to the USD layer. Returns false if the limit is or will be hit.
+  bool sample(uint64_t agxBytes, uint64_t bufferBytes, uint64_t layerBytes);
+
+  // Estimated layer size after the last timestep, e.g. once held back
+  // values have been authored
+  void setLayerBytes(uint64_t bytes);
+
+  // Resident size at the time of the report and the sampled peaks
+  void report(std::ostream &out) const;
+
+ private:
+  uint64_t limitBytes;
+  uint32_t timeSteps;
+  bool reportEnabled;
+  uint32_t samples = 0;
+  uint64_t firstResidentBytes = 0;
+  uint64_t peakAgxBytes = 0;
+  uint64_t peakBufferBytes = 0;
+  uint64_t layerBytes = 0;
+};
+
+// The limit of a scene, whose objects are converted concurrently and share
+// the resident size of the process: one tracker over the timesteps of all
+// objects, instead of per-object trackers that would each attribute the
+// growth of the others to themselves. Thread-safe.
+class SceneMemoryLimit
+{
+ public:
+  explicit SceneMemoryLimit(uint64_t limitBytes);
+
+  // An object with 'timeSteps' timesteps starts converting. The projection
+  // covers the objects started so far.
+  void addTimeSteps(uint32_t timeSteps);
+
+  // After every timestep of every object. Returns false once the limit is
+  // or will be hit, from then on for every object.
+  bool sample();
+
+ private:
+  std::mutex mutex;
+  uint64_t limitBytes;
+  uint64_t timeSteps = 0;
+  uint64_t samples = 0;
+  uint64_t firstResidentBytes = 0;
+  bool exceeded = false;
+};
+
+} // namespace agx2usd
@@ -0,0 +1,744 @@
+// Copyright 2025
+// SPDX-License-Identifier: Apache-2.0
+
+#include "mesh_writer.h"
+#include "agx2usd_decode.h"
+#include "log.h"
+#include "memory.h"
+#include "parallel.h"
+#include "trace.h"
+
+// USD
+#include <pxr/usd/usd/editContext.h>
+#include <pxr/usd/usd/variantSets.h>
+#include <pxr/usd/usdGeom/primvarsAPI.h>
+#include <pxr/base/gf/matrix4d.h>
+
+// std
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <string_view>
+#include <type_traits>
+
+namespace agx2usd {
+
+namespace {
+
+// Helper to view the parameter name without copying it
+std::string_view getParamName(const AGXParamView &pv)
+{
+  return std::string_view(pv.name, pv.nameLength);
+}
+
+// The first frame is also written (dequantized) as the default value of
+// 'points' so generic viewers still see the rest shape and extent.
+void setQuantizedPoints(UsdGeomMesh &mesh,
+    AttributeCache &cache,
+    const QuantizedPoints &quantized,
+    double timeCode,
+    bool firstFrame)
+{
+  if (firstFrame) {
+    UsdPrim prim = mesh.GetPrim();
+    cache.quantizedPoints = prim.CreateAttribute(
+        TfToken("agx:quantizedPoints"), SdfValueTypeNames->UIntArray);
+    cache.quantizedPointsBounds = prim.CreateAttribute(
+        TfToken("agx:quantizedPointsBounds"), SdfValueTypeNames->Float3Array);
+  }
+  cache.quantizedPoints.Set(quantized.values, timeCode);
+  cache.quantizedPointsBounds.Set(quantized.bounds, timeCode);
+
+  if (firstFrame) {
+    const float bounds[6] = {quantized.bounds[0][0],
+        quantized.bounds[0][1],
+        quantized.bounds[0][2],
+        quantized.bounds[1][0],
+        quantized.bounds[1][1],
+        quantized.bounds[1][2]};
+    VtArray<GfVec3f> rest(quantized.values.size() / 3);
+    agx2usd::decodeQuantizedPoints(
+        quantized.values.cdata(), rest.size(), bounds, rest.data()->data());
+    mesh.GetPointsAttr().Set(rest);
+  }
+}
+
+} // namespace
+
+bool makeAttributeSample(
+    const AGXParamView &pv, const TfToken &name, PrimvarSample &sample)
+{
+  if (!pv.isArray)
+    return false;
+
+  sample.name = name;
+  sample.count = pv.elementCount;
+
+  // Handle different attribute types
+  if (pv.elementType == ANARI_FLOAT32) {
+    // Scalar attribute (e.g., for color mapping)
+    sample.type = SdfValueTypeNames->FloatArray;
+    sample.value = convertFloatArray<float>(pv.data, pv.elementCount);
+    sample.description = "scalar attribute0";
+  }
+  else if (pv.elementType == ANARI_FLOAT32_VEC2) {
+    // Vec2 attribute (e.g., UVs)
+    sample.type = SdfValueTypeNames->Float2Array;
+    sample.value = convertFloatArray<GfVec2f>(pv.data, pv.elementCount);
+    sample.description = "vec2 attribute0";
+  }
+  else if (pv.elementType == ANARI_FLOAT32_VEC3) {
+    // Vec3 attribute (e.g., colors)
+    sample.type = SdfValueTypeNames->Float3Array;
+    sample.value = convertFloatArray<GfVec3f>(pv.data, pv.elementCount);
+    sample.description = "vec3 attribute0";
+  }
+  else if (pv.elementType == ANARI_FLOAT32_VEC4) {
+    // Vec4 attribute (e.g., RGBA colors)
+    sample.type = SdfValueTypeNames->Float4Array;
+    sample.value = convertFloatArray<GfVec4f>(pv.data, pv.elementCount);
+    sample.description = "vec4 attribute0";
+  }
+  else {
+    return false;
+  }
+  return true;
+}
+
+UsdGeomPrimvar AttributeCache::getPrimvar(const UsdGeomImageable &geom,
+    const TfToken &name,
+    const SdfValueTypeName &type)
+{
+  for (size_t i = 0; i < primvarKeys.size(); ++i) {
+    if (primvarKeys[i].first == name && primvarKeys[i].second == type)
+      return primvars[i];
+  }
+  UsdGeomPrimvarsAPI primvarsAPI(geom);
+  primvars.push_back(
+      primvarsAPI.CreatePrimvar(name, type, UsdGeomTokens->vertex));
+  primvarKeys.emplace_back(name, type);
+  return primvars.back();
+}
+
+void TimeStepData::reset(bool pointsRetained, bool normalsRetained)
+{
+  if (pointsRetained || !hasPoints)
+    points = VtArray<GfVec3f>();
+  if (normalsRetained || !hasNormals)
+    normals = VtArray<GfVec3f>();
+  hasPoints = false;
+  hasNormals = false;
+  hasIndices = false;
+  indices = VtArray<int>();
+  quantizedPoints = QuantizedPoints();
+  octNormals16 = VtArray<unsigned int>();
+  octNormals8 = VtArray<unsigned char>();
+  primvars.clear(); // keeps capacity
+}
+
+MeshWriter::MeshWriter(const UsdStageRefPtr &stage,
+    const SdfPath &path,
+    const ConvertOptions &options)
+    : options(options),
+      mesh(UsdGeomMesh::Define(stage, path)),
+      baseTarget(stage->GetEditTarget()),
+      meshTarget(baseTarget),
+      pointsEncoder("points", options.deltaKeyInterval, options.deltaPrecision),
+      normalsEncoder("normals", options.deltaKeyInterval, options.deltaPrecision),
+      octNormalsToken("agx:octNormals"),
+      attribute0Token("attribute0"),
+      stToken("st"),
+      rigidCandidate(options.rigidTolerance > 0.f)
+{
+  if (!options.lodRatios.empty())
+    setupLods(path);
+}
+
+// Variant edit targets are direct, so every variant can be authored without
+// changing the selection (which would recompose the prim each time)
+void MeshWriter::setupLods(const SdfPath &path)
+{
+  const SdfLayerHandle &layer = baseTarget.GetLayer();
+  UsdVariantSet variantSet =
+      mesh.GetPrim().GetVariantSets().AddVariantSet("lod");
+
+  variantSet.AddVariant("full");
+  meshTarget = UsdEditTarget::ForLocalDirectVariant(
+      layer, path.AppendVariantSelection("lod", "full"));
+
+  for (size_t i = 0; i < options.lodRatios.size(); ++i) {
+    const std::string name = "lod" + std::to_string(i + 1);
+    variantSet.AddVariant(name);
+    LodLevel lod;
+    lod.ratio = options.lodRatios[i];
+    lod.editTarget = UsdEditTarget::ForLocalDirectVariant(
+        layer, path.AppendVariantSelection("lod", name));
+    lods.push_back(std::move(lod));
+  }
+  variantSet.SetVariantSelection("full");
+}
+
+void MeshWriter::setConstant(const AGXParamView &pv)
+{
+  UsdEditContext context(mesh.GetPrim().GetStage(), meshTarget);
+
+  std::string paramName(getParamName(pv));
+  if (!pv.isArray) {
+    logDebug("  {} (scalar, type={})", paramName, anari::toString(pv.type));
+  } else {
+    logDebug("  {} (array, type={}, count={})",
+        paramName,
+        anari::toString(pv.elementType),
+        pv.elementCount);
+    
+    // Store array data for later use
+    std::vector<uint8_t> data(pv.dataBytes);
+    std::memcpy(data.data(), pv.data, pv.dataBytes);
+    constants[paramName] = std::move(data);
+
+    // Handle indices specially (topology is often constant)
+    if (paramName == "primitive.index" || paramName == "index" || 
+        paramName == "primitive.indices" || paramName == "indices") {
+      
+      if (pv.elementType == ANARI_UINT32_VEC3 || pv.elementType == ANARI_UINT32) {
+        size_t numIndices = pv.dataBytes / sizeof(uint32_t);
+        VtArray<int> indices = convertIndices(pv.data, numIndices);
+        if (options.optimizeVertexOrder) {
+          reorder.compute(indices);
+          if (reorder.isValid()) {
+            indices = reorder.getIndices();
+            logDebug("    -> Optimized triangle and vertex order");
+          }
+        }
+        
+        mesh.GetFaceVertexIndicesAttr().Set(indices);
+        layerBytes += arrayBytes(indices);
+        
+        // If these are triangle indices, set face vertex counts
+        if (pv.elementType == ANARI_UINT32_VEC3 || (numIndices % 3 == 0)) {
+          topology = indices;
+          lodsStale = true;
+          lodTopologyTime = UsdTimeCode::Default();
+          size_t numFaces = numIndices / 3;
+          VtArray<int> faceCounts(numFaces, 3);
+          mesh.GetFaceVertexCountsAttr().Set(faceCounts);
+          layerBytes += arrayBytes(faceCounts);
+          logDebug("    -> Set as mesh topology ({} triangles)", numFaces);
+        }
+      }
+    }
+  }
+}
+
+void MeshWriter::beginTimeStep(double time)
+{
+  timeCode = time;
+  if (firstTimeStep) {
+    firstTimeCode = time;
+    firstTimeStep = false;
+  }
+}
+
+void MeshWriter::setTimeStepParam(const AGXParamView &pv)
+{
+  std::string_view paramName = getParamName(pv);
+  
+  // Handle vertex positions
+  if (isPositionParam(paramName)) {
+    
+    if (pv.isArray && pv.elementType == ANARI_FLOAT32_VEC3) {
+      convertFloatArray(pv.data, pv.elementCount, step.points);
+      step.hasPoints = true;
+    }
+  }
+  // Handle normals
+  else if (paramName == "vertex.normal" || paramName == "normal" || 
+           paramName == "vertex.normals" || paramName == "normals") {
+    
+    if (pv.isArray && pv.elementType == ANARI_FLOAT32_VEC3) {
+      convertFloatArray(pv.data, pv.elementCount, step.normals);
+      step.hasNormals = true;
+    }
+  }
+  // Handle vertex.attribute0 as primvar (for shading/coloring)
+  else if (paramName == "vertex.attribute0" || paramName == "attribute0") {
+    
+    PrimvarSample sample;
+    if (makeAttributeSample(pv, attribute0Token, sample))
+      step.primvars.push_back(std::move(sample));
+  }
+  // Handle UVs (separate from attribute0)
+  else if (paramName == "uv" || paramName == "vertex.uv" || paramName == "texcoord") {
+    
+    if (pv.isArray && pv.elementType == ANARI_FLOAT32_VEC2) {
+      PrimvarSample sample;
+      sample.name = stToken;
+      sample.type = SdfValueTypeNames->Float2Array;
+      sample.value = convertFloatArray<GfVec2f>(pv.data, pv.elementCount);
+      sample.description = "UVs";
+      sample.count = pv.elementCount;
+      step.primvars.push_back(std::move(sample));
+    }
+  }
+  // Handle triangle indices (topology can change per timestep)
+  else if (paramName == "primitive.index" || paramName == "index" || 
+           paramName == "primitive.indices" || paramName == "indices") {
+    
+    if (pv.isArray && pv.elementType == ANARI_UINT32_VEC3) {
+      // VEC3 = 3 indices per triangle
+      step.indices = convertIndices(pv.data, pv.elementCount * 3);
+      step.hasIndices = true;
+    }
+  }
+  // Handle generic time parameter
+  else if (paramName == "time") {
+    if (!pv.isArray && pv.elementType == ANARI_UNKNOWN) {
+      // Single value - might be useful for custom attributes
+      logTrace("  -> Time value parameter");
+    }
+  }
+  // Handle other arrays as custom primvars
+  else if (pv.isArray) {
+    logTrace("  -> Custom array: {} (type={}, count={})",
+        paramName,
+        anari::toString(pv.elementType),
+        pv.elementCount);
+    
+    // Could add custom primvars here for other attributes
+  }
+}
+
+void MeshWriter::endTimeStep()
+{
+  UsdEditContext context(mesh.GetPrim().GetStage(), meshTarget);
+
+  if (options.optimizeVertexOrder && !vertexOrderStopped)
+    applyVertexOrder();
+
+  // Hold back positions that are a rigid transform of the first frame. The
+  // first frame that is not ends the detection, and the frames held back so
+  // far are written as ordinary positions before it.
+  if (rigidCandidate && step.hasPoints) {
+    TraceSpan span("fit rigid");
+    const float *points = step.points.cdata()->data();
+    RigidTransform transform;
+    if (rigidFrames.empty()) {
+      rigidFitter.setReference(points, step.points.size());
+      rigidRest = step.points;
+      if (step.hasNormals && step.normals.size() == step.points.size())
+        rigidRestNormals = step.normals;
+      rigidFrames.emplace_back(timeCode, transform);
+      step.hasPoints = false;
+      step.hasNormals = false;
+    } else if (rigidFitter.fit(points,
+                   step.points.size(),
+                   options.rigidTolerance,
+                   transform)) {
+      rigidFrames.emplace_back(timeCode, transform);
+      step.hasPoints = false;
+      step.hasNormals = false;
+    } else {
+      logDebug("  -> Motion is not rigid at time {}", timeCode);
+      flushRigidFrames();
+    }
+  }
+
+  writeTimeStep();
+}
+
+// Bring the timestep into the optimized order. The order is only recomputed
+// when the indices change, so for constant topology every frame costs one
+// gather per vertex array.
+void MeshWriter::applyVertexOrder()
+{
+  if (step.hasIndices) {
+    if (!reorder.isValid() || !(step.indices == reorder.getSourceIndices()))
+      reorder.compute(step.indices);
+    if (reorder.isValid())
+      step.indices = reorder.getIndices();
+  }
+  if (!reorder.isValid())
+    return;
+
+  // Positions or normals that do not cover every indexed vertex cannot be
+  // brought into the order along with the indices
+  const size_t count = reorder.getVertexCount();
+  const size_t shortest = std::min(
+      step.hasPoints ? step.points.size() : count,
+      step.hasNormals ? step.normals.size() : count);
+  if (shortest < count) {
+    std::cerr << "Warning: " << shortest << " positions or normals at time "
+              << timeCode << " for indices of " << count
+              << " vertices, vertex order optimization is off from here on\n";
+    stopVertexOrder();
+    return;
+  }
+
+  if (step.hasPoints)
+    reorder.apply(step.points);
+  if (step.hasNormals)
+    reorder.apply(step.normals);
+  // Smaller primvars are not per vertex and keep their order
+  for (auto &sample : step.primvars)
+    std::visit([&](auto &values) { reorder.apply(values); }, sample.value);
+}
+
+// Write the input order from the current timestep on. Earlier frames keep
+// the optimized one: if it is only the default value so far, it also becomes
+// a time sample at the first frame, as the sample of the input order would
+// hold for the frames before it too.
+void MeshWriter::stopVertexOrder()
+{
+  if (!topologySampled && timeCode != firstTimeCode && !topology.empty()) {
+    const UsdTimeCode firstTime(firstTimeCode);
+    mesh.GetFaceVertexIndicesAttr().Set(topology, firstTime);
+    mesh.GetFaceVertexCountsAttr().Set(
+        VtArray<int>(topology.size() / 3, 3), firstTime);
+    layerBytes += arrayBytes(topology) + topology.size() / 3 * sizeof(int);
+  }
+  step.indices = reorder.getSourceIndices();
+  step.hasIndices = true;
+  reorder = VertexReorder();
+  vertexOrderStopped = true;
+}
+
+// Write the held back frames as positions reconstructed from their
+// transforms, in order, ahead of the current timestep
+void MeshWriter::flushRigidFrames()
+{
+  rigidCandidate = false;
+
+  TimeStepData current = std::move(step);
+  const double currentTimeCode = timeCode;
+  for (const auto &[time, transform] : rigidFrames) {
+    step = TimeStepData();
+    step.points.resize(rigidFitter.size());
+    rigidFitter.apply(transform, step.points.data()->data());
+    step.hasPoints = true;
+    if (!rigidRestNormals.empty()) {
+      step.normals.resize(rigidRestNormals.size());
+      rotateVectors(transform,
+          rigidRestNormals.cdata()->data(),
+          rigidRestNormals.size(),
+          step.normals.data()->data());
+      step.hasNormals = true;
+    }
+    timeCode = time;
+    writeTimeStep();
+  }
+  step = std::move(current);
+  timeCode = currentTimeCode;
+
+  rigidFrames.clear();
+  rigidRest = VtArray<GfVec3f>();
+  rigidRestNormals = VtArray<GfVec3f>();
+}
+
+void MeshWriter::finish()
+{
+  if (!rigidCandidate || rigidFrames.empty())
+    return;
+
+  // The first frame becomes the static shape, each frame's transform a
+  // sample of a matrix op (USD uses row vectors: p' = p * M)
+  const UsdStagePtr stage = mesh.GetPrim().GetStage();
+  TimeStepData rest;
+  rest.points = rigidRest;
+  rest.hasPoints = true;
+  // The normals of the first frame are in the rest pose, like its points
+  if (!rigidRestNormals.empty()) {
+    rest.normals = rigidRestNormals;
+    rest.hasNormals = true;
+  } else if (options.computeNormals) {
+    rest.hasNormals = normalGenerator.compute(rigidRest, topology, rest.normals);
+  }
+  {
+    UsdEditContext context(stage, meshTarget);
+    mesh.GetPointsAttr().Set(rest.points);
+    layerBytes += arrayBytes(rest.points);
+    if (rest.hasNormals) {
+      mesh.GetNormalsAttr().Set(rest.normals);
+      layerBytes += arrayBytes(rest.normals);
+      mesh.SetNormalsInterpolation(UsdGeomTokens->vertex);
+    }
+  }
+  if (!lods.empty())
+    writeLods(rest, UsdTimeCode::Default());
+
+  // The transform is shared by all levels of detail
+  UsdEditContext context(stage, baseTarget);
+  auto transformOp = mesh.AddTransformOp();
+  for (const auto &[time, transform] : rigidFrames) {
+    GfMatrix4d matrix(1.0);
+    for (int r = 0; r < 3; ++r) {
+      for (int c = 0; c < 3; ++c)
+        matrix[c][r] = transform.rotation[r][c];
+      matrix[3][r] = transform.translation[r];
+    }
+    transformOp.Set(matrix, time);
+    layerBytes += sizeof(matrix);
+  }
+  logInfo("  -> Rigid motion: {} static vertex positions and {} transforms",
+      rigidRest.size(),
+      rigidFrames.size());
+
+  rigidFrames.clear();
+}
+
+void MeshWriter::writeTimeStep()
+{
+  if (step.hasIndices) {
+    if (!(step.indices == topology)) {
+      lodsStale = true;
+      lodTopologyTime = UsdTimeCode(timeCode);
+    }
+    topology = step.indices;
+  }
+
+  // Generate normals for captures that have none
+  if (options.computeNormals && step.hasPoints && !step.hasNormals
+      && !topology.empty()) {
+    TraceSpan span("compute normals");
+    step.hasNormals =
+        normalGenerator.compute(step.points, topology, step.normals);
+    if (!step.hasNormals)
+      std::cerr << "Warning: Invalid indices, no normals at time " << timeCode
+                << "\n";
+  }
+
+  // Levels of detail are written from the values before encoding
+  if (!lods.empty())
+    writeLods(step, UsdTimeCode(timeCode));
+
+  // Encode positions and normals concurrently; they share no state
+  {
+    TraceSpan span("encode");
+    TaskGroup encodeTasks;
+    if (step.hasPoints) {
+      encodeTasks.run([&]() {
+        if (options.positionPrecision > 0.f)
+          snapToGrid(step.points, options.positionPrecision);
+        if (options.quantizePositions)
+          step.quantizedPoints = quantizePoints(step.points);
+        else if (options.deltaKeyInterval > 0)
+          pointsEncoder.encode(step.points);
+      });
+    }
+    if (step.hasNormals && options.octNormalBits == 16) {
+      encodeTasks.run(
+          [&]() { encodeOctNormals16(step.normals, step.octNormals16); });
+    } else if (step.hasNormals && options.octNormalBits == 8) {
+      encodeTasks.run(
+          [&]() { encodeOctNormals8(step.normals, step.octNormals8); });
+    } else if (step.hasNormals && options.deltaKeyInterval > 0) {
+      encodeTasks.run([&]() { normalsEncoder.encode(step.normals); });
+    }
+    encodeTasks.wait();
+  }
+
+  // Author the converted values
+  TraceSpan span("write");
+  if (step.hasPoints) {
+    const size_t numVerts = step.points.size();
+    if (options.quantizePositions) {
+      setQuantizedPoints(
+          mesh, attributeCache, step.quantizedPoints, timeCode, firstPositions);
+      layerBytes += arrayBytes(step.quantizedPoints.values)
+          + arrayBytes(step.quantizedPoints.bounds)
+          + (firstPositions ? arrayBytes(step.points) : 0);
+      logDebug("  -> Set {} quantized vertex positions at time {}",
+          numVerts,
+          timeCode);
+    } else if (options.deltaKeyInterval > 0) {
+      pointsEncoder.author(
+          mesh.GetPrim(), mesh.GetPointsAttr(), step.points, timeCode);
+      layerBytes += pointsEncoder.keyframe ? arrayBytes(step.points)
+                                           : arrayBytes(pointsEncoder.deltas);
+      logDebug("  -> Set {} vertex positions ({}) at time {}",
+          numVerts,
+          pointsEncoder.keyframe ? "keyframe" : "delta",
+          timeCode);
+    } else {
+      mesh.GetPointsAttr().Set(step.points, timeCode);
+      layerBytes += arrayBytes(step.points);
+      logDebug("  -> Set {} vertex positions at time {}", numVerts, timeCode);
+    }
+    firstPositions = false;
+  }
+
+  // Octahedral normals are only written as their primvar; the first frame is
+  // also the default value of 'normals', for viewers that do not decode them
+  bool normalsRetained = false;
+  if (step.hasNormals && options.octNormalBits > 0) {
+    const bool wide = options.octNormalBits == 16;
+    UsdGeomPrimvar primvar = attributeCache.getPrimvar(mesh,
+        octNormalsToken,
+        wide ? SdfValueTypeNames->UIntArray : SdfValueTypeNames->UCharArray);
+    if (wide)
+      primvar.Set(step.octNormals16, timeCode);
+    else
+      primvar.Set(step.octNormals8, timeCode);
+    layerBytes +=
+        wide ? arrayBytes(step.octNormals16) : arrayBytes(step.octNormals8);
+    if (!attributeCache.normalsInterpolationSet) {
+      if (!wide)
+        primvar.SetElementSize(2);
+      mesh.GetNormalsAttr().Set(step.normals);
+      layerBytes += arrayBytes(step.normals);
+      mesh.SetNormalsInterpolation(UsdGeomTokens->vertex);
+      attributeCache.normalsInterpolationSet = true;
+      normalsRetained = true;
+    }
+    logDebug("  -> Set {} octahedral normals at time {}",
+        step.normals.size(),
+        timeCode);
+  } else if (step.hasNormals) {
+    auto normalsAttr = mesh.GetNormalsAttr();
+    if (options.deltaKeyInterval > 0)
+      normalsEncoder.author(mesh.GetPrim(), normalsAttr, step.normals, timeCode);
+    else
+      normalsAttr.Set(step.normals, timeCode);
+    normalsRetained = options.deltaKeyInterval == 0 || normalsEncoder.keyframe;
+    layerBytes += normalsRetained ? arrayBytes(step.normals)
+                                  : arrayBytes(normalsEncoder.deltas);
+    if (!attributeCache.normalsInterpolationSet) {
+      mesh.SetNormalsInterpolation(UsdGeomTokens->vertex);
+      attributeCache.normalsInterpolationSet = true;
+    }
+    logDebug("  -> Set {} normals at time {}", step.normals.size(), timeCode);
+  }
+
+  for (const auto &sample : step.primvars) {
+    auto primvar = attributeCache.getPrimvar(mesh, sample.name, sample.type);
+    std::visit(
+        [&](const auto &values) {
+          primvar.Set(values, timeCode);
+          layerBytes += arrayBytes(values);
+        },
+        sample.value);
+    logDebug("  -> Set {} ({} values) at time {}",
+        sample.description,
+        sample.count,
+        timeCode);
+  }
+
+  if (step.hasIndices) {
+    mesh.GetFaceVertexIndicesAttr().Set(step.indices, timeCode);
+    topologySampled = true;
+    
+    // Set face vertex counts (all triangles = 3 vertices each)
+    size_t numFaces = step.indices.size() / 3;
+    VtArray<int> faceCounts(numFaces, 3);
+    mesh.GetFaceVertexCountsAttr().Set(faceCounts, timeCode);
+    layerBytes += arrayBytes(step.indices) + arrayBytes(faceCounts);
+    
+    logDebug("  -> Set mesh topology ({} triangles) at time {}",
+        numFaces,
+        timeCode);
+  }
+
+  // Points and normals reach the layer unless they were only the input of
+  // an encoding; only the latter can be refilled next frame
+  const bool pointsRetained = !options.quantizePositions
+      && (options.deltaKeyInterval == 0 || pointsEncoder.keyframe);
+  step.reset(pointsRetained, normalsRetained);
+}
+
+// Simplification happens once per topology, on the first frame that has
+// positions for it. Every frame then only gathers its per-vertex values
+// through the vertex map of each level.
+void MeshWriter::writeLods(const TimeStepData &data, UsdTimeCode time)
+{
+  const UsdStagePtr stage = mesh.GetPrim().GetStage();
+
+  if (lodsStale && data.hasPoints && !topology.empty()) {
+    TraceSpan span("simplify");
+    const size_t numFaces = topology.size() / 3;
+    parallelForEach(lods.size(), [&](size_t i) {
+      const auto target = static_cast<size_t>(numFaces * lods[i].ratio);
+      lods[i].simplifier.compute(data.points, topology, target);
+    });
+
+    for (size_t i = 0; i < lods.size(); ++i) {
+      LodLevel &lod = lods[i];
+      if (!lod.simplifier.isValid()) {
+        std::cerr << "Warning: Invalid indices, no level of detail " << i + 1
+                  << "\n";
+        continue;
+      }
+      UsdEditContext context(stage, lod.editTarget);
+      const VtArray<int> &indices = lod.simplifier.getIndices();
+      const size_t numLodFaces = indices.size() / 3;
+      mesh.GetFaceVertexIndicesAttr().Set(indices, lodTopologyTime);
+      mesh.GetFaceVertexCountsAttr().Set(
+          VtArray<int>(numLodFaces, 3), lodTopologyTime);
+      layerBytes += arrayBytes(indices) + numLodFaces * sizeof(int);
+      logDebug("  -> Simplified lod{} to {} of {} triangles",
+          i + 1,
+          numLodFaces,
+          numFaces);
+    }
+    lodsStale = false;
+  }
+
+  TraceSpan span("write lods");
+  for (LodLevel &lod : lods) {
+    if (!lod.simplifier.isValid())
+      continue;
+    UsdEditContext context(stage, lod.editTarget);
+
+    VtArray<GfVec3f> values;
+    if (data.hasPoints && lod.simplifier.apply(data.points, values)) {
+      mesh.GetPointsAttr().Set(values, time);
+      layerBytes += arrayBytes(values);
+    }
+    if (data.hasNormals && lod.simplifier.apply(data.normals, values)) {
+      mesh.GetNormalsAttr().Set(values, time);
+      layerBytes += arrayBytes(values);
+      if (!lod.attributeCache.normalsInterpolationSet) {
+        mesh.SetNormalsInterpolation(UsdGeomTokens->vertex);
+        lod.attributeCache.normalsInterpolationSet = true;
+      }
+    }
+    for (const auto &sample : data.primvars) {
+      std::visit(
+          [&](const auto &in) {
+            std::decay_t<decltype(in)> out;
+            if (!lod.simplifier.apply(in, out))
+              return;
+            lod.attributeCache.getPrimvar(mesh, sample.name, sample.type)
+                .Set(out, time);
+            layerBytes += arrayBytes(out);
+          },
+          sample.value);
+    }
+  }
+}
+
+size_t MeshWriter::getBufferBytes() const
+{
+  size_t bytes = arrayBytes(step.points) + arrayBytes(step.normals)
+      + arrayBytes(step.octNormals16) + arrayBytes(step.octNormals8)
+      + arrayBytes(step.indices) + arrayBytes(step.quantizedPoints.values)
+      + arrayBytes(topology) + arrayBytes(rigidRest)
+      + arrayBytes(rigidRestNormals) + arrayBytes(rigidFrames)
+      + arrayBytes(pointsEncoder.decoded) + arrayBytes(pointsEncoder.deltas)
+      + arrayBytes(normalsEncoder.decoded) + arrayBytes(normalsEncoder.deltas)
+      + reorder.getBufferBytes() + normalGenerator.getBufferBytes()
+      + rigidFitter.getBufferBytes();
+  for (const auto &constant : constants)
+    bytes += arrayBytes(constant.second);
+  for (const auto &sample : step.primvars)
+    std::visit([&](const auto &values) { bytes += arrayBytes(values); },
+        sample.value);
+  for (const auto &lod : lods)
+    bytes += lod.simplifier.getBufferBytes();
+  return bytes;
+}
+
+const UsdGeomMesh &MeshWriter::getMesh() const
+{
+  return mesh;
+}
+
+} // namespace agx2usd
@@ -0,0 +1,180 @@
+// Copyright 2025
+// SPDX-License-Identifier: Apache-2.0
+
+// Writes AGX geometry parameters to a USD mesh
+
+#pragma once
+
+#include "encoding.h"
+#include "geometry_writer.h"
+#include "normals.h"
+#include "reorder.h"
+#include "rigid.h"
+#include "simplify.h"
+
+// USD
+#include <pxr/usd/usd/editTarget.h>
+#include <pxr/usd/usdGeom/mesh.h>
+#include <pxr/usd/usdGeom/primvar.h>
+#include <pxr/base/gf/vec2f.h>
+#include <pxr/base/gf/vec4f.h>
+
+// std
+#include <map>
+#include <string>
+#include <utility>
+#include <variant>
+#include <vector>
+
+namespace agx2usd {
+
+// Handles of the attributes written every timestep. They are created on first
+// use so that the per-frame path does no token, path or spec construction.
+struct AttributeCache
+{
+  UsdAttribute quantizedPoints;
+  UsdAttribute quantizedPointsBounds;
+  std::vector<UsdGeomPrimvar> primvars;
+  std::vector<std::pair<TfToken, SdfValueTypeName>> primvarKeys;
+  bool normalsInterpolationSet = false;
+
+  UsdGeomPrimvar getPrimvar(const UsdGeomImageable &geom,
+      const TfToken &name,
+      const SdfValueTypeName &type);
+};
+
+// A primvar sample converted from a timestep parameter. The array is held
+// directly rather than in a VtValue, which would allocate a holder per sample.
+struct PrimvarSample
+{
+  TfToken name;
+  SdfValueTypeName type;
+  std::variant<VtArray<float>,
+      VtArray<GfVec2f>,
+      VtArray<GfVec3f>,
+      VtArray<GfVec4f>>
+      value;
+  const char *description;
+  size_t count;
+};
+
+// Convert a float (vec) array parameter such as vertex.attribute0 to a
+// primvar sample named 'name'. Returns false for other parameter types.
+bool makeAttributeSample(
+    const AGXParamView &pv, const TfToken &name, PrimvarSample &sample);
+
+// Parameter values of one timestep. They are converted while the step is
+// read, encoded concurrently, and finally written to USD in one pass.
+//
+// A single instance is reused for every timestep and acts as the per-frame
+// arena: reset() drops the arrays that were handed to the layer (USD keeps
+// them) and keeps the ones that only served as scratch, so in steady state
+// the same buffers are refilled every frame instead of being reallocated.
+struct TimeStepData
+{
+  void reset(bool pointsRetained, bool normalsRetained);
+
+  bool hasPoints = false;
+  VtArray<GfVec3f> points;
+  QuantizedPoints quantizedPoints;
+
+  bool hasNormals = false;
+  VtArray<GfVec3f> normals;
+  VtArray<unsigned int> octNormals16;
+  VtArray<unsigned char> octNormals8;
+
+  bool hasIndices = false;
+  VtArray<int> indices;
+
+  std::vector<PrimvarSample> primvars;
+};
+
+// A simplified level of detail, authored to its own variant of the mesh
+struct LodLevel
+{
+  float ratio = 1.f;
+  UsdEditTarget editTarget;
+  MeshSimplifier simplifier;
+  AttributeCache attributeCache;
+};
+
+// Writes a triangle geometry to a UsdGeomMesh. With options.lodRatios the
+// mesh gets a 'lod' VariantSet: the 'full' variant holds everything written
+// per frame, the 'lodN' variants simplified copies of it.
+class MeshWriter : public GeometryWriter
+{
+ public:
+  MeshWriter(const UsdStageRefPtr &stage,
+      const SdfPath &path,
+      const ConvertOptions &options);
+
+  void setConstant(const AGXParamView &pv) override;
+  void beginTimeStep(double timeCode) override;
+  void setTimeStepParam(const AGXParamView &pv) override;
+  void endTimeStep() override;
+  void finish() override;
+  size_t getBufferBytes() const override;
+
+  const UsdGeomMesh &getMesh() const;
+
+ private:
+  void applyVertexOrder();
+  void stopVertexOrder();
+  void writeTimeStep();
+  void flushRigidFrames();
+  void setupLods(const SdfPath &path);
+  void writeLods(const TimeStepData &data, UsdTimeCode time);
+
+  ConvertOptions options;
+  UsdGeomMesh mesh;
+
+  // Where the mesh is authored: the stage's edit target at construction, or
+  // the 'full' variant when there are levels of detail
+  UsdEditTarget baseTarget;
+  UsdEditTarget meshTarget;
+
+  // Store constant parameters
+  std::map<std::string, std::vector<uint8_t>> constants;
+
+  DeltaEncoder pointsEncoder;
+  DeltaEncoder normalsEncoder;
+
+  VertexReorder reorder;
+  // Set once a timestep did not fit the order; the input order is kept
+  // from then on
+  bool vertexOrderStopped = false;
+
+  // Triangle indices in effect, for normal generation, and whether they
+  // were ever written as a time sample rather than only as the default
+  VtArray<int> topology;
+  bool topologySampled = false;
+  NormalGenerator normalGenerator;
+
+  TfToken octNormalsToken;
+  TfToken attribute0Token;
+  TfToken stToken;
+  AttributeCache attributeCache;
+  TimeStepData step;
+  double timeCode = 0.0;
+  double firstTimeCode = 0.0;
+  bool firstTimeStep = true;
+  bool firstPositions = true;
+
+  // Rigid motion detection: while every position frame fits the first one
+  // under a rigid transform, only the transforms are kept. Input normals of
+  // those frames are held back as well, since the transform rotates the rest
+  // normals of the first frame.
+  bool rigidCandidate = false;
+  RigidFitter rigidFitter;
+  VtArray<GfVec3f> rigidRest;
+  VtArray<GfVec3f> rigidRestNormals;
+  std::vector<std::pair<double, RigidTransform>> rigidFrames;
+
+  // Levels of detail are simplified again only when the topology changes,
+  // at the first positions that use it
+  std::vector<LodLevel> lods;
+  bool lodsStale = false;
+  UsdTimeCode lodTopologyTime = UsdTimeCode::Default();
+};
+
+} // namespace agx2usd
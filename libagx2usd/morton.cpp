@@ -0,0 +1,176 @@
+// Copyright 2025
+// SPDX-License-Identifier: Apache-2.0
+
+#include "morton.h"
+#include "parallel.h"
+
+// std
+#include <algorithm>
+#include <mutex>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#endif
+
+namespace agx2usd {
+
+namespace {
+
+// Spread the low 21 bits of 'v' so that there are two zero bits between
+// consecutive bits
+uint64_t spreadBits(uint64_t v)
+{
+  v &= 0x1fffff;
+  v = (v | v << 32) & 0x1f00000000ffffull;
+  v = (v | v << 16) & 0x1f0000ff0000ffull;
+  v = (v | v << 8) & 0x100f00f00f00f00full;
+  v = (v | v << 4) & 0x10c30c30c30c30c3ull;
+  v = (v | v << 2) & 0x1249249249249249ull;
+  return v;
+}
+
+#if defined(__SSE2__) || defined(_M_X64)
+// spreadBits() for two values at once
+__m128i spreadBits2(__m128i v)
+{
+  v = _mm_and_si128(v, _mm_set1_epi64x(0x1fffff));
+  v = _mm_and_si128(_mm_or_si128(v, _mm_slli_epi64(v, 32)),
+      _mm_set1_epi64x(0x1f00000000ffffll));
+  v = _mm_and_si128(_mm_or_si128(v, _mm_slli_epi64(v, 16)),
+      _mm_set1_epi64x(0x1f0000ff0000ffll));
+  v = _mm_and_si128(_mm_or_si128(v, _mm_slli_epi64(v, 8)),
+      _mm_set1_epi64x(0x100f00f00f00f00fll));
+  v = _mm_and_si128(_mm_or_si128(v, _mm_slli_epi64(v, 4)),
+      _mm_set1_epi64x(0x10c30c30c30c30c3ll));
+  v = _mm_and_si128(_mm_or_si128(v, _mm_slli_epi64(v, 2)),
+      _mm_set1_epi64x(0x1249249249249249ll));
+  return v;
+}
+#endif
+
+} // namespace
+
+void radixSortPairs(
+    std::vector<uint64_t> &keys, std::vector<uint32_t> &values, int keyBits)
+{
+  constexpr int kDigitBits = 8;
+  constexpr size_t kBuckets = size_t(1) << kDigitBits;
+
+  const size_t n = keys.size();
+  const size_t numChunks =
+      std::max<size_t>(1, std::min<size_t>(64, n / kGrainSize));
+  auto chunkBegin = [&](size_t c) { return n * c / numChunks; };
+
+  std::vector<uint64_t> keysOut(n);
+  std::vector<uint32_t> valuesOut(n);
+  std::vector<size_t> offsets(numChunks * kBuckets);
+
+  for (int shift = 0; shift < keyBits; shift += kDigitBits) {
+    // The last digit may be narrower, so bits above 'keyBits' are ignored
+    const uint64_t digitMask =
+        (uint64_t(1) << std::min(kDigitBits, keyBits - shift)) - 1;
+
+    // Histogram of this digit per chunk
+    parallelForEach(numChunks, [&](size_t c) {
+      size_t *count = offsets.data() + c * kBuckets;
+      std::fill(count, count + kBuckets, 0);
+      for (size_t i = chunkBegin(c); i < chunkBegin(c + 1); ++i)
+        ++count[(keys[i] >> shift) & digitMask];
+    });
+
+    // Exclusive prefix sum, digit-major and chunk-minor so the sort is
+    // stable. A pass where all keys share the digit changes nothing.
+    size_t sum = 0;
+    bool trivial = false;
+    for (size_t d = 0; d < kBuckets; ++d) {
+      size_t digitTotal = 0;
+      for (size_t c = 0; c < numChunks; ++c) {
+        const size_t count = offsets[c * kBuckets + d];
+        offsets[c * kBuckets + d] = sum;
+        sum += count;
+        digitTotal += count;
+      }
+      trivial = trivial || digitTotal == n;
+    }
+    if (trivial)
+      continue;
+
+    parallelForEach(numChunks, [&](size_t c) {
+      size_t *offset = offsets.data() + c * kBuckets;
+      for (size_t i = chunkBegin(c); i < chunkBegin(c + 1); ++i) {
+        const size_t o = offset[(keys[i] >> shift) & digitMask]++;
+        keysOut[o] = keys[i];
+        valuesOut[o] = values[i];
+      }
+    });
+    keys.swap(keysOut);
+    values.swap(valuesOut);
+  }
+}
+
+std::vector<uint32_t> mortonOrder(const float *points, size_t count)
+{
+  if (count == 0)
+    return {};
+
+  // Bounds of the set
+  float lo[3] = {points[0], points[1], points[2]};
+  float hi[3] = {points[0], points[1], points[2]};
+  std::mutex mutex;
+  parallelRange(count, [&](size_t b, size_t e) {
+    float l[3] = {points[3 * b], points[3 * b + 1], points[3 * b + 2]};
+    float h[3] = {l[0], l[1], l[2]};
+    for (size_t i = b; i < e; ++i) {
+      for (int c = 0; c < 3; ++c) {
+        l[c] = std::min(l[c], points[3 * i + c]);
+        h[c] = std::max(h[c], points[3 * i + c]);
+      }
+    }
+    std::lock_guard<std::mutex> lock(mutex);
+    for (int c = 0; c < 3; ++c) {
+      lo[c] = std::min(lo[c], l[c]);
+      hi[c] = std::max(hi[c], h[c]);
+    }
+  });
+
+  float scale[3];
+  for (int c = 0; c < 3; ++c) {
+    const float range = hi[c] - lo[c];
+    scale[c] = range > 0.f ? float(0x1fffff) / range : 0.f;
+  }
+
+  // Keys and identity order
+  std::vector<uint64_t> keys(count);
+  std::vector<uint32_t> order(count);
+  auto quantize = [&](size_t i, int c) {
+    const float q = (points[3 * i + c] - lo[c]) * scale[c];
+    return static_cast<uint64_t>(std::min(std::max(q, 0.f), float(0x1fffff)));
+  };
+  parallelRange(count, [&](size_t b, size_t e) {
+    size_t i = b;
+#if defined(__SSE2__) || defined(_M_X64)
+    for (; i + 2 <= e; i += 2) {
+      const __m128i x = spreadBits2(
+          _mm_set_epi64x(quantize(i + 1, 0), quantize(i, 0)));
+      const __m128i y = spreadBits2(
+          _mm_set_epi64x(quantize(i + 1, 1), quantize(i, 1)));
+      const __m128i z = spreadBits2(
+          _mm_set_epi64x(quantize(i + 1, 2), quantize(i, 2)));
+      const __m128i key = _mm_or_si128(x,
+          _mm_or_si128(_mm_slli_epi64(y, 1), _mm_slli_epi64(z, 2)));
+      _mm_storeu_si128(reinterpret_cast<__m128i *>(keys.data() + i), key);
+    }
+#endif
+    for (; i < e; ++i) {
+      keys[i] = spreadBits(quantize(i, 0)) | spreadBits(quantize(i, 1)) << 1
+          | spreadBits(quantize(i, 2)) << 2;
+    }
+    for (size_t j = b; j < e; ++j)
+      order[j] = static_cast<uint32_t>(j);
+  });
+
+  radixSortPairs(keys, order, 63);
+  return order;
+}
+
+} // namespace agx2usd
@@ -0,0 +1,26 @@
+// Copyright 2025
+// SPDX-License-Identifier: Apache-2.0
+
+// Spatial (Morton / Z-order) sorting of point sets
+
+#pragma once
+
+// std
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace agx2usd {
+
+// Stable LSD radix sort of 'values' by the low 'keyBits' bits of 'keys'. Each
+// pass counts and scatters fixed chunks of the input in parallel.
+void radixSortPairs(std::vector<uint64_t> &keys,
+    std::vector<uint32_t> &values,
+    int keyBits);
+
+// Indices of 'count' points (packed float triples) in Morton order: the
+// interleaved bits of their coordinates quantized to 21 bits each within the
+// bounds of the set
+std::vector<uint32_t> mortonOrder(const float *points, size_t count);
+
+} // namespace agx2usd
@@ -0,0 +1,107 @@
+// Copyright 2025
+// SPDX-License-Identifier: Apache-2.0
+
+#include "normals.h"
+#include "memory.h"
+#include "parallel.h"
+
+// std
+#include <cmath>
+
+namespace agx2usd {
+
+bool NormalGenerator::buildAdjacency(
+    const VtArray<int> &newIndices, size_t newNumPoints)
+{
+  // VtArray compares by identity first, so a shared topology costs nothing
+  if (numPoints == newNumPoints && indices == newIndices)
+    return valid;
+
+  indices = newIndices;
+  numPoints = newNumPoints;
+  valid = false;
+
+  const size_t numFaces = indices.size() / 3;
+  const int *idx = indices.cdata();
+  for (size_t i = 0; i < 3 * numFaces; ++i) {
+    if (idx[i] < 0 || static_cast<size_t>(idx[i]) >= numPoints)
+      return false;
+  }
+
+  // Count the faces of every vertex, prefix sum, then fill
+  offsets.assign(numPoints + 1, 0);
+  for (size_t i = 0; i < 3 * numFaces; ++i)
+    ++offsets[idx[i] + 1];
+  for (size_t v = 0; v < numPoints; ++v)
+    offsets[v + 1] += offsets[v];
+
+  std::vector<uint32_t> fill(offsets.begin(), offsets.end() - 1);
+  faces.resize(3 * numFaces);
+  for (size_t f = 0; f < numFaces; ++f) {
+    for (int k = 0; k < 3; ++k)
+      faces[fill[idx[3 * f + k]]++] = static_cast<uint32_t>(f);
+  }
+
+  faceNormals.resize(numFaces);
+  valid = true;
+  return true;
+}
+
+size_t NormalGenerator::getBufferBytes() const
+{
+  return arrayBytes(offsets) + arrayBytes(faces) + arrayBytes(faceNormals);
+}
+
+bool NormalGenerator::compute(const VtArray<GfVec3f> &points,
+    const VtArray<int> &newIndices,
+    VtArray<GfVec3f> &normals)
+{
+  if (!buildAdjacency(newIndices, points.size()))
+    return false;
+
+  const float *p = points.cdata()->data();
+  const int *idx = indices.cdata();
+
+  // The cross product of two edges is twice the area times the unit normal,
+  // so summing unnormalized face normals weighs them by area
+  parallelRange(faceNormals.size(), [&](size_t b, size_t e) {
+    for (size_t f = b; f < e; ++f) {
+      const float *a = p + 3 * idx[3 * f];
+      const float *v1 = p + 3 * idx[3 * f + 1];
+      const float *v2 = p + 3 * idx[3 * f + 2];
+      const float e1[3] = {v1[0] - a[0], v1[1] - a[1], v1[2] - a[2]};
+      const float e2[3] = {v2[0] - a[0], v2[1] - a[1], v2[2] - a[2]};
+      faceNormals[f] = GfVec3f(e1[1] * e2[2] - e1[2] * e2[1],
+          e1[2] * e2[0] - e1[0] * e2[2],
+          e1[0] * e2[1] - e1[1] * e2[0]);
+    }
+  });
+
+  auto gather = [&](GfVec3f *out) {
+    parallelRange(numPoints, [&](size_t b, size_t e) {
+      for (size_t v = b; v < e; ++v) {
+        float n[3] = {0.f, 0.f, 0.f};
+        for (uint32_t i = offsets[v]; i < offsets[v + 1]; ++i) {
+          const float *fn = faceNormals[faces[i]].data();
+          n[0] += fn[0];
+          n[1] += fn[1];
+          n[2] += fn[2];
+        }
+        const float length2 = n[0] * n[0] + n[1] * n[1] + n[2] * n[2];
+        const float scale = length2 > 0.f ? 1.f / std::sqrt(length2) : 0.f;
+        out[v] = GfVec3f(n[0] * scale, n[1] * scale, n[2] * scale);
+      }
+    });
+  };
+
+  // Refill a scratch array of the right size in place
+  if (normals.size() == numPoints) {
+    gather(normals.data());
+  } else {
+    normals = VtArray<GfVec3f>();
+    normals.resize(numPoints, [&](GfVec3f *out, GfVec3f *) { gather(out); });
+  }
+  return true;
+}
+
+} // namespace agx2usd
@@ -0,0 +1,48 @@
+// Copyright 2025
+// SPDX-License-Identifier: Apache-2.0
+
+// Smooth vertex normals for triangle meshes
+
+#pragma once
+
+// USD
+#include <pxr/pxr.h>
+#include <pxr/base/vt/array.h>
+#include <pxr/base/gf/vec3f.h>
+
+// std
+#include <cstdint>
+#include <vector>
+
+namespace agx2usd {
+
+PXR_NAMESPACE_USING_DIRECTIVE
+
+// Computes area-weighted vertex normals. Face normals are computed first,
+// then every vertex gathers the normals of its faces through a vertex to face
+// adjacency (CSR), so both passes run in parallel without atomics or write
+// conflicts. The adjacency is kept and reused while the indices are unchanged.
+class NormalGenerator
+{
+ public:
+  // 'indices' holds 3 vertex indices per triangle. Returns false (and leaves
+  // 'normals' alone) if an index is out of range.
+  bool compute(const VtArray<GfVec3f> &points,
+      const VtArray<int> &indices,
+      VtArray<GfVec3f> &normals);
+
+  // Bytes of the buffers owned by this object
+  size_t getBufferBytes() const;
+
+ private:
+  bool buildAdjacency(const VtArray<int> &indices, size_t numPoints);
+
+  VtArray<int> indices;
+  size_t numPoints = 0;
+  bool valid = false;
+  std::vector<uint32_t> offsets; // numPoints + 1 entries
+  std::vector<uint32_t> faces;
+  std::vector<GfVec3f> faceNormals;
+};
+
+} // namespace agx2usd
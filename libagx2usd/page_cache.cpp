@@ -0,0 +1,134 @@
+// Copyright 2025
+// SPDX-License-Identifier: Apache-2.0
+
+#include "page_cache.h"
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace agx2usd {
+
+#ifdef __linux__
+
+namespace {
+
+// Pages are dropped in steps of this size...
+constexpr uint64_t kDropBytes = 16 << 20;
+// ...and only this far behind the estimated reader position, which does
+// not count the headers of the file, or behind the end of the output
+constexpr uint64_t kDropLag = 16 << 20;
+
+} // namespace
+
+std::unique_ptr<DropBehind> DropBehind::create(const std::string &path)
+{
+  const int file = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (file < 0)
+    return nullptr;
+  return std::unique_ptr<DropBehind>(new DropBehind(file));
+}
+
+DropBehind::DropBehind(int file) : file(file) {}
+
+DropBehind::~DropBehind()
+{
+  // The reader is done with the whole file
+  posix_fadvise(file, 0, 0, POSIX_FADV_DONTNEED);
+  close(file);
+}
+
+void DropBehind::advance(uint64_t bytes)
+{
+  consumed += bytes;
+  if (consumed < dropped + kDropLag + kDropBytes)
+    return;
+  const uint64_t end = consumed - kDropLag;
+  posix_fadvise(file,
+      static_cast<off_t>(dropped),
+      static_cast<off_t>(end - dropped),
+      POSIX_FADV_DONTNEED);
+  dropped = end;
+}
+
+std::unique_ptr<WriteBehind> WriteBehind::create(const std::string &path)
+{
+  const int file = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (file < 0)
+    return nullptr;
+  return std::unique_ptr<WriteBehind>(new WriteBehind(file));
+}
+
+WriteBehind::WriteBehind(int file) : file(file) {}
+
+WriteBehind::~WriteBehind()
+{
+  fdatasync(file);
+  posix_fadvise(file, 0, 0, POSIX_FADV_DONTNEED);
+  close(file);
+}
+
+void WriteBehind::advance(uint64_t bytes)
+{
+  written += bytes;
+  if (written < flushed + kDropBytes)
+    return;
+  // Start writing back the new step without waiting for it...
+  sync_file_range(file,
+      static_cast<off_t>(flushed),
+      static_cast<off_t>(written - flushed),
+      SYNC_FILE_RANGE_WRITE);
+  flushed = written;
+  if (flushed < dropped + kDropLag + kDropBytes)
+    return;
+  // ...and drop what is a lag behind, once it is on disk
+  const uint64_t end = flushed - kDropLag;
+  sync_file_range(file,
+      static_cast<off_t>(dropped),
+      static_cast<off_t>(end - dropped),
+      SYNC_FILE_RANGE_WAIT_BEFORE | SYNC_FILE_RANGE_WRITE
+          | SYNC_FILE_RANGE_WAIT_AFTER);
+  posix_fadvise(file,
+      static_cast<off_t>(dropped),
+      static_cast<off_t>(end - dropped),
+      POSIX_FADV_DONTNEED);
+  dropped = end;
+}
+
+void dropFromPageCache(const std::string &path)
+{
+  const int file = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (file < 0)
+    return;
+  // Dirty pages cannot be dropped until they are written back
+  fdatasync(file);
+  posix_fadvise(file, 0, 0, POSIX_FADV_DONTNEED);
+  close(file);
+}
+
+#else
+
+std::unique_ptr<DropBehind> DropBehind::create(const std::string &)
+{
+  return nullptr;
+}
+
+DropBehind::~DropBehind() = default;
+
+void DropBehind::advance(uint64_t) {}
+
+std::unique_ptr<WriteBehind> WriteBehind::create(const std::string &)
+{
+  return nullptr;
+}
+
+WriteBehind::~WriteBehind() = default;
+
+void WriteBehind::advance(uint64_t) {}
+
+void dropFromPageCache(const std::string &) {}
+
+#endif
+
+} // namespace agx2usd
@@ -0,0 +1,71 @@
+// Copyright 2025
+// SPDX-License-Identifier: Apache-2.0
+
+// Bounding the page cache footprint of one-shot conversions
+
+#pragma once
+
+// std
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace agx2usd {
+
+// Evicts the pages of an input file from the page cache once the AGX reader
+// is past them, in steps of a few MiB, so converting a huge file does not
+// push everything else out of the cache. The reader keeps reading through
+// the cache (it does not use O_DIRECT); only pages it is done with are
+// dropped, so read throughput is unchanged.
+class DropBehind
+{
+ public:
+  // Returns null where posix_fadvise() is not available
+  static std::unique_ptr<DropBehind> create(const std::string &path);
+  ~DropBehind();
+
+  DropBehind(const DropBehind &) = delete;
+  DropBehind &operator=(const DropBehind &) = delete;
+
+  // The reader consumed about 'bytes' more of the file
+  void advance(uint64_t bytes);
+
+ private:
+  explicit DropBehind(int file);
+
+  int file;
+  uint64_t consumed = 0;
+  uint64_t dropped = 0;
+};
+
+// The output counterpart of DropBehind: while an output file is written,
+// starts the write-back of each new step of it and, once that is a step
+// behind, waits for it and drops those pages, so dirty pages of the output
+// do not pile up in the page cache either. The rest of the file is written
+// back and dropped when this is destroyed.
+class WriteBehind
+{
+ public:
+  // Returns null where sync_file_range() is not available
+  static std::unique_ptr<WriteBehind> create(const std::string &path);
+  ~WriteBehind();
+
+  WriteBehind(const WriteBehind &) = delete;
+  WriteBehind &operator=(const WriteBehind &) = delete;
+
+  // About 'bytes' more of the file were written (not just buffered)
+  void advance(uint64_t bytes);
+
+ private:
+  explicit WriteBehind(int file);
+
+  int file;
+  uint64_t written = 0;
+  uint64_t flushed = 0;
+  uint64_t dropped = 0;
+};
+
+// Write a finished output file back to disk and drop it from the page cache
+void dropFromPageCache(const std::string &path);
+
+} // namespace agx2usd
@@ -0,0 +1,90 @@
+// Copyright 2025
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+// AGX2USD_USE_TBB is a public definition of libagx2usd: it changes the
+// inline code below, which must be the same in every user of the library
+#ifdef AGX2USD_USE_TBB
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#include <tbb/task_group.h>
+#endif
+
+// std
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace agx2usd {
+
+// Number of elements handled per task by the parallel conversion kernels
+constexpr size_t kGrainSize = 16 * 1024;
+
+// Run fn(begin, end) over chunks of [0, count), in parallel when built with TBB
+template <typename Fn>
+void parallelRange(size_t count, Fn &&fn)
+{
+#ifdef AGX2USD_USE_TBB
+  if (count > kGrainSize) {
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, count, kGrainSize),
+        [&](const tbb::blocked_range<size_t> &r) { fn(r.begin(), r.end()); });
+    return;
+  }
+#endif
+  fn(size_t(0), count);
+}
+
+// Run fn(i) for every i in [0, count) as its own task. Meant for coarse work
+// items such as whole input files, so it also runs in parallel without TBB.
+template <typename Fn>
+void parallelForEach(size_t count, Fn &&fn)
+{
+#ifdef AGX2USD_USE_TBB
+  tbb::parallel_for(size_t(0), count, [&](size_t i) { fn(i); });
+#else
+  std::atomic<size_t> next{0};
+  auto worker = [&]() {
+    for (size_t i = next++; i < count; i = next++)
+      fn(i);
+  };
+  const size_t threads = std::min<size_t>(
+      count, std::max(1u, std::thread::hardware_concurrency()));
+  std::vector<std::thread> workers;
+  for (size_t t = 1; t < threads; ++t)
+    workers.emplace_back(worker);
+  worker();
+  for (auto &w : workers)
+    w.join();
+#endif
+}
+
+// Independent tasks of one timestep: concurrent with TBB, inline without it
+struct TaskGroup
+{
+  template <typename Fn>
+  void run(Fn &&fn)
+  {
+#ifdef AGX2USD_USE_TBB
+    group.run(std::forward<Fn>(fn));
+#else
+    fn();
+#endif
+  }
+
+  void wait()
+  {
+#ifdef AGX2USD_USE_TBB
+    group.wait();
+#endif
+  }
+
+#ifdef AGX2USD_USE_TBB
+  tbb::task_group group;
+#endif
+};
+
+} // namespace agx2usd
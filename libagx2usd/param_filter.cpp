@@ -0,0 +1,54 @@
+// Copyright 2025
+// SPDX-License-Identifier: Apache-2.0
+
+#include "param_filter.h"
+
+// std
+#include <algorithm>
+
+namespace agx2usd {
+
+bool matchGlob(std::string_view pattern, std::string_view name)
+{
+  // Greedy matching that backtracks to the last '*' on a mismatch
+  size_t p = 0;
+  size_t n = 0;
+  size_t star = std::string_view::npos;
+  size_t starName = 0;
+  while (n < name.size()) {
+    if (p < pattern.size() && (pattern[p] == '?' || pattern[p] == name[n])) {
+      ++p;
+      ++n;
+    } else if (p < pattern.size() && pattern[p] == '*') {
+      star = p++;
+      starName = n;
+    } else if (star != std::string_view::npos) {
+      p = star + 1;
+      n = ++starName;
+    } else {
+      return false;
+    }
+  }
+  while (p < pattern.size() && pattern[p] == '*')
+    ++p;
+  return p == pattern.size();
+}
+
+ParamFilter::ParamFilter(const std::vector<std::string> &include,
+    const std::vector<std::string> &exclude)
+    : include(include), exclude(exclude)
+{}
+
+bool ParamFilter::accepts(std::string_view name) const
+{
+  auto matches = [&](const std::string &pattern) {
+    return matchGlob(pattern, name);
+  };
+  if (!include.empty()
+      && std::none_of(include.begin(), include.end(), matches)) {
+    return false;
+  }
+  return std::none_of(exclude.begin(), exclude.end(), matches);
+}
+
+} // namespace agx2usd
@@ -0,0 +1,34 @@
+// Copyright 2025
+// SPDX-License-Identifier: Apache-2.0
+
+// Selecting AGX parameters by name
+
+#pragma once
+
+// std
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace agx2usd {
+
+// Match 'name' against a glob pattern: '*' matches any run of characters
+// (including '.'), '?' any single character
+bool matchGlob(std::string_view pattern, std::string_view name);
+
+// Accepts the parameters that match one of the include patterns (or all if
+// there are none) and none of the exclude patterns
+class ParamFilter
+{
+ public:
+  ParamFilter(const std::vector<std::string> &include,
+      const std::vector<std::string> &exclude);
+
+  bool accepts(std::string_view name) const;
+
+ private:
+  std::vector<std::string> include;
+  std::vector<std::string> exclude;
+};
+
+} // namespace agx2usd
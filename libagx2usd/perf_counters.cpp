@@ -0,0 +1,186 @@
+// Copyright 2025
+// SPDX-License-Identifier: Apache-2.0
+
+#include "perf_counters.h"
+
+#ifdef AGX2USD_PERF_COUNTERS
+
+// Linux
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+// std
+#include <cerrno>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+
+namespace agx2usd {
+
+namespace {
+
+int openEvent(uint64_t config, int groupFd)
+{
+  perf_event_attr attr{};
+  attr.size = sizeof(attr);
+  attr.type = PERF_TYPE_HARDWARE;
+  attr.config = config;
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+  attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED
+      | PERF_FORMAT_TOTAL_TIME_RUNNING;
+  // This thread only, on any CPU
+  return static_cast<int>(
+      syscall(SYS_perf_event_open, &attr, 0, -1, groupFd, 0));
+}
+
+const char *phaseName(int phase)
+{
+  switch (static_cast<PerfPhase>(phase)) {
+  case PerfPhase::Read:
+    return "read";
+  case PerfPhase::Convert:
+    return "convert";
+  case PerfPhase::Author:
+    return "author";
+  default:
+    return "";
+  }
+}
+
+} // namespace
+
+PerfCounters::PerfCounters()
+{
+  const uint64_t configs[EventCount] = {PERF_COUNT_HW_CPU_CYCLES,
+      PERF_COUNT_HW_INSTRUCTIONS,
+      PERF_COUNT_HW_CACHE_MISSES,
+      PERF_COUNT_HW_BRANCH_MISSES};
+
+  // The first counter that opens leads the group, so all of them are
+  // scheduled together; the others are optional
+  int error = 0;
+  for (int e = 0; e < EventCount; ++e) {
+    fds[e] = openEvent(configs[e], leader);
+    slots[e] = -1;
+    if (fds[e] < 0) {
+      error = errno;
+      continue;
+    }
+    if (leader < 0)
+      leader = fds[e];
+    slots[e] = groupSize++;
+  }
+
+  if (leader < 0) {
+    static std::once_flag warned;
+    std::call_once(warned, [&]() {
+      std::cerr << "Note: Hardware performance counters unavailable ("
+                << std::strerror(error) << ")";
+      if (error == EACCES || error == EPERM)
+        std::cerr << ", see /proc/sys/kernel/perf_event_paranoid";
+      std::cerr << "\n";
+    });
+    return;
+  }
+  ioctl(leader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+  ioctl(leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+}
+
+PerfCounters::~PerfCounters()
+{
+  for (int fd : fds) {
+    if (fd >= 0)
+      close(fd);
+  }
+}
+
+bool PerfCounters::isAvailable() const
+{
+  return leader >= 0;
+}
+
+// Group read: count, time enabled, time running, then one value per counter.
+// Counts are scaled up if the kernel multiplexed the group.
+bool PerfCounters::read(uint64_t values[EventCount]) const
+{
+  uint64_t buffer[3 + EventCount];
+  const auto bytes = ::read(leader, buffer, sizeof(buffer));
+  if (bytes < static_cast<ssize_t>(3 * sizeof(uint64_t)))
+    return false;
+
+  const uint64_t enabled = buffer[1];
+  const uint64_t running = buffer[2];
+  for (int e = 0; e < EventCount; ++e) {
+    uint64_t value = slots[e] >= 0 ? buffer[3 + slots[e]] : 0;
+    if (running > 0 && running < enabled)
+      value = static_cast<uint64_t>(
+          static_cast<double>(value) * enabled / running);
+    values[e] = value;
+  }
+  return true;
+}
+
+void PerfCounters::report(std::ostream &out) const
+{
+  if (!isAvailable())
+    return;
+
+  out << "Performance counters (converting thread):\n";
+  out << "  phase       bytes        cycles  instructions    IPC"
+         "  cache misses/B  branch misses/B\n";
+  for (int p = 0; p < static_cast<int>(PerfPhase::Count); ++p) {
+    const Totals &t = totals[p];
+    if (t.events[Cycles] == 0 && t.events[Instructions] == 0)
+      continue;
+    const double cycles = static_cast<double>(t.events[Cycles]);
+    const double bytes = static_cast<double>(t.bytes);
+    out << "  " << std::left << std::setw(8) << phaseName(p) << std::right
+        << std::setw(10) << t.bytes << std::setw(14) << t.events[Cycles]
+        << std::setw(14) << t.events[Instructions] << std::fixed
+        << std::setprecision(2) << std::setw(7)
+        << (cycles > 0 ? t.events[Instructions] / cycles : 0.0)
+        << std::setprecision(4);
+    if (bytes > 0) {
+      out << std::setw(16)
+          << (slots[CacheMisses] >= 0 ? t.events[CacheMisses] / bytes : 0.0)
+          << std::setw(17)
+          << (slots[BranchMisses] >= 0 ? t.events[BranchMisses] / bytes : 0.0);
+    }
+    out << std::defaultfloat << "\n";
+  }
+}
+
+PerfScope::PerfScope(PerfCounters &counters, PerfPhase phase, uint64_t bytes)
+    : counters(counters),
+      phase(phase),
+      bytes(bytes),
+      active(counters.isAvailable() && counters.read(begin))
+{}
+
+PerfScope::~PerfScope()
+{
+  uint64_t end[PerfCounters::EventCount];
+  if (!active || !counters.read(end))
+    return;
+
+  auto &totals = counters.totals[static_cast<int>(phase)];
+  for (int e = 0; e < PerfCounters::EventCount; ++e) {
+    // Scaled counts of a multiplexed group are estimates and may go back
+    if (end[e] > begin[e])
+      totals.events[e] += end[e] - begin[e];
+  }
+  totals.bytes += bytes;
+}
+
+void PerfScope::addBytes(uint64_t n)
+{
+  bytes += n;
+}
+
+} // namespace agx2usd
+
+#endif
@@ -0,0 +1,115 @@
+// Copyright 2025
+// SPDX-License-Identifier: Apache-2.0
+
+// Hardware performance counters per conversion phase (Linux perf_event_open)
+//
+// Only built with -DAGX2USD_PERF_COUNTERS=ON. Otherwise the types below are
+// empty and every use compiles to nothing.
+
+#pragma once
+
+// std
+#include <cstdint>
+#include <ostream>
+
+namespace agx2usd {
+
+enum class PerfPhase
+{
+  Read,
+  Convert,
+  Author,
+  Count
+};
+
+#ifdef AGX2USD_PERF_COUNTERS
+
+// Counts cycles, instructions, cache misses and branch misses of the calling
+// thread, accumulated per phase together with the bytes the phase processed.
+// Work that a phase hands to other threads (TBB tasks) is not counted. When
+// the kernel refuses the counters, as is common in containers, a note is
+// printed once and the report is empty.
+class PerfCounters
+{
+ public:
+  PerfCounters();
+  ~PerfCounters();
+
+  PerfCounters(const PerfCounters &) = delete;
+  PerfCounters &operator=(const PerfCounters &) = delete;
+
+  bool isAvailable() const;
+
+  // IPC and misses per byte of every phase that ran
+  void report(std::ostream &out) const;
+
+ private:
+  friend class PerfScope;
+
+  enum Event
+  {
+    Cycles,
+    Instructions,
+    CacheMisses,
+    BranchMisses,
+    EventCount
+  };
+
+  struct Totals
+  {
+    uint64_t events[EventCount] = {};
+    uint64_t bytes = 0;
+  };
+
+  bool read(uint64_t values[EventCount]) const;
+
+  // Counters that could not be opened have fd -1 and no slot in the group
+  int fds[EventCount];
+  int slots[EventCount];
+  int leader = -1;
+  int groupSize = 0;
+  Totals totals[static_cast<int>(PerfPhase::Count)];
+};
+
+// Adds the counts between construction and destruction to 'phase'
+class PerfScope
+{
+ public:
+  PerfScope(PerfCounters &counters, PerfPhase phase, uint64_t bytes = 0);
+  ~PerfScope();
+
+  PerfScope(const PerfScope &) = delete;
+  PerfScope &operator=(const PerfScope &) = delete;
+
+  void addBytes(uint64_t bytes);
+
+ private:
+  PerfCounters &counters;
+  PerfPhase phase;
+  uint64_t bytes;
+  uint64_t begin[PerfCounters::EventCount];
+  bool active;
+};
+
+#else
+
+class PerfCounters
+{
+ public:
+  bool isAvailable() const
+  {
+    return false;
+  }
+  void report(std::ostream &) const {}
+};
+
+class PerfScope
+{
+ public:
+  PerfScope(PerfCounters &, PerfPhase, uint64_t = 0) {}
+  void addBytes(uint64_t) {}
+};
+
+#endif
+
+} // namespace agx2usd
@@ -0,0 +1,263 @@
+// Copyright 2025
+// SPDX-License-Identifier: Apache-2.0
+
+#include "points_writer.h"
+#include "log.h"
+#include "memory.h"
+#include "morton.h"
+#include "parallel.h"
+#include "trace.h"
+
+// std
+#include <algorithm>
+#include <string_view>
+
+namespace agx2usd {
+
+namespace {
+
+// Gather 'values' into 'order' if they hold one value per point
+template <typename T>
+void applyOrder(const std::vector<uint32_t> &order, VtArray<T> &values)
+{
+  if (values.size() != order.size())
+    return;
+
+  const T *in = values.cdata();
+  VtArray<T> out;
+  out.resize(values.size(), [&](T *begin, T *) {
+    parallelRange(order.size(), [&](size_t b, size_t e) {
+      for (size_t i = b; i < e; ++i)
+        begin[i] = in[order[i]];
+    });
+  });
+  values = std::move(out);
+}
+
+} // namespace
+
+PointsWriter::PointsWriter(const UsdStageRefPtr &stage,
+    const SdfPath &path,
+    const ConvertOptions &options)
+    : options(options),
+      geom(UsdGeomPoints::Define(stage, path)),
+      attribute0Token("attribute0")
+{}
+
+bool PointsWriter::convertParam(const AGXParamView &pv, PointsData &data)
+{
+  const std::string_view name(pv.name, pv.nameLength);
+
+  if (isPositionParam(name)) {
+    if (!pv.isArray || pv.elementType != ANARI_FLOAT32_VEC3)
+      return false;
+    convertFloatArray(pv.data, pv.elementCount, data.points);
+    data.hasPoints = true;
+  } else if (name == "vertex.radius" || name == "radius") {
+    // USD widths are diameters
+    if (pv.isArray && pv.elementType == ANARI_FLOAT32) {
+      data.widths = convertFloatArray<float>(pv.data, pv.elementCount);
+    } else if (!pv.isArray && pv.type == ANARI_FLOAT32) {
+      data.widths = VtArray<float>(1, *static_cast<const float *>(pv.data));
+    } else {
+      return false;
+    }
+    for (float &w : data.widths)
+      w *= 2.f;
+    data.hasWidths = true;
+  } else if (name == "vertex.id" || name == "id" || name == "vertex.ids") {
+    if (!pv.isArray)
+      return false;
+    data.ids.resize(pv.elementCount);
+    for (size_t i = 0; i < pv.elementCount; ++i) {
+      switch (pv.elementType) {
+      case ANARI_UINT32:
+        data.ids[i] = static_cast<const uint32_t *>(pv.data)[i];
+        break;
+      case ANARI_INT32:
+        data.ids[i] = static_cast<const int32_t *>(pv.data)[i];
+        break;
+      case ANARI_UINT64:
+        data.ids[i] = static_cast<int64_t>(
+            static_cast<const uint64_t *>(pv.data)[i]);
+        break;
+      case ANARI_INT64:
+        data.ids[i] = static_cast<const int64_t *>(pv.data)[i];
+        break;
+      default:
+        return false;
+      }
+    }
+    data.hasIds = true;
+  } else if (name == "vertex.attribute0" || name == "attribute0") {
+    PrimvarSample sample;
+    if (!makeAttributeSample(pv, attribute0Token, sample))
+      return false;
+    data.primvars.push_back(std::move(sample));
+  } else {
+    return false;
+  }
+  return true;
+}
+
+void PointsWriter::setConstant(const AGXParamView &pv)
+{
+  const std::string_view name(pv.name, pv.nameLength);
+  if (!pv.isArray) {
+    logDebug("  {} (scalar, type={})", name, anari::toString(pv.type));
+  } else {
+    logDebug("  {} (array, type={}, count={})",
+        name,
+        anari::toString(pv.elementType),
+        pv.elementCount);
+  }
+
+  convertParam(pv, constants);
+}
+
+void PointsWriter::beginTimeStep(double time)
+{
+  timeCode = time;
+}
+
+void PointsWriter::setTimeStepParam(const AGXParamView &pv)
+{
+  if (!convertParam(pv, step) && pv.isArray) {
+    logTrace("  -> Custom array: {} (type={}, count={})",
+        std::string_view(pv.name, pv.nameLength),
+        anari::toString(pv.elementType),
+        pv.elementCount);
+  }
+}
+
+// Without ids, the order is computed again only when the point count
+// changes, assuming the input order of a particle does not change either.
+// With ids, new particles are appended after the known ones, in input order.
+void PointsWriter::updateOrder(const PointsData &data)
+{
+  // An empty timestep keeps the order (and id ranks) of the previous one
+  const size_t count = data.points.size();
+  if (count == 0)
+    return;
+  const bool ids = data.hasIds && data.ids.size() == count;
+
+  if (order.empty() || (!ids && order.size() != count)) {
+    order = mortonOrder(data.points.cdata()->data(), count);
+    idRanks.clear();
+    if (ids) {
+      for (size_t i = 0; i < count; ++i)
+        idRanks.emplace(data.ids[order[i]], static_cast<uint32_t>(i));
+    }
+    return;
+  }
+  if (!ids)
+    return;
+
+  std::vector<uint64_t> keys(count);
+  order.resize(count);
+  for (size_t i = 0; i < count; ++i) {
+    const auto rank = static_cast<uint32_t>(idRanks.size());
+    keys[i] = idRanks.emplace(data.ids[i], rank).first->second;
+    order[i] = static_cast<uint32_t>(i);
+  }
+  radixSortPairs(keys, order, 32);
+}
+
+void PointsWriter::write(PointsData &data, UsdTimeCode time)
+{
+  if (options.sortPoints && data.hasPoints) {
+    TraceSpan span("sort points");
+    updateOrder(data);
+    applyOrder(order, data.points);
+    applyOrder(order, data.widths);
+    applyOrder(order, data.ids);
+    for (auto &sample : data.primvars)
+      std::visit([&](auto &values) { applyOrder(order, values); }, sample.value);
+  }
+
+  if (data.hasPoints) {
+    geom.GetPointsAttr().Set(data.points, time);
+    layerBytes += arrayBytes(data.points);
+    logDebug("  -> Set {} points", data.points.size());
+  }
+  if (data.hasWidths) {
+    geom.GetWidthsAttr().Set(data.widths, time);
+    layerBytes += arrayBytes(data.widths);
+    geom.SetWidthsInterpolation(
+        data.widths.size() == 1 ? UsdGeomTokens->constant : UsdGeomTokens->vertex);
+  }
+  if (data.hasIds) {
+    geom.GetIdsAttr().Set(data.ids, time);
+    layerBytes += arrayBytes(data.ids);
+  }
+  for (const auto &sample : data.primvars) {
+    auto primvar = attributeCache.getPrimvar(geom, sample.name, sample.type);
+    std::visit(
+        [&](const auto &values) {
+          primvar.Set(values, time);
+          layerBytes += arrayBytes(values);
+        },
+        sample.value);
+  }
+}
+
+size_t PointsWriter::getBufferBytes() const
+{
+  size_t bytes = arrayBytes(order) + idRanks.size() * 2 * sizeof(int64_t);
+  for (const PointsData *data : {&constants, &step}) {
+    bytes += arrayBytes(data->points) + arrayBytes(data->widths)
+        + arrayBytes(data->ids);
+    for (const auto &sample : data->primvars)
+      std::visit([&](const auto &values) { bytes += arrayBytes(values); },
+          sample.value);
+  }
+  return bytes;
+}
+
+// Sorted frames carry the constants the frame does not set along with
+// them, so they are written in the order of that frame
+void PointsWriter::addConstants(PointsData &data) const
+{
+  if (!data.hasPoints && constants.hasPoints) {
+    data.points = constants.points;
+    data.hasPoints = true;
+  }
+  if (!data.hasWidths && constants.hasWidths) {
+    data.widths = constants.widths;
+    data.hasWidths = true;
+  }
+  if (!data.hasIds && constants.hasIds) {
+    data.ids = constants.ids;
+    data.hasIds = true;
+  }
+  for (const auto &sample : constants.primvars) {
+    const bool set = std::any_of(data.primvars.begin(),
+        data.primvars.end(),
+        [&](const PrimvarSample &s) { return s.name == sample.name; });
+    if (!set)
+      data.primvars.push_back(sample);
+  }
+}
+
+void PointsWriter::endTimeStep()
+{
+  const bool empty = !step.hasPoints && !step.hasWidths && !step.hasIds
+      && step.primvars.empty();
+  if (options.sortPoints && !empty) {
+    addConstants(step);
+    constantsWritten = true;
+  }
+
+  write(step, UsdTimeCode(timeCode));
+  step = PointsData();
+}
+
+void PointsWriter::finish()
+{
+  // Sorted constants went out with every frame instead, unless there was
+  // none; they are then sorted on their own
+  if (!constantsWritten)
+    write(constants, UsdTimeCode::Default());
+}
+
+} // namespace agx2usd
@@ -0,0 +1,76 @@
+// Copyright 2025
+// SPDX-License-Identifier: Apache-2.0
+
+// Writes AGX particle geometry to USD points
+
+#pragma once
+
+#include "geometry_writer.h"
+#include "mesh_writer.h"
+
+// USD
+#include <pxr/usd/usdGeom/points.h>
+
+// std
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace agx2usd {
+
+// Per-vertex values of a sphere geometry, converted from either its constant
+// or its timestep parameters
+struct PointsData
+{
+  bool hasPoints = false;
+  VtArray<GfVec3f> points;
+  bool hasWidths = false;
+  VtArray<float> widths;
+  bool hasIds = false;
+  VtArray<int64_t> ids;
+  std::vector<PrimvarSample> primvars;
+};
+
+// Writes a sphere geometry to UsdGeomPoints: vertex.position to points,
+// vertex.radius (or a constant radius) to widths, vertex.id to ids and
+// vertex.attribute0 to a primvar. With options.sortPoints the points of
+// every timestep are written in Morton order.
+class PointsWriter : public GeometryWriter
+{
+ public:
+  PointsWriter(const UsdStageRefPtr &stage,
+      const SdfPath &path,
+      const ConvertOptions &options);
+
+  void setConstant(const AGXParamView &pv) override;
+  void beginTimeStep(double timeCode) override;
+  void setTimeStepParam(const AGXParamView &pv) override;
+  void endTimeStep() override;
+  void finish() override;
+  size_t getBufferBytes() const override;
+
+ private:
+  bool convertParam(const AGXParamView &pv, PointsData &data);
+  void addConstants(PointsData &data) const;
+  void updateOrder(const PointsData &data);
+  void write(PointsData &data, UsdTimeCode time);
+
+  ConvertOptions options;
+  UsdGeomPoints geom;
+  TfToken attribute0Token;
+  AttributeCache attributeCache;
+
+  // Constant per-vertex arrays. Without sorting they are written once as
+  // default values; with sorting they are permuted along with every frame.
+  PointsData constants;
+  bool constantsWritten = false;
+  PointsData step;
+  double timeCode = 0.0;
+
+  // Morton order of the points, as source index per output position. With
+  // ids it is kept stable across frames through the rank of every id.
+  std::vector<uint32_t> order;
+  std::unordered_map<int64_t, uint32_t> idRanks;
+};
+
+} // namespace agx2usd
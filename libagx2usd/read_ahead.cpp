@@ -0,0 +1,88 @@
+// Copyright 2025
+// SPDX-License-Identifier: Apache-2.0
+
+#include "read_ahead.h"
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// std
+#include <algorithm>
+
+namespace agx2usd {
+
+#ifdef __linux__
+
+namespace {
+
+// The kernel limits each request to its readahead size (ra_pages or the
+// device's io_pages), so the window is requested in chunks no larger
+constexpr uint64_t kChunkBytes = 1 << 20;
+
+} // namespace
+
+std::unique_ptr<ReadAhead> ReadAhead::create(
+    const std::string &path, uint32_t windowMiB)
+{
+  windowMiB = std::min(windowMiB, kMaxReadAheadMiB);
+  if (windowMiB == 0)
+    return nullptr;
+  const int file = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (file < 0)
+    return nullptr;
+  struct stat info;
+  if (fstat(file, &info) != 0 || !S_ISREG(info.st_mode)) {
+    close(file);
+    return nullptr;
+  }
+  std::unique_ptr<ReadAhead> readAhead(new ReadAhead(file,
+      static_cast<uint64_t>(info.st_size),
+      windowMiB * kChunkBytes));
+  readAhead->request();
+  return readAhead;
+}
+
+ReadAhead::ReadAhead(int file, uint64_t fileSize, uint64_t windowBytes)
+    : file(file), fileSize(fileSize), windowBytes(windowBytes)
+{}
+
+ReadAhead::~ReadAhead()
+{
+  close(file);
+}
+
+void ReadAhead::advance(uint64_t bytes)
+{
+  consumed += bytes;
+  request();
+}
+
+void ReadAhead::request()
+{
+  const uint64_t window = std::min(fileSize, consumed + windowBytes);
+  while (next < window) {
+    posix_fadvise(file,
+        static_cast<off_t>(next),
+        static_cast<off_t>(kChunkBytes),
+        POSIX_FADV_WILLNEED);
+    next += kChunkBytes;
+  }
+}
+
+#else
+
+std::unique_ptr<ReadAhead> ReadAhead::create(const std::string &, uint32_t)
+{
+  return nullptr;
+}
+
+ReadAhead::~ReadAhead() = default;
+
+void ReadAhead::advance(uint64_t) {}
+
+#endif
+
+} // namespace agx2usd
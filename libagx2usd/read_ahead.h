@@ -0,0 +1,55 @@
+// Copyright 2025
+// SPDX-License-Identifier: Apache-2.0
+
+// Read-ahead of AGX input files into the page cache
+
+#pragma once
+
+// std
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace agx2usd {
+
+// Largest accepted read-ahead window, in MiB of page cache
+constexpr uint32_t kMaxReadAheadMiB = 128;
+
+// Keeps the next 'windowMiB' MiB of the input requested ahead of the AGX
+// reader, so the device works on the next timesteps while the current one
+// is converted. The AGX reader does its own blocking reads, so the data is
+// not handed over: each 1 MiB chunk is requested with
+// posix_fadvise(POSIX_FADV_WILLNEED), which starts the read into the page
+// cache and returns, and the reader's reads are then served from the cache.
+// No buffers are allocated and no data is copied.
+//
+// All calls come from the thread that reads the file. On other platforms,
+// or for files that are not regular files, create() returns null and the
+// file is read as before.
+class ReadAhead
+{
+ public:
+  static std::unique_ptr<ReadAhead> create(
+      const std::string &path, uint32_t windowMiB);
+  ~ReadAhead();
+
+  ReadAhead(const ReadAhead &) = delete;
+  ReadAhead &operator=(const ReadAhead &) = delete;
+
+  // The reader consumed about 'bytes' more of the file. Requests the chunks
+  // that entered the window ahead of the reader.
+  void advance(uint64_t bytes);
+
+ private:
+  ReadAhead(int file, uint64_t fileSize, uint64_t windowBytes);
+
+  void request();
+
+  int file = -1;
+  uint64_t fileSize = 0;
+  uint64_t windowBytes = 0;
+  uint64_t consumed = 0; // estimated read position of the AGX reader
+  uint64_t next = 0; // offset of the next chunk to request
+};
+
+} // namespace agx2usd
@@ -0,0 +1,215 @@
+// Copyright 2025
+// SPDX-License-Identifier: Apache-2.0
+
+#include "reorder.h"
+#include "memory.h"
+
+// std
+#include <algorithm>
+#include <cmath>
+
+namespace agx2usd {
+
+namespace {
+
+constexpr int kCacheSize = 32;
+
+// Forsyth's vertex score: vertices that were just used (and are likely still
+// in the cache) and vertices with few remaining triangles score high
+struct ScoreTable
+{
+  ScoreTable()
+  {
+    for (int i = 0; i < kCacheSize; ++i) {
+      cache[i] = i < 3 ? 0.75f
+                       : std::pow(1.f - float(i - 3) / (kCacheSize - 3), 1.5f);
+    }
+    valence[0] = 0.f;
+    for (uint32_t i = 1; i < kMaxValence; ++i)
+      valence[i] = 2.f / std::sqrt(float(i));
+  }
+
+  float score(int cachePosition, uint32_t remaining) const
+  {
+    if (remaining == 0)
+      return -1.f;
+    const float v = valence[std::min<uint32_t>(remaining, kMaxValence - 1)];
+    return cachePosition < 0 ? v : cache[cachePosition] + v;
+  }
+
+  static constexpr uint32_t kMaxValence = 64;
+  float cache[kCacheSize];
+  float valence[kMaxValence];
+};
+
+// Triangle order of the optimized index buffer
+std::vector<uint32_t> optimizeTriangleOrder(
+    const int *idx, size_t numTriangles, size_t numVertices)
+{
+  static const ScoreTable table;
+
+  // Triangles of every vertex (CSR) and how many of them are still pending
+  std::vector<uint32_t> offsets(numVertices + 1, 0);
+  for (size_t i = 0; i < 3 * numTriangles; ++i)
+    ++offsets[idx[i] + 1];
+  for (size_t v = 0; v < numVertices; ++v)
+    offsets[v + 1] += offsets[v];
+  std::vector<uint32_t> triangles(3 * numTriangles);
+  std::vector<uint32_t> fill(offsets.begin(), offsets.end() - 1);
+  for (size_t t = 0; t < numTriangles; ++t) {
+    for (int k = 0; k < 3; ++k)
+      triangles[fill[idx[3 * t + k]]++] = static_cast<uint32_t>(t);
+  }
+
+  std::vector<uint32_t> remaining(numVertices);
+  std::vector<int> cachePosition(numVertices, -1);
+  std::vector<float> vertexScore(numVertices);
+  for (size_t v = 0; v < numVertices; ++v) {
+    remaining[v] = offsets[v + 1] - offsets[v];
+    vertexScore[v] = table.score(-1, remaining[v]);
+  }
+
+  std::vector<float> triangleScore(numTriangles);
+  std::vector<bool> emitted(numTriangles, false);
+  for (size_t t = 0; t < numTriangles; ++t) {
+    triangleScore[t] = vertexScore[idx[3 * t]] + vertexScore[idx[3 * t + 1]]
+        + vertexScore[idx[3 * t + 2]];
+  }
+
+  std::vector<uint32_t> order;
+  order.reserve(numTriangles);
+  std::vector<uint32_t> cache;
+  std::vector<uint32_t> newCache;
+  cache.reserve(kCacheSize + 3);
+  newCache.reserve(kCacheSize + 3);
+
+  size_t scanFrom = 0;
+  int64_t best = -1;
+  while (order.size() < numTriangles) {
+    // Without a candidate next to the cache, continue with the first
+    // triangle not emitted yet
+    if (best < 0) {
+      while (emitted[scanFrom])
+        ++scanFrom;
+      best = static_cast<int64_t>(scanFrom);
+    }
+
+    const uint32_t t = static_cast<uint32_t>(best);
+    emitted[t] = true;
+    order.push_back(t);
+
+    // Move the triangle's vertices to the front of the cache
+    newCache.clear();
+    for (int k = 0; k < 3; ++k) {
+      const uint32_t v = idx[3 * t + k];
+      newCache.push_back(v);
+      --remaining[v];
+
+      // Remove the emitted triangle from the vertex's pending list
+      uint32_t *begin = triangles.data() + offsets[v];
+      uint32_t *end = begin + remaining[v] + 1;
+      std::iter_swap(std::find(begin, end, t), end - 1);
+    }
+    for (uint32_t v : cache) {
+      if (v != newCache[0] && v != newCache[1] && v != newCache[2])
+        newCache.push_back(v);
+    }
+
+    // Rescore the vertices that are or were in the cache, and their
+    // pending triangles; the best of those is the next candidate
+    for (size_t i = 0; i < newCache.size(); ++i) {
+      const uint32_t v = newCache[i];
+      cachePosition[v] = i < kCacheSize ? static_cast<int>(i) : -1;
+      const float score = table.score(cachePosition[v], remaining[v]);
+      const float change = score - vertexScore[v];
+      vertexScore[v] = score;
+      for (uint32_t j = 0; j < remaining[v]; ++j)
+        triangleScore[triangles[offsets[v] + j]] += change;
+    }
+    if (newCache.size() > kCacheSize)
+      newCache.resize(kCacheSize);
+    cache.swap(newCache);
+
+    best = -1;
+    float bestScore = -1.f;
+    for (uint32_t v : cache) {
+      for (uint32_t j = 0; j < remaining[v]; ++j) {
+        const uint32_t candidate = triangles[offsets[v] + j];
+        if (triangleScore[candidate] > bestScore) {
+          bestScore = triangleScore[candidate];
+          best = candidate;
+        }
+      }
+    }
+  }
+  return order;
+}
+
+} // namespace
+
+void VertexReorder::compute(const VtArray<int> &source)
+{
+  sourceIndices = source;
+  indices = VtArray<int>();
+  newToOld.clear();
+
+  const size_t numTriangles = source.size() / 3;
+  const int *idx = source.cdata();
+  int maxIndex = -1;
+  for (size_t i = 0; i < 3 * numTriangles; ++i) {
+    if (idx[i] < 0)
+      return;
+    maxIndex = std::max(maxIndex, idx[i]);
+  }
+  const size_t numVertices = static_cast<size_t>(maxIndex + 1);
+
+  const std::vector<uint32_t> order =
+      optimizeTriangleOrder(idx, numTriangles, numVertices);
+
+  // Number vertices in order of first use; unreferenced ones go last
+  std::vector<int> oldToNew(numVertices, -1);
+  newToOld.reserve(numVertices);
+  indices.resize(3 * numTriangles);
+  int *out = indices.data();
+  for (size_t i = 0; i < numTriangles; ++i) {
+    for (int k = 0; k < 3; ++k) {
+      const int v = idx[3 * order[i] + k];
+      if (oldToNew[v] < 0) {
+        oldToNew[v] = static_cast<int>(newToOld.size());
+        newToOld.push_back(static_cast<uint32_t>(v));
+      }
+      out[3 * i + k] = oldToNew[v];
+    }
+  }
+  for (size_t v = 0; v < numVertices; ++v) {
+    if (oldToNew[v] < 0)
+      newToOld.push_back(static_cast<uint32_t>(v));
+  }
+}
+
+size_t VertexReorder::getBufferBytes() const
+{
+  return arrayBytes(indices) + arrayBytes(newToOld);
+}
+
+bool VertexReorder::isValid() const
+{
+  return !newToOld.empty();
+}
+
+size_t VertexReorder::getVertexCount() const
+{
+  return newToOld.size();
+}
+
+const VtArray<int> &VertexReorder::getSourceIndices() const
+{
+  return sourceIndices;
+}
+
+const VtArray<int> &VertexReorder::getIndices() const
+{
+  return indices;
+}
+
+} // namespace agx2usd
@@ -0,0 +1,78 @@
+// Copyright 2025
+// SPDX-License-Identifier: Apache-2.0
+
+// Vertex cache and vertex fetch optimization of triangle meshes
+
+#pragma once
+
+#include "parallel.h"
+
+// USD
+#include <pxr/pxr.h>
+#include <pxr/base/vt/array.h>
+
+// std
+#include <cstdint>
+#include <vector>
+
+namespace agx2usd {
+
+PXR_NAMESPACE_USING_DIRECTIVE
+
+// Reorders triangles for the GPU post-transform vertex cache (Forsyth's
+// linear-speed algorithm), then renumbers vertices in order of first use so
+// vertex fetches are sequential. The permutation is computed once per
+// topology and applied to every per-vertex array with a parallel gather.
+class VertexReorder
+{
+ public:
+  // Compute the order for 'indices' (3 per triangle). Vertices beyond the
+  // largest index are not referenced and keep their position at the end.
+  void compute(const VtArray<int> &indices);
+
+  bool isValid() const;
+
+  // Vertices the order covers: apply() needs arrays of at least this many
+  size_t getVertexCount() const;
+
+  // Bytes of the buffers owned by this object
+  size_t getBufferBytes() const;
+
+  // The source indices the order was computed for, and the reordered and
+  // renumbered indices to write instead
+  const VtArray<int> &getSourceIndices() const;
+  const VtArray<int> &getIndices() const;
+
+  // Permute one per-vertex array into the new vertex order. Arrays smaller
+  // than the referenced vertex range are returned unchanged (false).
+  template <typename T>
+  bool apply(VtArray<T> &values) const;
+
+ private:
+  VtArray<int> sourceIndices;
+  VtArray<int> indices;
+  std::vector<uint32_t> newToOld;
+};
+
+template <typename T>
+bool VertexReorder::apply(VtArray<T> &values) const
+{
+  const size_t count = newToOld.size();
+  if (count == 0 || values.size() < count)
+    return false;
+
+  const T *in = values.cdata();
+  VtArray<T> out;
+  out.resize(values.size(), [&](T *begin, T *) {
+    parallelRange(count, [&](size_t b, size_t e) {
+      for (size_t i = b; i < e; ++i)
+        begin[i] = in[newToOld[i]];
+    });
+    for (size_t i = count; i < values.size(); ++i)
+      begin[i] = in[i];
+  });
+  values = std::move(out);
+  return true;
+}
+
+} // namespace agx2usd
@@ -0,0 +1,252 @@
+// Copyright 2025
+// SPDX-License-Identifier: Apache-2.0
+
+#include "rigid.h"
+#include "memory.h"
+#include "parallel.h"
+
+// std
+#include <algorithm>
+#include <cmath>
+#include <mutex>
+
+namespace agx2usd {
+
+namespace {
+
+// Eigenvector of the largest eigenvalue of a symmetric 4x4 matrix, by cyclic
+// Jacobi rotations. 'a' is destroyed.
+void largestEigenvector(double a[4][4], double result[4])
+{
+  double v[4][4] = {{1, 0, 0, 0}, {0, 1, 0, 0}, {0, 0, 1, 0}, {0, 0, 0, 1}};
+
+  for (int sweep = 0; sweep < 50; ++sweep) {
+    double off = 0.0;
+    for (int p = 0; p < 4; ++p)
+      for (int q = p + 1; q < 4; ++q)
+        off += a[p][q] * a[p][q];
+    if (off < 1e-30)
+      break;
+
+    for (int p = 0; p < 4; ++p) {
+      for (int q = p + 1; q < 4; ++q) {
+        if (std::abs(a[p][q]) < 1e-300)
+          continue;
+        const double theta = (a[q][q] - a[p][p]) / (2.0 * a[p][q]);
+        const double t = (theta >= 0.0 ? 1.0 : -1.0)
+            / (std::abs(theta) + std::sqrt(theta * theta + 1.0));
+        const double c = 1.0 / std::sqrt(t * t + 1.0);
+        const double s = t * c;
+
+        for (int k = 0; k < 4; ++k) {
+          const double akp = a[k][p];
+          const double akq = a[k][q];
+          a[k][p] = c * akp - s * akq;
+          a[k][q] = s * akp + c * akq;
+        }
+        for (int k = 0; k < 4; ++k) {
+          const double apk = a[p][k];
+          const double aqk = a[q][k];
+          a[p][k] = c * apk - s * aqk;
+          a[q][k] = s * apk + c * aqk;
+        }
+        for (int k = 0; k < 4; ++k) {
+          const double vkp = v[k][p];
+          const double vkq = v[k][q];
+          v[k][p] = c * vkp - s * vkq;
+          v[k][q] = s * vkp + c * vkq;
+        }
+      }
+    }
+  }
+
+  int best = 0;
+  for (int i = 1; i < 4; ++i) {
+    if (a[i][i] > a[best][best])
+      best = i;
+  }
+  for (int k = 0; k < 4; ++k)
+    result[k] = v[k][best];
+}
+
+void quaternionToMatrix(const double q[4], double r[3][3])
+{
+  const double w = q[0], x = q[1], y = q[2], z = q[3];
+  r[0][0] = w * w + x * x - y * y - z * z;
+  r[0][1] = 2.0 * (x * y - w * z);
+  r[0][2] = 2.0 * (x * z + w * y);
+  r[1][0] = 2.0 * (x * y + w * z);
+  r[1][1] = w * w - x * x + y * y - z * z;
+  r[1][2] = 2.0 * (y * z - w * x);
+  r[2][0] = 2.0 * (x * z - w * y);
+  r[2][1] = 2.0 * (y * z + w * x);
+  r[2][2] = w * w - x * x - y * y + z * z;
+}
+
+} // namespace
+
+void RigidFitter::setReference(const float *points, size_t count)
+{
+  double sum[3] = {0.0, 0.0, 0.0};
+  for (size_t i = 0; i < count; ++i)
+    for (int c = 0; c < 3; ++c)
+      sum[c] += points[3 * i + c];
+  for (int c = 0; c < 3; ++c)
+    centroid[c] = count > 0 ? sum[c] / count : 0.0;
+
+  centered.resize(3 * count);
+  for (size_t i = 0; i < count; ++i)
+    for (int c = 0; c < 3; ++c)
+      centered[3 * i + c] = static_cast<float>(points[3 * i + c] - centroid[c]);
+}
+
+size_t RigidFitter::getBufferBytes() const
+{
+  return arrayBytes(centered);
+}
+
+size_t RigidFitter::size() const
+{
+  return centered.size() / 3;
+}
+
+bool RigidFitter::fit(const float *points,
+    size_t count,
+    double tolerance,
+    RigidTransform &result) const
+{
+  if (count != size() || count == 0)
+    return false;
+
+  // Centroid of the frame and cross-covariance S[a][b] = sum ref_a * cur_b.
+  // As the reference is centered, the frame's centroid need not be
+  // subtracted first, so both come out of a single pass.
+  double sum[3] = {0.0, 0.0, 0.0};
+  double s[3][3] = {};
+  std::mutex mutex;
+  parallelRange(count, [&](size_t b, size_t e) {
+    double localSum[3] = {0.0, 0.0, 0.0};
+    double local[3][3] = {};
+    const float *ref = centered.data();
+    for (size_t i = b; i < e; ++i) {
+      const double cur[3] = {
+          points[3 * i], points[3 * i + 1], points[3 * i + 2]};
+      for (int r = 0; r < 3; ++r) {
+        localSum[r] += cur[r];
+        for (int c = 0; c < 3; ++c)
+          local[r][c] += ref[3 * i + r] * cur[c];
+      }
+    }
+    std::lock_guard<std::mutex> lock(mutex);
+    for (int r = 0; r < 3; ++r) {
+      sum[r] += localSum[r];
+      for (int c = 0; c < 3; ++c)
+        s[r][c] += local[r][c];
+    }
+  });
+
+  // Horn: the optimal rotation is the unit quaternion maximizing q^T N q
+  double n[4][4] = {
+      {s[0][0] + s[1][1] + s[2][2],
+          s[1][2] - s[2][1],
+          s[2][0] - s[0][2],
+          s[0][1] - s[1][0]},
+      {s[1][2] - s[2][1],
+          s[0][0] - s[1][1] - s[2][2],
+          s[0][1] + s[1][0],
+          s[2][0] + s[0][2]},
+      {s[2][0] - s[0][2],
+          s[0][1] + s[1][0],
+          -s[0][0] + s[1][1] - s[2][2],
+          s[1][2] + s[2][1]},
+      {s[0][1] - s[1][0],
+          s[2][0] + s[0][2],
+          s[1][2] + s[2][1],
+          -s[0][0] - s[1][1] + s[2][2]}};
+  double q[4];
+  largestEigenvector(n, q);
+  const double norm =
+      std::sqrt(q[0] * q[0] + q[1] * q[1] + q[2] * q[2] + q[3] * q[3]);
+  for (double &v : q)
+    v /= norm;
+
+  RigidTransform transform;
+  quaternionToMatrix(q, transform.rotation);
+  const auto &rot = transform.rotation;
+
+  // translation = centroid(frame) - R * centroid(reference)
+  for (int r = 0; r < 3; ++r) {
+    transform.translation[r] = sum[r] / count;
+    for (int c = 0; c < 3; ++c)
+      transform.translation[r] -= rot[r][c] * centroid[c];
+  }
+
+  // Largest deviation of the fit, relative to the frame's centroid so that
+  // precision does not depend on the distance from the origin
+  const double mean[3] = {sum[0] / count, sum[1] / count, sum[2] / count};
+  double maxError2 = 0.0;
+  parallelRange(count, [&](size_t b, size_t e) {
+    double local = 0.0;
+    const float *ref = centered.data();
+    for (size_t i = b; i < e; ++i) {
+      double error2 = 0.0;
+      for (int r = 0; r < 3; ++r) {
+        const double predicted = rot[r][0] * ref[3 * i]
+            + rot[r][1] * ref[3 * i + 1] + rot[r][2] * ref[3 * i + 2];
+        const double d = predicted - (points[3 * i + r] - mean[r]);
+        error2 += d * d;
+      }
+      local = std::max(local, error2);
+    }
+    std::lock_guard<std::mutex> lock(mutex);
+    maxError2 = std::max(maxError2, local);
+  });
+
+  if (maxError2 > tolerance * tolerance)
+    return false;
+
+  result = transform;
+  return true;
+}
+
+void RigidFitter::apply(const RigidTransform &transform, float *out) const
+{
+  const auto &rot = transform.rotation;
+  double offset[3];
+  for (int r = 0; r < 3; ++r) {
+    offset[r] = transform.translation[r];
+    for (int c = 0; c < 3; ++c)
+      offset[r] += rot[r][c] * centroid[c];
+  }
+
+  const float *ref = centered.data();
+  parallelRange(size(), [&](size_t b, size_t e) {
+    for (size_t i = b; i < e; ++i) {
+      for (int r = 0; r < 3; ++r) {
+        out[3 * i + r] = static_cast<float>(rot[r][0] * ref[3 * i]
+            + rot[r][1] * ref[3 * i + 1] + rot[r][2] * ref[3 * i + 2]
+            + offset[r]);
+      }
+    }
+  });
+}
+
+void rotateVectors(const RigidTransform &transform,
+    const float *vectors,
+    size_t count,
+    float *out)
+{
+  const auto &rot = transform.rotation;
+  parallelRange(count, [&](size_t b, size_t e) {
+    for (size_t i = b; i < e; ++i) {
+      const double v[3] = {
+          vectors[3 * i], vectors[3 * i + 1], vectors[3 * i + 2]};
+      for (int r = 0; r < 3; ++r) {
+        out[3 * i + r] = static_cast<float>(
+            rot[r][0] * v[0] + rot[r][1] * v[1] + rot[r][2] * v[2]);
+      }
+    }
+  });
+}
+
+} // namespace agx2usd
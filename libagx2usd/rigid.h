@@ -0,0 +1,57 @@
+// Copyright 2025
+// SPDX-License-Identifier: Apache-2.0
+
+// Detection of rigidly moving point sets
+
+#pragma once
+
+// std
+#include <cstddef>
+#include <vector>
+
+namespace agx2usd {
+
+// x' = rotation * x + translation, with 'rotation' stored row-major
+struct RigidTransform
+{
+  double rotation[3][3] = {{1.0, 0.0, 0.0}, {0.0, 1.0, 0.0}, {0.0, 0.0, 1.0}};
+  double translation[3] = {0.0, 0.0, 0.0};
+};
+
+// Rotate 'count' direction vectors (e.g. normals) by the rotation of
+// 'transform' into 'out', which may be 'vectors'
+void rotateVectors(const RigidTransform &transform,
+    const float *vectors,
+    size_t count,
+    float *out);
+
+// Least-squares fit of a rigid transform from a reference frame of points to
+// later frames with the same vertex order (Kabsch problem, solved with Horn's
+// quaternion method). Points are tightly packed float triples.
+class RigidFitter
+{
+ public:
+  void setReference(const float *points, size_t count);
+  size_t size() const;
+
+  // Bytes of the buffers owned by this object
+  size_t getBufferBytes() const;
+
+  // Fit the transform that best maps the reference onto 'points'. Succeeds if
+  // every transformed reference point lies within 'tolerance' of its
+  // counterpart.
+  bool fit(const float *points,
+      size_t count,
+      double tolerance,
+      RigidTransform &result) const;
+
+  // Write the transformed reference points to 'out' (size() triples)
+  void apply(const RigidTransform &transform, float *out) const;
+
+ private:
+  // Reference points relative to their centroid
+  std::vector<float> centered;
+  double centroid[3] = {0.0, 0.0, 0.0};
+};
+
+} // namespace agx2usd
@@ -0,0 +1,347 @@
+// Copyright 2025
+// SPDX-License-Identifier: Apache-2.0
+
+#include "agx2usd.h"
+#include "checksum.h"
+#include "geometry_writer.h"
+#include "input.h"
+#include "log.h"
+#include "memory.h"
+#include "param_filter.h"
+#include "scene.h"
+#include "trace.h"
+#include "parallel.h"
+
+// USD
+#include <pxr/base/tf/stringUtils.h>
+#include <pxr/usd/usd/prim.h>
+#include <pxr/usd/usd/references.h>
+
+// std
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <set>
+#include <string_view>
+
+namespace agx2usd {
+
+namespace {
+
+void hashCombine(uint64_t &seed, uint64_t value)
+{
+  seed ^= value + 0x9e3779b97f4a7c15ull + (seed << 6) + (seed >> 2);
+}
+
+// Positions relative to 'centroid', snapped to a grid of 'tolerance': the
+// form in which duplicates are hashed and compared
+void quantizePositions(const float *p,
+    size_t count,
+    const GfVec3d &centroid,
+    double tolerance,
+    std::vector<int64_t> &out)
+{
+  out.resize(3 * count);
+  for (size_t i = 0; i < count; ++i)
+    for (int c = 0; c < 3; ++c)
+      out[3 * i + c] = std::llround((p[3 * i + c] - centroid[c]) / tolerance);
+}
+
+// Prim names are derived from the file names and made unique
+std::vector<SceneObject> makeSceneObjects(
+    const std::vector<std::string> &inputPaths, const std::string &outputPath)
+{
+  namespace fs = std::filesystem;
+
+  const fs::path output(outputPath);
+  const std::string objectsDir = output.stem().string() + "_objects";
+
+  std::vector<SceneObject> objects;
+  std::set<std::string> names;
+  for (const auto &inputPath : inputPaths) {
+    const std::string base =
+        TfMakeValidIdentifier(fs::path(inputPath).stem().string());
+    std::string name = base;
+    for (int i = 2; !names.insert(name).second; ++i)
+      name = base + "_" + std::to_string(i);
+
+    SceneObject object;
+    object.inputPath = inputPath;
+    object.primName = name;
+    object.assetPath = "./" + objectsDir + "/" + name + ".usdc";
+    object.layerPath =
+        (output.parent_path() / objectsDir / (name + ".usdc")).string();
+    objects.push_back(std::move(object));
+  }
+  return objects;
+}
+
+// Reads an object once to compute its content fingerprint and centroid
+bool analyzeObject(SceneObject &object, const ConvertOptions &options)
+{
+  TraceSpan span("analyze object", object.inputPath);
+  // The checksums are verified (or written) by the conversion pass
+  ConvertOptions analyzeOptions = options;
+  analyzeOptions.verifyChecksums = false;
+  AGXReader reader = openInput(object.inputPath, analyzeOptions);
+  if (!reader) {
+    std::cerr << "Error: Failed to open AGX file: " << object.inputPath << "\n";
+    return false;
+  }
+
+  bool success = false;
+  AGXHeader hdr{};
+  if (agxReaderGetHeader(reader, &hdr) == 0) {
+    ContentHasher hasher(options.instanceTolerance);
+    const char *subtype = agxReaderGetSubtype(reader);
+    if (subtype)
+      hasher.addBytes(subtype, std::strlen(subtype));
+    hasher.addValue(hdr.timeSteps);
+
+    InputProgress *progress = getInputProgress(reader);
+    const ParamFilter filter(options.includeParams, options.excludeParams);
+    auto add = [&](const AGXParamView &pv) {
+      // Excluded parameters do not tell objects apart
+      if (filter.accepts(std::string_view(pv.name, pv.nameLength)))
+        hasher.add(pv);
+      if (progress)
+        progress->advance(pv.nameLength + pv.dataBytes);
+    };
+
+    AGXParamView pv{};
+    agxReaderResetConstants(reader);
+    int rc = 0;
+    while ((rc = agxReaderNextConstant(reader, &pv)) == 1)
+      add(pv);
+
+    uint32_t stepIndex = 0;
+    uint32_t paramCount = 0;
+    agxReaderResetTimeSteps(reader);
+    while (rc == 0
+        && agxReaderBeginNextTimeStep(reader, &stepIndex, &paramCount) == 1) {
+      hasher.addTimeStep(stepIndex);
+      while ((rc = agxReaderNextTimeStepParam(reader, &pv)) == 1)
+        add(pv);
+    }
+
+    success = rc == 0;
+    object.timeSteps = hdr.timeSteps;
+    object.fingerprint = hasher.fingerprint;
+    object.centroid = hasher.centroid;
+  }
+  if (!success)
+    std::cerr << "Error: Failed to read AGX file: " << object.inputPath << "\n";
+
+  closeInput(reader);
+  return success;
+}
+
+bool convertObject(SceneObject &object,
+    const ConvertOptions &options,
+    SceneMemoryLimit *memoryLimit)
+{
+  TraceSpan span("convert object", object.inputPath);
+  AGXReader reader = openInput(object.inputPath, options);
+  if (!reader) {
+    std::cerr << "Error: Failed to open AGX file: " << object.inputPath << "\n";
+    return false;
+  }
+
+  AGXHeader hdr{};
+  if (agxReaderGetHeader(reader, &hdr) == 0) {
+    object.timeSteps = hdr.timeSteps;
+    object.converted =
+        convertToFile(reader, object.layerPath, options, memoryLimit);
+  } else {
+    std::cerr << "Error: Failed to read AGX header: " << object.inputPath
+              << "\n";
+  }
+
+  closeInput(reader);
+  return object.converted;
+}
+
+} // namespace
+
+void ContentHasher::add(const AGXParamView &pv)
+{
+  const std::string_view name(pv.name, pv.nameLength);
+  addBytes(name.data(), name.size());
+  addValue(pv.isArray ? pv.elementType : pv.type);
+  addValue(pv.elementCount);
+
+  if (pv.isArray && pv.elementType == ANARI_FLOAT32_VEC3
+      && isPositionParam(name))
+    addPositions(static_cast<const float *>(pv.data), pv.elementCount);
+  else
+    addBytes(pv.data, pv.dataBytes);
+}
+
+void ContentHasher::addTimeStep(uint32_t stepIndex)
+{
+  addValue(stepIndex);
+}
+
+void ContentHasher::addBytes(const void *data, size_t bytes)
+{
+  hashCombine(fingerprint.hash,
+      std::hash<std::string_view>()(
+          std::string_view(static_cast<const char *>(data), bytes)));
+  fingerprint.crc = crc32c(fingerprint.crc, data, bytes);
+  fingerprint.bytes += bytes;
+}
+
+void ContentHasher::addValue(uint64_t value)
+{
+  addBytes(&value, sizeof(value));
+}
+
+void ContentHasher::addPositions(const float *p, size_t count)
+{
+  if (!hasCentroid) {
+    double sum[3] = {0.0, 0.0, 0.0};
+    for (size_t i = 0; i < count; ++i)
+      for (int c = 0; c < 3; ++c)
+        sum[c] += p[3 * i + c];
+    for (int c = 0; c < 3; ++c)
+      centroid[c] = count > 0 ? sum[c] / count : 0.0;
+    hasCentroid = true;
+  }
+
+  quantizePositions(p, count, centroid, tolerance, quantized);
+  addBytes(quantized.data(), quantized.size() * sizeof(int64_t));
+}
+
+void findPrototypes(std::vector<SceneObject> &objects)
+{
+  std::map<ContentFingerprint, size_t> firstOfFingerprint;
+  for (size_t i = 0; i < objects.size(); ++i)
+    objects[i].prototype =
+        firstOfFingerprint.emplace(objects[i].fingerprint, i).first->second;
+
+  for (auto &object : objects)
+    object.instanceCount = 0;
+  for (const auto &object : objects)
+    ++objects[object.prototype].instanceCount;
+  for (auto &object : objects)
+    object.instanceCount = objects[object.prototype].instanceCount;
+}
+
+void defineSceneObjects(const UsdStageRefPtr &stage,
+    const SdfPath &rootPath,
+    const std::vector<SceneObject> &objects)
+{
+  for (const auto &object : objects) {
+    const SceneObject &prototype = objects[object.prototype];
+    auto xform = UsdGeomXform::Define(
+        stage, rootPath.AppendChild(TfToken(object.primName)));
+    UsdPrim prim = xform.GetPrim();
+    prim.GetReferences().AddReference(prototype.assetPath);
+
+    if (object.instanceCount > 1)
+      prim.SetInstanceable(true);
+    const GfVec3d offset = object.centroid - prototype.centroid;
+    if (offset != GfVec3d(0.0, 0.0, 0.0))
+      xform.AddTranslateOp().Set(offset);
+  }
+}
+
+bool convertScene(const std::vector<std::string> &inputPaths,
+    const std::string &outputPath,
+    const ConvertOptions &options)
+{
+  if (inputPaths.empty()) {
+    std::cerr << "Error: No input files for the scene\n";
+    return false;
+  }
+  if (outputPath.size() > 5
+      && outputPath.compare(outputPath.size() - 5, 5, ".usdz") == 0) {
+    std::cerr << "Error: Scenes reference separate object layers and cannot "
+                 "be written as .usdz\n";
+    return false;
+  }
+
+  std::vector<SceneObject> objects = makeSceneObjects(inputPaths, outputPath);
+  for (size_t i = 0; i < objects.size(); ++i)
+    objects[i].prototype = i;
+
+  std::error_code ec;
+  std::filesystem::create_directories(
+      std::filesystem::path(objects.front().layerPath).parent_path(), ec);
+  if (ec) {
+    std::cerr << "Error: Failed to create the object directory: "
+              << ec.message() << "\n";
+    return false;
+  }
+
+  std::atomic<size_t> failed{0};
+  std::vector<size_t> prototypes;
+  if (options.instanceDuplicates) {
+    logInfo("Analyzing {} objects...", objects.size());
+    parallelForEach(objects.size(), [&](size_t i) {
+      if (!analyzeObject(objects[i], options))
+        ++failed;
+    });
+    if (failed > 0) {
+      std::cerr << "Error: " << failed << " of " << objects.size()
+                << " objects failed to read\n";
+      return false;
+    }
+    findPrototypes(objects);
+  }
+  for (size_t i = 0; i < objects.size(); ++i) {
+    if (objects[i].prototype == i)
+      prototypes.push_back(i);
+  }
+
+  // Every prototype goes to its own stage and layer, so they are independent.
+  // They share the resident size, and with it one memory limit.
+  std::unique_ptr<SceneMemoryLimit> memoryLimit;
+  if (options.maxMemoryBytes > 0)
+    memoryLimit = std::make_unique<SceneMemoryLimit>(options.maxMemoryBytes);
+  logInfo("Converting {} of {} objects...", prototypes.size(), objects.size());
+  parallelForEach(prototypes.size(), [&](size_t i) {
+    if (!convertObject(objects[prototypes[i]], options, memoryLimit.get()))
+      ++failed;
+  });
+  if (failed > 0) {
+    std::cerr << "Error: " << failed << " of " << prototypes.size()
+              << " objects failed to convert\n";
+    return false;
+  }
+
+  // The root stage holds nothing but stage metadata and references
+  auto stage = UsdStage::CreateNew(outputPath);
+  if (!stage) {
+    std::cerr << "Error: Failed to create USD stage\n";
+    return false;
+  }
+
+  uint32_t timeSteps = 0;
+  for (const auto &object : objects)
+    timeSteps = std::max(timeSteps, object.timeSteps);
+  auto root = setupStage(stage, timeSteps > 0 ? timeSteps - 1.0 : 0.0);
+
+  // Duplicates become instanceable references to their prototype's layer
+  defineSceneObjects(stage, root.GetPrim().GetPath(), objects);
+
+  logInfo("\nSaving USD scene to: {}", outputPath);
+  TraceSpan span("save", outputPath);
+  if (!stage->GetRootLayer()->Save()) {
+    std::cerr << "Error: Failed to save " << outputPath << "\n";
+    return false;
+  }
+
+  logInfo("Scene complete: {} objects, {} unique",
+      objects.size(),
+      prototypes.size());
+  return true;
+}
+
+} // namespace agx2usd
@@ -0,0 +1,97 @@
+// Copyright 2025
+// SPDX-License-Identifier: Apache-2.0
+
+// Scenes of several AGX files: duplicate detection and the root stage that
+// references the converted objects, see convertScene()
+
+#pragma once
+
+// AGX
+#include "agx/agx_read.h"
+
+// USD
+#include <pxr/base/gf/vec3d.h>
+#include <pxr/usd/sdf/path.h>
+#include <pxr/usd/usd/stage.h>
+
+// std
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace agx2usd {
+
+PXR_NAMESPACE_USING_DIRECTIVE
+
+// Digest of an object in the form duplicates are detected in, see
+// ContentHasher: two independent hashes of the same bytes, and their count.
+// Objects are taken for duplicates when their fingerprints are equal, so
+// neither has to be read again to compare them.
+struct ContentFingerprint
+{
+  uint64_t hash = 0;
+  uint32_t crc = 0;
+  uint64_t bytes = 0;
+
+  bool operator<(const ContentFingerprint &o) const
+  {
+    return std::tie(hash, crc, bytes) < std::tie(o.hash, o.crc, o.bytes);
+  }
+};
+
+// A scene object converted from one input file
+struct SceneObject
+{
+  std::string inputPath;
+  std::string primName;
+  std::string layerPath;
+  std::string assetPath; // relative to the root layer
+  uint32_t timeSteps = 0;
+  bool converted = false;
+
+  // Content fingerprint and first frame centroid, see ContentHasher
+  ContentFingerprint fingerprint;
+  GfVec3d centroid{0.0, 0.0, 0.0};
+  // Index of the object whose layer this one references (itself if unique)
+  size_t prototype = 0;
+  size_t instanceCount = 1;
+};
+
+// Fingerprints the parameters of one object so that copies that only
+// differ by a translation fingerprint equal: positions are hashed relative to
+// the centroid of the first frame, snapped to a grid of 'tolerance'. All
+// other parameters are hashed as they are.
+class ContentHasher
+{
+ public:
+  explicit ContentHasher(float tolerance) : tolerance(tolerance) {}
+
+  void add(const AGXParamView &pv);
+  void addTimeStep(uint32_t stepIndex);
+  void addBytes(const void *data, size_t bytes);
+  void addValue(uint64_t value);
+
+  ContentFingerprint fingerprint;
+  GfVec3d centroid{0.0, 0.0, 0.0};
+
+ private:
+  void addPositions(const float *p, size_t count);
+
+  double tolerance;
+  bool hasCentroid = false;
+  std::vector<int64_t> quantized;
+};
+
+// Objects with equal fingerprints reference the first of them
+void findPrototypes(std::vector<SceneObject> &objects);
+
+// Defines a prim under 'rootPath' for every object that references the
+// layer of its prototype. Duplicates are instanceable and placed by the
+// offset between the two centroids.
+void defineSceneObjects(const UsdStageRefPtr &stage,
+    const SdfPath &rootPath,
+    const std::vector<SceneObject> &objects);
+
+} // namespace agx2usd
@@ -0,0 +1,348 @@
+// Copyright 2025
+// SPDX-License-Identifier: Apache-2.0
+
+#include "simplify.h"
+#include "memory.h"
+
+// std
+#include <algorithm>
+#include <cmath>
+
+namespace agx2usd {
+
+namespace {
+
+// Boundary edges are held in place by planes through them, perpendicular to
+// their triangle, weighted much higher than the surface planes
+constexpr double kBoundaryWeight = 10.0;
+
+// Squared cosine of the largest rotation of a face normal by one collapse
+constexpr double kMinCosine2 = 0.25 * 0.25;
+
+struct Vec3
+{
+  double x, y, z;
+};
+
+Vec3 sub(const Vec3 &a, const Vec3 &b)
+{
+  return {a.x - b.x, a.y - b.y, a.z - b.z};
+}
+
+Vec3 cross(const Vec3 &a, const Vec3 &b)
+{
+  return {a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x};
+}
+
+double dot(const Vec3 &a, const Vec3 &b)
+{
+  return a.x * b.x + a.y * b.y + a.z * b.z;
+}
+
+// Symmetric 4x4 matrix of the squared distance to a set of planes
+struct Quadric
+{
+  double a2 = 0, ab = 0, ac = 0, ad = 0, b2 = 0, bc = 0, bd = 0, c2 = 0,
+         cd = 0, d2 = 0;
+
+  // Plane n.p + d = 0 with unit normal n
+  void addPlane(const Vec3 &n, double d, double weight)
+  {
+    a2 += weight * n.x * n.x;
+    ab += weight * n.x * n.y;
+    ac += weight * n.x * n.z;
+    ad += weight * n.x * d;
+    b2 += weight * n.y * n.y;
+    bc += weight * n.y * n.z;
+    bd += weight * n.y * d;
+    c2 += weight * n.z * n.z;
+    cd += weight * n.z * d;
+    d2 += weight * d * d;
+  }
+
+  void add(const Quadric &q)
+  {
+    a2 += q.a2;
+    ab += q.ab;
+    ac += q.ac;
+    ad += q.ad;
+    b2 += q.b2;
+    bc += q.bc;
+    bd += q.bd;
+    c2 += q.c2;
+    cd += q.cd;
+    d2 += q.d2;
+  }
+
+  double error(const Vec3 &p) const
+  {
+    const double e = a2 * p.x * p.x + b2 * p.y * p.y + c2 * p.z * p.z
+        + 2 * (ab * p.x * p.y + ac * p.x * p.z + bc * p.y * p.z)
+        + 2 * (ad * p.x + bd * p.y + cd * p.z) + d2;
+    return std::fabs(e);
+  }
+};
+
+struct Collapse
+{
+  double cost;
+  uint32_t from;
+  uint32_t to;
+};
+
+uint64_t edgeKey(uint32_t a, uint32_t b)
+{
+  return a < b ? (uint64_t(a) << 32) | b : (uint64_t(b) << 32) | a;
+}
+
+} // namespace
+
+bool MeshSimplifier::compute(const VtArray<GfVec3f> &points,
+    const VtArray<int> &sourceIndices,
+    size_t targetTriangles)
+{
+  valid = false;
+  indices = VtArray<int>();
+  vertexMap.clear();
+
+  const size_t numPoints = points.size();
+  const size_t numIndices = sourceIndices.size() / 3 * 3;
+  std::vector<uint32_t> tris(numIndices);
+  for (size_t i = 0; i < numIndices; ++i) {
+    const int v = sourceIndices[i];
+    if (v < 0 || static_cast<size_t>(v) >= numPoints)
+      return false;
+    tris[i] = static_cast<uint32_t>(v);
+  }
+  sourceCount = numPoints;
+
+  std::vector<Vec3> pos(numPoints);
+  for (size_t v = 0; v < numPoints; ++v)
+    pos[v] = {points[v][0], points[v][1], points[v][2]};
+
+  auto faceNormal = [&](uint32_t a, uint32_t b, uint32_t c) {
+    return cross(sub(pos[b], pos[a]), sub(pos[c], pos[a]));
+  };
+
+  // Area weighted plane quadrics of the input faces
+  std::vector<Quadric> quadrics(numPoints);
+  for (size_t t = 0; t < tris.size(); t += 3) {
+    Vec3 n = faceNormal(tris[t], tris[t + 1], tris[t + 2]);
+    const double length = std::sqrt(dot(n, n));
+    if (length == 0.0)
+      continue;
+    n = {n.x / length, n.y / length, n.z / length};
+    const double d = -dot(n, pos[tris[t]]);
+    for (int k = 0; k < 3; ++k)
+      quadrics[tris[t + k]].addPlane(n, d, 0.5 * length);
+  }
+
+  std::vector<uint32_t> offsets;
+  std::vector<uint32_t> vertexFaces;
+  std::vector<uint64_t> edges;
+  std::vector<uint8_t> boundaryEdge;
+  std::vector<uint8_t> boundaryVertex(numPoints);
+  std::vector<uint8_t> locked(numPoints);
+  std::vector<uint32_t> remap(numPoints);
+  std::vector<Collapse> collapses;
+
+  bool firstPass = true;
+
+  // Each pass collapses a set of independent edges in order of cost, then
+  // rewrites the triangles and builds the adjacency again
+  while (tris.size() / 3 > targetTriangles) {
+    const size_t numFaces = tris.size() / 3;
+
+    offsets.assign(numPoints + 1, 0);
+    for (uint32_t v : tris)
+      ++offsets[v + 1];
+    for (size_t v = 0; v < numPoints; ++v)
+      offsets[v + 1] += offsets[v];
+    std::vector<uint32_t> fill(offsets.begin(), offsets.end() - 1);
+    vertexFaces.resize(tris.size());
+    for (size_t f = 0; f < numFaces; ++f) {
+      for (int k = 0; k < 3; ++k)
+        vertexFaces[fill[tris[3 * f + k]]++] = static_cast<uint32_t>(f);
+    }
+
+    // Edges used by a single face are boundary edges
+    edges.clear();
+    for (size_t f = 0; f < numFaces; ++f) {
+      for (int k = 0; k < 3; ++k)
+        edges.push_back(edgeKey(tris[3 * f + k], tris[3 * f + (k + 1) % 3]));
+    }
+    std::sort(edges.begin(), edges.end());
+    std::fill(boundaryVertex.begin(), boundaryVertex.end(), 0);
+    boundaryEdge.clear();
+    size_t numEdges = 0;
+    for (size_t i = 0; i < edges.size();) {
+      size_t j = i + 1;
+      while (j < edges.size() && edges[j] == edges[i])
+        ++j;
+      const bool boundary = j - i == 1;
+      if (boundary) {
+        boundaryVertex[edges[i] >> 32] = 1;
+        boundaryVertex[edges[i] & 0xffffffffu] = 1;
+      }
+      edges[numEdges++] = edges[i];
+      boundaryEdge.push_back(boundary);
+      i = j;
+    }
+    edges.resize(numEdges);
+
+    // Boundary planes are added once, for the input edges
+    if (firstPass) {
+      for (size_t f = 0; f < numFaces; ++f) {
+        const uint32_t *t = &tris[3 * f];
+        const Vec3 n = faceNormal(t[0], t[1], t[2]);
+        for (int k = 0; k < 3; ++k) {
+          const uint32_t a = t[k];
+          const uint32_t b = t[(k + 1) % 3];
+          const auto edge =
+              std::lower_bound(edges.begin(), edges.end(), edgeKey(a, b));
+          if (!boundaryEdge[edge - edges.begin()])
+            continue;
+          const Vec3 e = sub(pos[b], pos[a]);
+          Vec3 p = cross(e, n);
+          const double length = std::sqrt(dot(p, p));
+          if (length == 0.0)
+            continue;
+          p = {p.x / length, p.y / length, p.z / length};
+          const double weight = kBoundaryWeight * dot(e, e);
+          quadrics[a].addPlane(p, -dot(p, pos[a]), weight);
+          quadrics[b].addPlane(p, -dot(p, pos[a]), weight);
+        }
+      }
+      firstPass = false;
+    }
+
+    // Cheapest direction of every edge. A boundary vertex may only move
+    // along a boundary edge.
+    collapses.resize(numEdges);
+    parallelRange(numEdges, [&](size_t b, size_t e) {
+      for (size_t i = b; i < e; ++i) {
+        const bool boundary = boundaryEdge[i];
+        const auto v0 = static_cast<uint32_t>(edges[i] >> 32);
+        const auto v1 = static_cast<uint32_t>(edges[i] & 0xffffffffu);
+        Quadric q = quadrics[v0];
+        q.add(quadrics[v1]);
+        Collapse c{HUGE_VAL, v0, v1};
+        if (boundary || !boundaryVertex[v0])
+          c = {q.error(pos[v1]), v0, v1};
+        if ((boundary || !boundaryVertex[v1]) && q.error(pos[v0]) < c.cost)
+          c = {q.error(pos[v0]), v1, v0};
+        collapses[i] = c;
+      }
+    });
+    std::sort(collapses.begin(),
+        collapses.end(),
+        [](const Collapse &a, const Collapse &b) { return a.cost < b.cost; });
+
+    // An interior collapse removes two faces
+    const size_t excess = numFaces - targetTriangles;
+    const size_t maxCollapses = std::max<size_t>(1, excess / 2);
+    std::fill(locked.begin(), locked.end(), 0);
+    for (size_t v = 0; v < numPoints; ++v)
+      remap[v] = static_cast<uint32_t>(v);
+
+    size_t numCollapses = 0;
+    for (const Collapse &c : collapses) {
+      if (numCollapses == maxCollapses || c.cost == HUGE_VAL)
+        break;
+      if (locked[c.from] || locked[c.to])
+        continue;
+
+      // Reject collapses that would flip or degenerate a remaining face.
+      // Faces that are degenerate already are compared with the normal of
+      // the vertex instead.
+      const uint32_t *faces = &vertexFaces[offsets[c.from]];
+      const uint32_t numVertexFaces = offsets[c.from + 1] - offsets[c.from];
+      Vec3 vertexNormal{0.0, 0.0, 0.0};
+      for (uint32_t i = 0; i < numVertexFaces; ++i) {
+        const uint32_t *t = &tris[3 * faces[i]];
+        const Vec3 n = faceNormal(t[0], t[1], t[2]);
+        vertexNormal = {vertexNormal.x + n.x, vertexNormal.y + n.y, vertexNormal.z + n.z};
+      }
+      bool flips = false;
+      for (uint32_t i = 0; i < numVertexFaces && !flips; ++i) {
+        const uint32_t *t = &tris[3 * faces[i]];
+        if (t[0] == c.to || t[1] == c.to || t[2] == c.to)
+          continue;
+        uint32_t moved[3] = {t[0], t[1], t[2]};
+        for (uint32_t &v : moved)
+          v = v == c.from ? c.to : v;
+        const Vec3 before = faceNormal(t[0], t[1], t[2]);
+        const Vec3 after = faceNormal(moved[0], moved[1], moved[2]);
+        const double cosine = dot(before, after);
+        if (dot(before, before) > 0.0)
+          flips = cosine <= 0.0
+              || cosine * cosine
+                  < kMinCosine2 * dot(before, before) * dot(after, after);
+        else
+          flips = dot(after, after) > 0.0 && dot(vertexNormal, after) <= 0.0;
+      }
+      if (flips)
+        continue;
+
+      // Faces around both ends change, so none of their vertices may take
+      // part in another collapse of this pass
+      for (uint32_t v : {c.from, c.to}) {
+        for (uint32_t i = offsets[v]; i < offsets[v + 1]; ++i) {
+          const uint32_t *t = &tris[3 * vertexFaces[i]];
+          locked[t[0]] = locked[t[1]] = locked[t[2]] = 1;
+        }
+      }
+      remap[c.from] = c.to;
+      quadrics[c.to].add(quadrics[c.from]);
+      ++numCollapses;
+    }
+    if (numCollapses == 0)
+      break;
+
+    // Drop the faces that collapsed
+    size_t out = 0;
+    for (size_t t = 0; t < tris.size(); t += 3) {
+      const uint32_t a = remap[tris[t]];
+      const uint32_t b = remap[tris[t + 1]];
+      const uint32_t c = remap[tris[t + 2]];
+      if (a == b || b == c || c == a)
+        continue;
+      tris[out++] = a;
+      tris[out++] = b;
+      tris[out++] = c;
+    }
+    tris.resize(out);
+  }
+
+  // Number the remaining vertices in order of first use
+  std::vector<int> newIndex(numPoints, -1);
+  indices.resize(tris.size());
+  for (size_t i = 0; i < tris.size(); ++i) {
+    int &n = newIndex[tris[i]];
+    if (n < 0) {
+      n = static_cast<int>(vertexMap.size());
+      vertexMap.push_back(tris[i]);
+    }
+    indices[i] = n;
+  }
+
+  valid = true;
+  return true;
+}
+
+size_t MeshSimplifier::getBufferBytes() const
+{
+  return arrayBytes(indices) + arrayBytes(vertexMap);
+}
+
+bool MeshSimplifier::isValid() const
+{
+  return valid;
+}
+
+const VtArray<int> &MeshSimplifier::getIndices() const
+{
+  return indices;
+}
+
+} // namespace agx2usd
@@ -0,0 +1,76 @@
+// Copyright 2025
+// SPDX-License-Identifier: Apache-2.0
+
+// Triangle mesh simplification by quadric edge collapse
+
+#pragma once
+
+#include "parallel.h"
+
+// USD
+#include <pxr/pxr.h>
+#include <pxr/base/gf/vec3f.h>
+#include <pxr/base/vt/array.h>
+
+// std
+#include <cstdint>
+#include <vector>
+
+namespace agx2usd {
+
+PXR_NAMESPACE_USING_DIRECTIVE
+
+// Simplifies a triangle mesh with Garland-Heckbert quadric error metrics.
+// Edges are collapsed onto one of their end points (half-edge collapse), so
+// every vertex of the result is a vertex of the input. The simplified mesh
+// can therefore follow any later frame of the same topology by gathering its
+// positions through the vertex map, without simplifying again.
+class MeshSimplifier
+{
+ public:
+  // Simplify 'indices' (3 per triangle) over 'points' towards
+  // 'targetTriangles' triangles. Boundary edges are kept in place and no
+  // collapse may flip a triangle, so the result can stay above the target.
+  bool compute(const VtArray<GfVec3f> &points,
+      const VtArray<int> &indices,
+      size_t targetTriangles);
+
+  bool isValid() const;
+
+  // Bytes of the buffers owned by this object
+  size_t getBufferBytes() const;
+
+  // Indices of the simplified mesh, into its own compacted vertices
+  const VtArray<int> &getIndices() const;
+
+  // Gather one per-vertex array of the input into the simplified vertices.
+  // Arrays that do not cover the input vertices are rejected (false).
+  template <typename T>
+  bool apply(const VtArray<T> &values, VtArray<T> &out) const;
+
+ private:
+  VtArray<int> indices;
+  // Input vertex of every simplified vertex
+  std::vector<uint32_t> vertexMap;
+  size_t sourceCount = 0;
+  bool valid = false;
+};
+
+template <typename T>
+bool MeshSimplifier::apply(const VtArray<T> &values, VtArray<T> &out) const
+{
+  if (!valid || values.size() < sourceCount)
+    return false;
+
+  const T *in = values.cdata();
+  out = VtArray<T>();
+  out.resize(vertexMap.size(), [&](T *begin, T *) {
+    parallelRange(vertexMap.size(), [&](size_t b, size_t e) {
+      for (size_t i = b; i < e; ++i)
+        begin[i] = in[vertexMap[i]];
+    });
+  });
+  return true;
+}
+
+} // namespace agx2usd
@@ -0,0 +1,155 @@
+// Copyright 2025
+// SPDX-License-Identifier: Apache-2.0
+
+#include "trace.h"
+#include "log.h"
+
+// std
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <vector>
+
+namespace agx2usd {
+
+namespace {
+
+struct TraceEvent
+{
+  const char *name;
+  std::string detail;
+  double begin; // microseconds since the start of the trace
+  double duration;
+  uint32_t thread;
+};
+
+struct Trace
+{
+  std::atomic<bool> enabled{false};
+  std::mutex mutex;
+  std::string path;
+  std::chrono::steady_clock::time_point start;
+  std::vector<TraceEvent> events;
+};
+
+Trace &getTrace()
+{
+  static Trace trace;
+  return trace;
+}
+
+// Small sequential ids read better in trace viewers than native thread ids
+uint32_t getThreadId()
+{
+  static std::atomic<uint32_t> next{1};
+  thread_local const uint32_t id = next++;
+  return id;
+}
+
+void writeEscaped(std::ostream &out, std::string_view text)
+{
+  for (char c : text) {
+    if (c == '"' || c == '\\') {
+      out << '\\' << c;
+    } else if (static_cast<unsigned char>(c) < 0x20) {
+      char code[8];
+      std::snprintf(code, sizeof(code), "\\u%04x", c);
+      out << code;
+    } else {
+      out << c;
+    }
+  }
+}
+
+} // namespace
+
+bool startTrace(const std::string &path)
+{
+  Trace &trace = getTrace();
+  std::lock_guard<std::mutex> lock(trace.mutex);
+  if (trace.enabled)
+    return false;
+  trace.path = path;
+  trace.start = std::chrono::steady_clock::now();
+  trace.events.clear();
+  trace.enabled = true;
+  getThreadId(); // the thread that starts the trace is thread 1
+  return true;
+}
+
+bool stopTrace()
+{
+  Trace &trace = getTrace();
+  std::lock_guard<std::mutex> lock(trace.mutex);
+  if (!trace.enabled)
+    return false;
+  trace.enabled = false;
+
+  std::ofstream out(trace.path);
+  if (!out) {
+    std::cerr << "Error: Failed to write trace " << trace.path << "\n";
+    return false;
+  }
+
+  // Microseconds with nanosecond digits, also for runs of many hours
+  out << std::fixed << std::setprecision(3);
+  out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+  out << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"tid\":1,"
+         "\"args\":{\"name\":\"agx2usd\"}}";
+  for (const TraceEvent &event : trace.events) {
+    out << ",\n{\"name\":\"";
+    writeEscaped(out, event.name);
+    out << "\",\"cat\":\"agx2usd\",\"ph\":\"X\",\"pid\":1,\"tid\":"
+        << event.thread << ",\"ts\":" << event.begin
+        << ",\"dur\":" << event.duration;
+    if (!event.detail.empty()) {
+      out << ",\"args\":{\"detail\":\"";
+      writeEscaped(out, event.detail);
+      out << "\"}";
+    }
+    out << "}";
+  }
+  out << "\n]}\n";
+
+  logInfo("Wrote {} trace events to {}", trace.events.size(), trace.path);
+  trace.events = std::vector<TraceEvent>();
+  return static_cast<bool>(out);
+}
+
+bool isTracing()
+{
+  return getTrace().enabled.load(std::memory_order_relaxed);
+}
+
+TraceSpan::TraceSpan(const char *name, std::string_view detail)
+    : name(name), active(isTracing())
+{
+  if (!active)
+    return;
+  this->detail = detail;
+  begin = std::chrono::steady_clock::now();
+}
+
+TraceSpan::~TraceSpan()
+{
+  if (!active)
+    return;
+  const auto end = std::chrono::steady_clock::now();
+
+  Trace &trace = getTrace();
+  std::lock_guard<std::mutex> lock(trace.mutex);
+  if (!trace.enabled)
+    return;
+  using Micro = std::chrono::duration<double, std::micro>;
+  trace.events.push_back({name,
+      std::move(detail),
+      Micro(begin - trace.start).count(),
+      Micro(end - begin).count(),
+      getThreadId()});
+}
+
+} // namespace agx2usd
@@ -0,0 +1,43 @@
+// Copyright 2025
+// SPDX-License-Identifier: Apache-2.0
+
+// Chrome trace event (Perfetto compatible) recording of conversion phases
+
+#pragma once
+
+// std
+#include <chrono>
+#include <string>
+#include <string_view>
+
+namespace agx2usd {
+
+// Record spans from every thread until stopTrace(), which writes them to
+// 'path' as a JSON trace viewable in chrome://tracing or ui.perfetto.dev.
+// Returns false if a trace is already being recorded.
+bool startTrace(const std::string &path);
+bool stopTrace();
+
+bool isTracing();
+
+// Records the lifetime of the object as one complete ("X") event on the
+// calling thread. 'name' must outlive the trace (a string literal); 'detail'
+// is copied into the event arguments, e.g. a parameter name or timestep.
+// When no trace is recorded a span costs one atomic load.
+class TraceSpan
+{
+ public:
+  explicit TraceSpan(const char *name, std::string_view detail = {});
+  ~TraceSpan();
+
+  TraceSpan(const TraceSpan &) = delete;
+  TraceSpan &operator=(const TraceSpan &) = delete;
+
+ private:
+  const char *name;
+  std::string detail;
+  std::chrono::steady_clock::time_point begin;
+  bool active;
+};
+
+} // namespace agx2usd
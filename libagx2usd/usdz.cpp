@@ -0,0 +1,262 @@
+// Copyright 2025
+// SPDX-License-Identifier: Apache-2.0
+
+#include "usdz.h"
+#include "log.h"
+#include "page_cache.h"
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <linux/falloc.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// std
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+namespace agx2usd {
+
+namespace {
+
+// Running CRC-32 (zip polynomial) of a byte range
+uint32_t crc32Update(uint32_t crc, const uint8_t *data, size_t size)
+{
+  static const auto table = []() {
+    std::array<uint32_t, 256> t{};
+    for (uint32_t i = 0; i < 256; ++i) {
+      uint32_t c = i;
+      for (int k = 0; k < 8; ++k)
+        c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+      t[i] = c;
+    }
+    return t;
+  }();
+
+  crc = ~crc;
+  for (size_t i = 0; i < size; ++i)
+    crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+  return ~crc;
+}
+
+void putLE16(std::vector<uint8_t> &out, uint16_t v)
+{
+  out.push_back(uint8_t(v));
+  out.push_back(uint8_t(v >> 8));
+}
+
+void putLE32(std::vector<uint8_t> &out, uint32_t v)
+{
+  putLE16(out, uint16_t(v));
+  putLE16(out, uint16_t(v >> 16));
+}
+
+// The extra field length of a local header is 16 bits
+constexpr size_t kMaxExtraBytes = 0xFFFF;
+
+// Zip local file header for a stored (uncompressed) entry, padded through
+// the extra field to exactly 'headerSize' bytes so the data that follows
+// starts at an aligned offset, as usdz requires. 'headerSize' must leave at
+// most kMaxExtraBytes for the extra field.
+std::vector<uint8_t> makeLocalHeader(const std::string &name,
+    uint32_t crc,
+    uint32_t size,
+    size_t headerSize)
+{
+  std::vector<uint8_t> h;
+  putLE32(h, 0x04034b50); // signature
+  putLE16(h, 20); // version needed to extract
+  putLE16(h, 0); // flags
+  putLE16(h, 0); // compression: stored
+  putLE16(h, 0); // modification time
+  putLE16(h, 0); // modification date
+  putLE32(h, crc);
+  putLE32(h, size); // compressed size
+  putLE32(h, size); // uncompressed size
+  putLE16(h, uint16_t(name.size()));
+  putLE16(h, uint16_t(headerSize - 30 - name.size()));
+  h.insert(h.end(), name.begin(), name.end());
+  // Padding extra field (same header id as USD's own usdz writer)
+  putLE16(h, 0x1986);
+  putLE16(h, uint16_t(headerSize - h.size() - 2));
+  h.resize(headerSize, 0);
+  return h;
+}
+
+// Central directory and end-of-central-directory record for a single entry
+// whose local header is at offset 0
+std::vector<uint8_t> makeCentralDirectory(
+    const std::string &name, uint32_t crc, uint32_t size, uint32_t cdOffset)
+{
+  std::vector<uint8_t> cd;
+  putLE32(cd, 0x02014b50); // signature
+  putLE16(cd, 20); // version made by
+  putLE16(cd, 20); // version needed to extract
+  putLE16(cd, 0); // flags
+  putLE16(cd, 0); // compression: stored
+  putLE16(cd, 0); // modification time
+  putLE16(cd, 0); // modification date
+  putLE32(cd, crc);
+  putLE32(cd, size);
+  putLE32(cd, size);
+  putLE16(cd, uint16_t(name.size()));
+  putLE16(cd, 0); // extra field length
+  putLE16(cd, 0); // comment length
+  putLE16(cd, 0); // disk number
+  putLE16(cd, 0); // internal attributes
+  putLE32(cd, 0); // external attributes
+  putLE32(cd, 0); // local header offset
+  cd.insert(cd.end(), name.begin(), name.end());
+
+  const uint32_t cdSize = uint32_t(cd.size());
+  putLE32(cd, 0x06054b50); // end of central directory
+  putLE16(cd, 0); // this disk
+  putLE16(cd, 0); // disk with central directory
+  putLE16(cd, 1); // entries on this disk
+  putLE16(cd, 1); // total entries
+  putLE32(cd, cdSize);
+  putLE32(cd, cdOffset);
+  putLE16(cd, 0); // comment length
+  return cd;
+}
+
+} // namespace
+
+bool writeUsdzPackage(const std::string &layerPath,
+    const std::string &usdzPath,
+    bool bypassPageCache)
+{
+  // usdz readers do not support Zip64
+  constexpr uint64_t maxEntrySize = 0xFFFFFFFFull - 4096;
+  constexpr size_t chunkSize = 4 << 20;
+  constexpr size_t usdzAlignment = 64;
+
+  std::string name = usdzPath.substr(usdzPath.find_last_of("/\\") + 1);
+  name = name.substr(0, name.size() - 5) + ".usdc";
+
+  std::ifstream in(layerPath, std::ios::binary | std::ios::ate);
+  if (!in) {
+    std::cerr << "Error: Failed to open " << layerPath << "\n";
+    return false;
+  }
+  const uint64_t size = uint64_t(in.tellg());
+  in.seekg(0);
+  if (size > maxEntrySize) {
+    std::cerr << "Error: Layer is too large for a usdz package (" << size
+              << " bytes)\n";
+    return false;
+  }
+
+  std::vector<uint8_t> buffer(chunkSize);
+
+#ifdef __linux__
+  {
+    int fd = ::open(layerPath.c_str(), O_RDWR);
+    struct stat st{};
+    if (fd >= 0 && ::fstat(fd, &st) == 0 && st.st_blksize > 0) {
+      const size_t block = size_t(st.st_blksize);
+      const size_t headerSize = (30 + name.size() + 4 + block - 1) / block * block;
+      // Blocks of 64 KiB or more do not fit the extra field; those files
+      // are copied instead
+      if (headerSize - 30 - name.size() <= kMaxExtraBytes
+          && ::fallocate(fd, FALLOC_FL_INSERT_RANGE, 0, off_t(headerSize)) == 0) {
+        // The crate was just saved, so its pages are still dirty: they are
+        // written back and dropped behind the CRC pass
+        auto writeBehind =
+            bypassPageCache ? WriteBehind::create(layerPath) : nullptr;
+        if (writeBehind)
+          writeBehind->advance(headerSize);
+
+        // CRC of the crate, which now starts at 'headerSize'
+        uint32_t crc = 0;
+        uint64_t offset = headerSize;
+        while (offset < headerSize + size) {
+          const ssize_t n = ::pread(fd, buffer.data(), buffer.size(), off_t(offset));
+          if (n <= 0)
+            break;
+          crc = crc32Update(crc, buffer.data(), size_t(n));
+          offset += uint64_t(n);
+          if (writeBehind)
+            writeBehind->advance(uint64_t(n));
+        }
+
+        const auto header = makeLocalHeader(name, crc, uint32_t(size), headerSize);
+        const auto cd = makeCentralDirectory(
+            name, crc, uint32_t(size), uint32_t(headerSize + size));
+        const bool ok = offset == headerSize + size
+            && ::pwrite(fd, header.data(), header.size(), 0) == ssize_t(header.size())
+            && ::pwrite(fd, cd.data(), cd.size(), off_t(headerSize + size))
+                == ssize_t(cd.size());
+        ::close(fd);
+        if (!ok || std::rename(layerPath.c_str(), usdzPath.c_str()) != 0) {
+          std::cerr << "Error: Failed to write usdz package " << usdzPath << "\n";
+          // Half rewritten, so not a crate anymore either
+          std::remove(layerPath.c_str());
+          return false;
+        }
+        return true;
+      }
+    }
+    if (fd >= 0)
+      ::close(fd);
+  }
+#endif
+
+  // Fallback: stream the crate into a new package. The header is written
+  // with a zero CRC first and patched once the data has been copied.
+  logDebug("Copying {} into {}: cannot insert the zip header in place",
+      layerPath,
+      usdzPath);
+  const size_t headerSize =
+      (30 + name.size() + 4 + usdzAlignment - 1) / usdzAlignment * usdzAlignment;
+  std::ofstream out(usdzPath, std::ios::binary | std::ios::trunc);
+  if (!out) {
+    std::cerr << "Error: Failed to create " << usdzPath << "\n";
+    return false;
+  }
+
+  auto writeBehind = bypassPageCache ? WriteBehind::create(usdzPath) : nullptr;
+
+  auto header = makeLocalHeader(name, 0, uint32_t(size), headerSize);
+  out.write(reinterpret_cast<const char *>(header.data()), header.size());
+
+  uint32_t crc = 0;
+  uint64_t copied = 0;
+  while (in && copied < size) {
+    in.read(reinterpret_cast<char *>(buffer.data()), buffer.size());
+    const size_t n = size_t(in.gcount());
+    crc = crc32Update(crc, buffer.data(), n);
+    out.write(reinterpret_cast<const char *>(buffer.data()), n);
+    copied += n;
+    if (writeBehind) {
+      // Only what reached the file can be written back
+      out.flush();
+      writeBehind->advance(n);
+    }
+  }
+
+  const auto cd = makeCentralDirectory(
+      name, crc, uint32_t(size), uint32_t(headerSize + size));
+  out.write(reinterpret_cast<const char *>(cd.data()), cd.size());
+  header = makeLocalHeader(name, crc, uint32_t(size), headerSize);
+  out.seekp(0);
+  out.write(reinterpret_cast<const char *>(header.data()), header.size());
+  out.close();
+  in.close();
+  writeBehind.reset();
+
+  if (copied != size || !out) {
+    std::cerr << "Error: Failed to write usdz package " << usdzPath << "\n";
+    std::remove(usdzPath.c_str());
+    return false;
+  }
+  std::remove(layerPath.c_str());
+  return true;
+}
+
+} // namespace agx2usd
@@ -0,0 +1,23 @@
+// Copyright 2025
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+// std
+#include <string>
+
+namespace agx2usd {
+
+// Turn the saved crate at 'layerPath' into the usdz package 'usdzPath'.
+//
+// On Linux the zip header is inserted in front of the crate in place
+// (FALLOC_FL_INSERT_RANGE), so the crate is read once for its CRC but never
+// rewritten. Where the filesystem does not support that, the crate is
+// streamed into the package in a single pass. The crate file is consumed.
+// With 'bypassPageCache', the package is written back and dropped from the
+// page cache as it is written (see WriteBehind).
+bool writeUsdzPackage(const std::string &layerPath,
+    const std::string &usdzPath,
+    bool bypassPageCache);
+
+} // namespace agx2usd
@@ -1,409 +1,279 @@
 // Copyright 2025
 // SPDX-License-Identifier: Apache-2.0
 
-// AGX to USD Converter - Converts animated geometry from AGX format to USD
+// AGX to USD Converter - command line front end of libagx2usd
 
-// AGX
-#define AGX_READ_IMPL
-#include "agx/agx_read.h"
-
-// USD
-#include <pxr/pxr.h>
-#include <pxr/usd/usd/stage.h>
-#include <pxr/usd/usdGeom/mesh.h>
-#include <pxr/usd/usdGeom/points.h>
-#include <pxr/usd/usdGeom/xform.h>
-#include <pxr/usd/usdGeom/primvarsAPI.h>
-#include <pxr/usd/usdGeom/metrics.h>
-#include <pxr/base/vt/array.h>
-#include <pxr/base/gf/vec2f.h>
-#include <pxr/base/gf/vec3f.h>
-#include <pxr/base/gf/vec4f.h>
-#include <pxr/base/tf/token.h>
+#include "agx2usd.h"
+#include "input.h"
+#include "log.h"
+#include "memory.h"
+#include "read_ahead.h"
+#include "trace.h"
 
 // std
+#include <cstdlib>
 #include <iostream>
 #include <string>
 #include <vector>
-#include <map>
-#include <cstring>
-
-PXR_NAMESPACE_USING_DIRECTIVE
 
 namespace {
 
-// Helper to convert AGX parameter name to a valid USD attribute name
-std::string makeValidAttrName(const std::string &name)
+// Append the comma separated, non-empty items of 'list' to 'items'
+void appendList(const std::string &list, std::vector<std::string> &items)
 {
-  std::string result = name;
-  // Replace '.' with '_' for USD attribute names
-  for (char &c : result) {
-    if (c == '.')
-      c = '_';
+  size_t begin = 0;
+  while (begin <= list.size()) {
+    size_t end = list.find(',', begin);
+    if (end == std::string::npos)
+      end = list.size();
+    if (end > begin)
+      items.push_back(list.substr(begin, end - begin));
+    begin = end + 1;
   }
-  return result;
 }
 
-// Helper to extract parameter name as std::string
-std::string getParamName(const AGXParamView &pv)
+// Convert the inputs named on the command line, returns the exit code
+int run(const std::vector<const char *> &positional,
+    bool scene,
+    const agx2usd::ConvertOptions &options)
 {
-  return std::string(pv.name, pv.nameLength);
-}
+  if (scene) {
+    const std::vector<std::string> inputPaths(
+        positional.begin(), positional.end() - 1);
+    const std::string outputPath = positional.back();
+    // Scene inputs are read twice, to find duplicates and to convert them
+    for (const auto &path : inputPaths) {
+      if (path == "-") {
+        std::cerr << "Error: --scene cannot read standard input\n";
+        return 1;
+      }
+    }
 
-// Structure to hold mesh data for a single timestep
-struct MeshData
-{
-  std::vector<GfVec3f> vertices;
-  std::vector<int> faceVertexCounts;
-  std::vector<int> faceVertexIndices;
-  std::vector<GfVec3f> normals;
-  std::vector<GfVec2f> uvs;
-  bool hasNormals = false;
-  bool hasUVs = false;
-};
+    agx2usd::logInfo("AGX to USD Converter");
+    agx2usd::logInfo("====================");
+    agx2usd::logInfo("Inputs: {} files", inputPaths.size());
+    agx2usd::logInfo("Output: {}\n", outputPath);
 
-// Convert AGX mesh data to USD mesh
-bool convertToUSDMesh(AGXReader reader, const std::string &outputPath)
-{
-  // Read header
-  AGXHeader hdr{};
-  if (agxReaderGetHeader(reader, &hdr) != 0) {
-    std::cerr << "Error: Failed to read AGX header\n";
-    return false;
+    return agx2usd::convertScene(inputPaths, outputPath, options) ? 0 : 3;
   }
 
-  std::cout << "AGX File Info:\n";
-  std::cout << "  Version: " << hdr.version << "\n";
-  std::cout << "  Time Steps: " << hdr.timeSteps << "\n";
-  std::cout << "  Constants: " << hdr.constantParamCount << "\n";
-  std::cout << "  Object Type: " << anari::toString(hdr.objectType) << "\n";
+  const char *inputPath = positional[0];
+  const char *outputPath = positional[1];
 
-  const char *subtype = agxReaderGetSubtype(reader);
-  if (subtype && strlen(subtype) > 0) {
-    std::cout << "  Subtype: " << subtype << "\n";
-  }
+  agx2usd::logInfo("AGX to USD Converter");
+  agx2usd::logInfo("====================");
+  agx2usd::logInfo("Input:  {}", inputPath);
+  agx2usd::logInfo("Output: {}\n", outputPath);
 
-  // Create USD stage (binary format with .usdc extension)
-  auto stage = UsdStage::CreateNew(outputPath);
-  if (!stage) {
-    std::cerr << "Error: Failed to create USD stage\n";
-    return false;
+  // Open AGX file
+  AGXReader reader = nullptr;
+  {
+    agx2usd::TraceSpan span("open", inputPath);
+    reader = agx2usd::openInput(inputPath, options);
+  }
+  if (!reader) {
+    agx2usd::flushLog();
+    std::cerr << "Error: Failed to open AGX file: " << inputPath << "\n";
+    return 2;
   }
 
-  // Set standard USD metadata
-  UsdGeomSetStageUpAxis(stage, TfToken("Y"));       // Y-up coordinate system
-  UsdGeomSetStageMetersPerUnit(stage, 1.0);          // 1 unit = 1 meter
-  
-  // Set up time code settings
-  double startTime = 0.0;
-  double endTime = static_cast<double>(hdr.timeSteps > 0 ? hdr.timeSteps - 1 : 0);
-  stage->SetStartTimeCode(startTime);
-  stage->SetEndTimeCode(endTime);
-  stage->SetTimeCodesPerSecond(24.0); // Standard framerate
-  stage->SetFramesPerSecond(24.0);
-
-  // Create root transform
-  auto xform = UsdGeomXform::Define(stage, SdfPath("/Geometry"));
-  
-  // Set as default prim for the stage
-  stage->SetDefaultPrim(xform.GetPrim());
-
-  // Create mesh
-  auto mesh = UsdGeomMesh::Define(stage, SdfPath("/Geometry/mesh"));
+  // Convert to USD
+  bool success = agx2usd::convertToFile(reader, outputPath, options);
 
-  // Store constant parameters
-  std::map<std::string, std::vector<uint8_t>> constants;
+  // Cleanup
+  agx2usd::closeInput(reader);
 
-  // Read constant parameters
-  std::cout << "\nReading constant parameters...\n";
-  agxReaderResetConstants(reader);
-  AGXParamView pv{};
-  
-  std::vector<int> constantIndices;
-  
-  while (true) {
-    int rc = agxReaderNextConstant(reader, &pv);
-    if (rc < 0) {
-      std::cerr << "Error reading constant parameters\n";
-      return false;
-    }
-    if (rc == 0)
-      break;
+  return success ? 0 : 3;
+}
 
-    std::string paramName = getParamName(pv);
-    std::cout << "  " << paramName;
-    
-    if (!pv.isArray) {
-      std::cout << " (scalar, type=" << anari::toString(pv.type) << ")\n";
-    } else {
-      std::cout << " (array, type=" << anari::toString(pv.elementType) 
-                << ", count=" << pv.elementCount << ")\n";
-      
-      // Store array data for later use
-      std::vector<uint8_t> data(pv.dataBytes);
-      std::memcpy(data.data(), pv.data, pv.dataBytes);
-      constants[paramName] = std::move(data);
+} // namespace
 
-      // Handle indices specially (topology is often constant)
-      if (paramName == "primitive.index" || paramName == "index" || 
-          paramName == "primitive.indices" || paramName == "indices") {
-        
-        if (pv.elementType == ANARI_UINT32_VEC3 || pv.elementType == ANARI_UINT32) {
-          const uint32_t *indexData = reinterpret_cast<const uint32_t *>(pv.data);
-          size_t numIndices = pv.dataBytes / sizeof(uint32_t);
-          
-          VtArray<int> indices(numIndices);
-          for (size_t i = 0; i < numIndices; ++i) {
-            indices[i] = static_cast<int>(indexData[i]);
-          }
-          
-          mesh.GetFaceVertexIndicesAttr().Set(indices);
-          
-          // If these are triangle indices, set face vertex counts
-          if (pv.elementType == ANARI_UINT32_VEC3 || (numIndices % 3 == 0)) {
-            size_t numFaces = numIndices / 3;
-            VtArray<int> faceCounts(numFaces, 3);
-            mesh.GetFaceVertexCountsAttr().Set(faceCounts);
-            std::cout << "    -> Set as mesh topology (" << numFaces << " triangles)\n";
-          }
-        }
+int main(int argc, char **argv)
+{
+  agx2usd::ConvertOptions options;
+  bool scene = false;
+  std::string tracePath;
+  std::vector<const char *> positional;
+
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    if (arg == "--scene") {
+      scene = true;
+    } else if (arg == "--log-level" && i + 1 < argc) {
+      agx2usd::LogLevel level;
+      if (!agx2usd::parseLogLevel(argv[++i], level)) {
+        std::cerr << "Error: --log-level expects quiet, info, debug or trace\n";
+        return 1;
       }
-    }
-  }
-
-  // Process time steps
-  std::cout << "\nProcessing time steps...\n";
-  agxReaderResetTimeSteps(reader);
-  
-  uint32_t stepIndex = 0;
-  uint32_t paramCount = 0;
-  
-  while (agxReaderBeginNextTimeStep(reader, &stepIndex, &paramCount) == 1) {
-    std::cout << "Time step " << stepIndex << " (" << paramCount << " parameters)\n";
-    double timeCode = static_cast<double>(stepIndex);
-    
-    // Read parameters for this timestep
-    while (true) {
-      int rc = agxReaderNextTimeStepParam(reader, &pv);
-      if (rc < 0) {
-        std::cerr << "Error reading timestep parameters\n";
-        return false;
+      agx2usd::setLogLevel(level);
+    } else if (arg == "--quiet") {
+      agx2usd::setLogLevel(agx2usd::LogLevel::Quiet);
+    } else if (arg == "--trace" && i + 1 < argc) {
+      tracePath = argv[++i];
+    } else if (arg == "--include" && i + 1 < argc) {
+      appendList(argv[++i], options.includeParams);
+    } else if (arg == "--exclude" && i + 1 < argc) {
+      appendList(argv[++i], options.excludeParams);
+    } else if (arg == "--read-ahead" && i + 1 < argc) {
+      char *end = nullptr;
+      const long mib = std::strtol(argv[++i], &end, 10);
+      if (*end != '\0' || mib < 0 || mib > agx2usd::kMaxReadAheadMiB) {
+        std::cerr << "Error: --read-ahead expects MiB from 0 to "
+                  << agx2usd::kMaxReadAheadMiB << "\n";
+        return 1;
       }
-      if (rc == 0)
-        break;
-
-      std::string paramName = getParamName(pv);
-      
-      // Handle vertex positions
-      if (paramName == "vertex.position" || paramName == "position" || 
-          paramName == "vertex.positions" || paramName == "positions") {
-        
-        if (pv.isArray && pv.elementType == ANARI_FLOAT32_VEC3) {
-          const float *posData = reinterpret_cast<const float *>(pv.data);
-          size_t numVerts = pv.elementCount;
-          
-          VtArray<GfVec3f> points(numVerts);
-          for (size_t i = 0; i < numVerts; ++i) {
-            points[i] = GfVec3f(posData[i * 3 + 0], 
-                                posData[i * 3 + 1], 
-                                posData[i * 3 + 2]);
-          }
-          
-          mesh.GetPointsAttr().Set(points, timeCode);
-          std::cout << "  -> Set " << numVerts << " vertex positions at time " << timeCode << "\n";
-        }
+      options.readAheadMiB = static_cast<uint32_t>(mib);
+    } else if (arg == "--bypass-page-cache") {
+      options.bypassPageCache = true;
+    } else if (arg == "--checksums") {
+      options.verifyChecksums = true;
+    } else if (arg == "--max-memory" && i + 1 < argc) {
+      if (!agx2usd::parseByteSize(argv[++i], options.maxMemoryBytes)) {
+        std::cerr << "Error: --max-memory expects a size such as 800M or 16G\n";
+        return 1;
       }
-      // Handle normals
-      else if (paramName == "vertex.normal" || paramName == "normal" || 
-               paramName == "vertex.normals" || paramName == "normals") {
-        
-        if (pv.isArray && pv.elementType == ANARI_FLOAT32_VEC3) {
-          const float *normData = reinterpret_cast<const float *>(pv.data);
-          size_t numNormals = pv.elementCount;
-          
-          VtArray<GfVec3f> normals(numNormals);
-          for (size_t i = 0; i < numNormals; ++i) {
-            normals[i] = GfVec3f(normData[i * 3 + 0], 
-                                 normData[i * 3 + 1], 
-                                 normData[i * 3 + 2]);
-          }
-          
-          auto normalsAttr = mesh.GetNormalsAttr();
-          normalsAttr.Set(normals, timeCode);
-          mesh.SetNormalsInterpolation(UsdGeomTokens->vertex);
-          std::cout << "  -> Set " << numNormals << " normals at time " << timeCode << "\n";
-        }
+    } else if (arg == "--no-instancing") {
+      options.instanceDuplicates = false;
+    } else if (arg == "--instance-tolerance" && i + 1 < argc) {
+      char *end = nullptr;
+      options.instanceTolerance = std::strtof(argv[++i], &end);
+      if (*end != '\0' || !(options.instanceTolerance > 0.f)) {
+        std::cerr << "Error: --instance-tolerance expects a positive number\n";
+        return 1;
       }
-      // Handle vertex.attribute0 as primvar (for shading/coloring)
-      else if (paramName == "vertex.attribute0" || paramName == "attribute0") {
-        
-        if (pv.isArray) {
-          UsdGeomPrimvarsAPI primvarsAPI(mesh);
-          
-          // Handle different attribute types
-          if (pv.elementType == ANARI_FLOAT32) {
-            // Scalar attribute (e.g., for color mapping)
-            const float *data = reinterpret_cast<const float *>(pv.data);
-            VtArray<float> values(pv.elementCount);
-            for (size_t i = 0; i < pv.elementCount; ++i) {
-              values[i] = data[i];
-            }
-            
-            auto primvar = primvarsAPI.CreatePrimvar(TfToken("attribute0"), 
-                                             SdfValueTypeNames->FloatArray,
-                                             UsdGeomTokens->vertex);
-            primvar.Set(values, timeCode);
-            std::cout << "  -> Set scalar attribute0 (" << pv.elementCount << " values) at time " << timeCode << "\n";
-          }
-          else if (pv.elementType == ANARI_FLOAT32_VEC2) {
-            // Vec2 attribute (e.g., UVs)
-            const float *data = reinterpret_cast<const float *>(pv.data);
-            VtArray<GfVec2f> values(pv.elementCount);
-            for (size_t i = 0; i < pv.elementCount; ++i) {
-              values[i] = GfVec2f(data[i * 2 + 0], data[i * 2 + 1]);
-            }
-            
-            auto primvar = primvarsAPI.CreatePrimvar(TfToken("attribute0"), 
-                                             SdfValueTypeNames->Float2Array,
-                                             UsdGeomTokens->vertex);
-            primvar.Set(values, timeCode);
-            std::cout << "  -> Set vec2 attribute0 (" << pv.elementCount << " values) at time " << timeCode << "\n";
-          }
-          else if (pv.elementType == ANARI_FLOAT32_VEC3) {
-            // Vec3 attribute (e.g., colors)
-            const float *data = reinterpret_cast<const float *>(pv.data);
-            VtArray<GfVec3f> values(pv.elementCount);
-            for (size_t i = 0; i < pv.elementCount; ++i) {
-              values[i] = GfVec3f(data[i * 3 + 0], data[i * 3 + 1], data[i * 3 + 2]);
-            }
-            
-            auto primvar = primvarsAPI.CreatePrimvar(TfToken("attribute0"), 
-                                             SdfValueTypeNames->Float3Array,
-                                             UsdGeomTokens->vertex);
-            primvar.Set(values, timeCode);
-            std::cout << "  -> Set vec3 attribute0 (" << pv.elementCount << " values) at time " << timeCode << "\n";
-          }
-          else if (pv.elementType == ANARI_FLOAT32_VEC4) {
-            // Vec4 attribute (e.g., RGBA colors)
-            const float *data = reinterpret_cast<const float *>(pv.data);
-            VtArray<GfVec4f> values(pv.elementCount);
-            for (size_t i = 0; i < pv.elementCount; ++i) {
-              values[i] = GfVec4f(data[i * 4 + 0], data[i * 4 + 1], data[i * 4 + 2], data[i * 4 + 3]);
-            }
-            
-            auto primvar = primvarsAPI.CreatePrimvar(TfToken("attribute0"), 
-                                             SdfValueTypeNames->Float4Array,
-                                             UsdGeomTokens->vertex);
-            primvar.Set(values, timeCode);
-            std::cout << "  -> Set vec4 attribute0 (" << pv.elementCount << " values) at time " << timeCode << "\n";
-          }
-        }
+    } else if (arg == "--quantize-positions") {
+      options.quantizePositions = true;
+    } else if (arg == "--position-precision" && i + 1 < argc) {
+      char *end = nullptr;
+      options.positionPrecision = std::strtof(argv[++i], &end);
+      if (*end != '\0' || !(options.positionPrecision > 0.f)) {
+        std::cerr << "Error: --position-precision expects a positive number\n";
+        return 1;
       }
-      // Handle UVs (separate from attribute0)
-      else if (paramName == "uv" || paramName == "vertex.uv" || paramName == "texcoord") {
-        
-        if (pv.isArray && pv.elementType == ANARI_FLOAT32_VEC2) {
-          const float *uvData = reinterpret_cast<const float *>(pv.data);
-          size_t numUVs = pv.elementCount;
-          
-          VtArray<GfVec2f> uvs(numUVs);
-          for (size_t i = 0; i < numUVs; ++i) {
-            uvs[i] = GfVec2f(uvData[i * 2 + 0], uvData[i * 2 + 1]);
-          }
-          
-          // Create primvar for UVs
-          UsdGeomPrimvarsAPI primvarsAPI(mesh);
-          auto primvar = primvarsAPI.CreatePrimvar(TfToken("st"), 
-                                           SdfValueTypeNames->Float2Array,
-                                           UsdGeomTokens->vertex);
-          primvar.Set(uvs, timeCode);
-          std::cout << "  -> Set " << numUVs << " UVs at time " << timeCode << "\n";
-        }
+    } else if (arg == "--delta-encode" && i + 1 < argc) {
+      char *end = nullptr;
+      const long interval = std::strtol(argv[++i], &end, 10);
+      if (*end != '\0' || interval < 1) {
+        std::cerr << "Error: --delta-encode expects a keyframe interval >= 1\n";
+        return 1;
       }
-      // Handle triangle indices (topology can change per timestep)
-      else if (paramName == "primitive.index" || paramName == "index" || 
-               paramName == "primitive.indices" || paramName == "indices") {
-        
-        if (pv.isArray && pv.elementType == ANARI_UINT32_VEC3) {
-          const uint32_t *indexData = reinterpret_cast<const uint32_t *>(pv.data);
-          size_t numIndices = pv.elementCount * 3; // VEC3 = 3 indices per triangle
-          
-          VtArray<int> indices(numIndices);
-          for (size_t i = 0; i < numIndices; ++i) {
-            indices[i] = static_cast<int>(indexData[i]);
-          }
-          
-          mesh.GetFaceVertexIndicesAttr().Set(indices, timeCode);
-          
-          // Set face vertex counts (all triangles = 3 vertices each)
-          size_t numFaces = pv.elementCount;
-          VtArray<int> faceCounts(numFaces, 3);
-          mesh.GetFaceVertexCountsAttr().Set(faceCounts, timeCode);
-          
-          std::cout << "  -> Set mesh topology (" << numFaces << " triangles) at time " << timeCode << "\n";
-        }
+      options.deltaKeyInterval = static_cast<uint32_t>(interval);
+    } else if (arg == "--delta-precision" && i + 1 < argc) {
+      char *end = nullptr;
+      options.deltaPrecision = std::strtof(argv[++i], &end);
+      if (*end != '\0' || !(options.deltaPrecision > 0.f)) {
+        std::cerr << "Error: --delta-precision expects a positive number\n";
+        return 1;
       }
-      // Handle generic time parameter
-      else if (paramName == "time") {
-        if (!pv.isArray && pv.elementType == ANARI_UNKNOWN) {
-          // Single value - might be useful for custom attributes
-          std::cout << "  -> Time value parameter\n";
-        }
+    } else if (arg == "--oct-normals" && i + 1 < argc) {
+      const std::string bits = argv[++i];
+      if (bits != "16" && bits != "8") {
+        std::cerr << "Error: --oct-normals expects 16 or 8\n";
+        return 1;
       }
-      // Handle other arrays as custom primvars
-      else if (pv.isArray) {
-        std::cout << "  -> Custom array: " << paramName 
-                  << " (type=" << anari::toString(pv.elementType) 
-                  << ", count=" << pv.elementCount << ")\n";
-        
-        // Could add custom primvars here for other attributes
+      options.octNormalBits = static_cast<uint32_t>(std::stoul(bits));
+    } else if (arg == "--optimize-vertex-order") {
+      options.optimizeVertexOrder = true;
+    } else if (arg == "--lod" && i + 1 < argc) {
+      // Comma separated triangle fractions, e.g. 0.25,0.05
+      const char *list = argv[++i];
+      char *end = nullptr;
+      do {
+        const float ratio = std::strtof(list, &end);
+        if (end == list || !(ratio > 0.f && ratio < 1.f)
+            || (*end != ',' && *end != '\0')) {
+          std::cerr << "Error: --lod expects fractions between 0 and 1\n";
+          return 1;
+        }
+        options.lodRatios.push_back(ratio);
+        list = end + 1;
+      } while (*end == ',');
+    } else if (arg == "--compute-normals") {
+      options.computeNormals = true;
+    } else if (arg == "--sort-points") {
+      options.sortPoints = true;
+    } else if (arg == "--detect-rigid" && i + 1 < argc) {
+      char *end = nullptr;
+      options.rigidTolerance = std::strtof(argv[++i], &end);
+      if (*end != '\0' || !(options.rigidTolerance > 0.f)) {
+        std::cerr << "Error: --detect-rigid expects a positive tolerance\n";
+        return 1;
       }
+    } else if (arg.size() > 2 && arg.compare(0, 2, "--") == 0) {
+      std::cerr << "Error: Unknown or incomplete option: " << arg << "\n";
+      return 1;
+    } else {
+      positional.push_back(argv[i]);
     }
   }
 
-  // Save the stage
-  std::cout << "\nSaving USD file to: " << outputPath << "\n";
-  stage->GetRootLayer()->Save();
-  
-  std::cout << "Conversion complete!\n";
-  std::cout << "Time range: " << startTime << " to " << endTime << "\n";
-  
-  return true;
-}
-
-} // anonymous namespace
-
-int main(int argc, char **argv)
-{
-  if (argc < 3) {
-    std::cerr << "Usage: " << argv[0] << " <input.agx> <output.usdc>\n";
+  if (positional.size() < 2 || (!scene && positional.size() != 2)) {
+    std::cerr << "Usage: " << argv[0] << " [options] <input.agx> <output.usdc|usdz>\n";
+    std::cerr << "       " << argv[0] << " [options] --scene <input.agx>... <output.usd[ca]>\n";
     std::cerr << "\n";
     std::cerr << "Converts AGX animated geometry files to USD binary format.\n";
-    std::cerr << "The output file should have a .usdc extension for binary format.\n";
+    std::cerr << "The input can be - to read standard input, or a FIFO. It is buffered in\n";
+    std::cerr << "memory in full before converting (up to --max-memory).\n";
+    std::cerr << "The output file should have a .usdc extension for binary format,\n";
+    std::cerr << "or .usdz to write a package directly.\n";
+    std::cerr << "\n";
+    std::cerr << "With --scene, each input becomes one object of a scene whose\n";
+    std::cerr << "root stage references the converted object layers.\n";
+    std::cerr << "\n";
+    std::cerr << "Options:\n";
+    std::cerr << "  --scene                     Assemble a scene from several inputs\n";
+    std::cerr << "  --log-level <level>         quiet, info (default), debug (every\n";
+    std::cerr << "                              timestep) or trace (every parameter)\n";
+    std::cerr << "  --quiet                     Same as --log-level quiet\n";
+    std::cerr << "  --trace <out.json>          Write a Chrome/Perfetto trace of the run\n";
+    std::cerr << "  --include <p1,p2,...>       Only convert and write parameters matching\n";
+    std::cerr << "                              these glob patterns, e.g. 'vertex.*'\n";
+    std::cerr << "  --exclude <p1,p2,...>       Do not convert or write parameters\n";
+    std::cerr << "                              matching these patterns\n";
+    std::cerr << "  --read-ahead <MiB>          MiB of input requested ahead of the\n";
+    std::cerr << "                              converter (default 0 = off, max 128)\n";
+    std::cerr << "  --bypass-page-cache         Drop the input from the page cache as it\n";
+    std::cerr << "                              is read, a .usdz as it is packaged, a\n";
+    std::cerr << "                              .usdc once it is saved\n";
+    std::cerr << "  --checksums                 Verify per-timestep CRC32C against\n";
+    std::cerr << "                              <input>.crc32c, or write it\n";
+    std::cerr << "  --max-memory <size>         Stop early if the conversion will run out\n";
+    std::cerr << "                              of memory (e.g. 16G), also the limit of\n";
+    std::cerr << "                              compressed and streamed input in memory\n";
+    std::cerr << "  --no-instancing             Do not instance duplicate scene objects\n";
+    std::cerr << "  --instance-tolerance <eps>  Position tolerance of duplicates (default 1e-5)\n";
+    std::cerr << "  --quantize-positions        Store positions as 16-bit integers\n";
+    std::cerr << "                              relative to per-frame bounds\n";
+    std::cerr << "  --position-precision <eps>  Snap positions to a grid of spacing eps\n";
+    std::cerr << "  --delta-encode <K>          Write positions and normals as keyframes\n";
+    std::cerr << "                              every K steps plus quantized deltas\n";
+    std::cerr << "  --delta-precision <eps>     Quantization step of the deltas (default 1e-5)\n";
+    std::cerr << "  --oct-normals <16|8>        Store normals octahedrally encoded with\n";
+    std::cerr << "                              16 or 8 bits per coordinate\n";
+    std::cerr << "  --optimize-vertex-order     Reorder triangles and vertices for GPU\n";
+    std::cerr << "                              vertex cache and fetch locality\n";
+    std::cerr << "  --lod <r1,r2,...>           Add simplified levels of detail with these\n";
+    std::cerr << "                              triangle fractions as mesh variants\n";
+    std::cerr << "  --compute-normals           Generate smooth normals when the input\n";
+    std::cerr << "                              has no vertex.normal\n";
+    std::cerr << "  --sort-points               Write spheres as points in Morton order,\n";
+    std::cerr << "                              stable across frames by vertex.id\n";
+    std::cerr << "  --detect-rigid <tol>        Write rigidly moving objects as a static\n";
+    std::cerr << "                              mesh plus a time-sampled transform\n";
     return 1;
   }
 
-  const char *inputPath = argv[1];
-  const char *outputPath = argv[2];
-
-  std::cout << "AGX to USD Converter\n";
-  std::cout << "====================\n";
-  std::cout << "Input:  " << inputPath << "\n";
-  std::cout << "Output: " << outputPath << "\n\n";
-
-  // Open AGX file
-  AGXReader reader = agxNewReader(inputPath);
-  if (!reader) {
-    std::cerr << "Error: Failed to open AGX file: " << inputPath << "\n";
-    return 2;
+  if (options.quantizePositions && options.deltaKeyInterval > 0) {
+    std::cerr << "Error: --quantize-positions and --delta-encode are exclusive\n";
+    return 1;
   }
 
-  // Convert to USD
-  bool success = convertToUSDMesh(reader, outputPath);
-
-  // Cleanup
-  agxReleaseReader(reader);
+  if (!tracePath.empty())
+    agx2usd::startTrace(tracePath);
+  const int result = run(positional, scene, options);
+  if (!tracePath.empty())
+    agx2usd::stopTrace();
+  agx2usd::flushLog();
 
-  return success ? 0 : 3;
+  return result;
 }
-
@@ -0,0 +1,38 @@
+// Copyright 2025
+// SPDX-License-Identifier: Apache-2.0
+
+// Checks for the unit tests. A failed check is reported with its location
+// and the test goes on; main() returns testResult().
+
+#pragma once
+
+// std
+#include <cmath>
+#include <iostream>
+
+namespace agx2usd {
+
+inline int testFailures = 0;
+
+inline void testCheck(bool ok, const char *expr, const char *file, int line)
+{
+  if (!ok) {
+    std::cerr << file << ":" << line << ": check failed: " << expr << "\n";
+    ++testFailures;
+  }
+}
+
+inline int testResult()
+{
+  if (testFailures > 0)
+    std::cerr << testFailures << " check(s) failed\n";
+  return testFailures > 0 ? 1 : 0;
+}
+
+} // namespace agx2usd
+
+#define CHECK(expr)                                                            \
+  ::agx2usd::testCheck(static_cast<bool>(expr), #expr, __FILE__, __LINE__)
+
+#define CHECK_NEAR(a, b, tolerance)                                            \
+  CHECK(std::fabs(double(a) - double(b)) <= double(tolerance))
@@ -0,0 +1,167 @@
+// Copyright 2025
+// SPDX-License-Identifier: Apache-2.0
+
+#include "test.h"
+
+#include "capture_writer.h"
+
+// ANARI
+#include <anari/anari.h>
+
+// USD
+#include <pxr/usd/usd/stage.h>
+#include <pxr/usd/usdGeom/mesh.h>
+
+// std
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace agx2usd;
+
+namespace {
+
+bool fileExists(const std::string &path)
+{
+  return std::ifstream(path).good();
+}
+
+std::vector<std::string> statusMessages;
+
+void statusFunc(const void *,
+    ANARIDevice,
+    ANARIObject,
+    ANARIDataType,
+    ANARIStatusSeverity severity,
+    ANARIStatusCode,
+    const char *message)
+{
+  if (severity == ANARI_SEVERITY_ERROR)
+    statusMessages.push_back(message);
+}
+
+// Without a device to wrap, the capture device reports it once through the
+// status callback and returns null handles instead of aborting
+void testMissingWrappedLibrary()
+{
+  setenv("AGX2USD_CAPTURE_WRAPPED", "agx2usd_missing", 1);
+  std::remove("capture_missing.usdc");
+  statusMessages.clear();
+
+  ANARILibrary library = anariLoadLibrary("usdcapture", statusFunc, nullptr);
+  CHECK(library != nullptr);
+  if (!library)
+    return;
+  ANARIDevice device = anariNewDevice(library, "default");
+  CHECK(device != nullptr);
+  if (device) {
+    anariSetParameter(
+        device, device, "outputFile", ANARI_STRING, "capture_missing.usdc");
+    anariCommitParameters(device, device);
+
+    const float positions[] = {0.f, 0.f, 0.f, 1.f, 0.f, 0.f, 0.f, 1.f, 0.f};
+    CHECK(anariNewGeometry(device, "triangle") == nullptr);
+    CHECK(anariNewArray1D(device,
+              positions,
+              nullptr,
+              nullptr,
+              ANARI_FLOAT32_VEC3,
+              3)
+        == nullptr);
+    CHECK(anariNewWorld(device) == nullptr);
+    anariRelease(device, device);
+  }
+  anariUnloadLibrary(library);
+  unsetenv("AGX2USD_CAPTURE_WRAPPED");
+
+  size_t reported = 0;
+  for (const auto &message : statusMessages) {
+    if (message.find("ANARI library 'agx2usd_missing'") != std::string::npos)
+      ++reported;
+  }
+  CHECK(reported == 1);
+  CHECK(!fileExists("capture_missing.usdc"));
+}
+
+// A triangle whose apex moves up with every frame, so each frame is a new
+// point array rather than a rigid transform of the first
+CapturedCommit makeCommit(int frame)
+{
+  const float h = 1.f + 0.5f * frame;
+  const std::vector<float> positions = {
+      0.f, 0.f, 0.f, 1.f, 0.f, 0.f, 0.f, h, 0.f};
+  const std::vector<uint32_t> indices = {0, 1, 2};
+
+  CapturedCommit commit;
+  commit.geometryId = 0;
+  commit.subtype = "triangle";
+  commit.timeCode = frame;
+
+  CapturedArray position;
+  position.name = "vertex.position";
+  position.elementType = ANARI_FLOAT32_VEC3;
+  position.elementCount = 3;
+  position.data = std::make_shared<std::vector<uint8_t>>(
+      reinterpret_cast<const uint8_t *>(positions.data()),
+      reinterpret_cast<const uint8_t *>(positions.data() + positions.size()));
+  commit.arrays.push_back(position);
+
+  if (frame == 0) {
+    CapturedArray index;
+    index.name = "primitive.index";
+    index.elementType = ANARI_UINT32_VEC3;
+    index.elementCount = 1;
+    index.data = std::make_shared<std::vector<uint8_t>>(
+        reinterpret_cast<const uint8_t *>(indices.data()),
+        reinterpret_cast<const uint8_t *>(indices.data() + indices.size()));
+    commit.arrays.push_back(index);
+  }
+  return commit;
+}
+
+// With room for a single commit, every push waits for the writer thread,
+// and no commit is lost
+void testQueueLimit()
+{
+  constexpr int frames = 20;
+  {
+    CaptureWriter writer("capture_queue.usdc", ConvertOptions(), 1);
+    CHECK(writer.isValid());
+    for (int frame = 0; frame < frames; ++frame)
+      writer.push(makeCommit(frame));
+  }
+
+  {
+    auto stage = UsdStage::Open("capture_queue.usdc");
+    CHECK(stage);
+    UsdGeomMesh mesh = stage
+        ? UsdGeomMesh(stage->GetPrimAtPath(SdfPath("/Geometry/geom_0")))
+        : UsdGeomMesh();
+    CHECK(mesh);
+    if (mesh) {
+      std::vector<double> times;
+      mesh.GetPointsAttr().GetTimeSamples(&times);
+      CHECK(times.size() == frames);
+
+      VtVec3fArray points;
+      mesh.GetPointsAttr().Get(&points, UsdTimeCode(frames - 1));
+      CHECK(points.size() == 3);
+      if (points.size() == 3)
+        CHECK_NEAR(points[2][1], 1.f + 0.5f * (frames - 1), 1e-6f);
+    }
+  }
+  std::remove("capture_queue.usdc");
+}
+
+} // namespace
+
+int main()
+{
+  testMissingWrappedLibrary();
+  testQueueLimit();
+  return testResult();
+}
@@ -0,0 +1,199 @@
+// Copyright 2025
+// SPDX-License-Identifier: Apache-2.0
+
+#include "test.h"
+
+#include "checksum.h"
+#include "log.h"
+
+// std
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace agx2usd;
+
+namespace {
+
+// Bit at a time, straight from the definition
+uint32_t referenceCrc32c(const uint8_t *p, size_t size)
+{
+  uint32_t crc = ~0u;
+  for (size_t i = 0; i < size; ++i) {
+    crc ^= p[i];
+    for (int bit = 0; bit < 8; ++bit)
+      crc = (crc >> 1) ^ (0x82F63B78u & (0u - (crc & 1)));
+  }
+  return ~crc;
+}
+
+// Check values of RFC 3720 (iSCSI), appendix B.4
+void testKnownValues()
+{
+  CHECK(crc32c(0, "123456789", 9) == 0xE3069283u);
+  CHECK(crc32c(0, "", 0) == 0u);
+  CHECK(crc32c(0x12345678u, "", 0) == 0x12345678u);
+
+  std::vector<uint8_t> bytes(32, 0);
+  CHECK(crc32c(0, bytes.data(), bytes.size()) == 0x8A9136AAu);
+  std::fill(bytes.begin(), bytes.end(), 0xFF);
+  CHECK(crc32c(0, bytes.data(), bytes.size()) == 0x62A8AB43u);
+  for (size_t i = 0; i < bytes.size(); ++i)
+    bytes[i] = uint8_t(i);
+  CHECK(crc32c(0, bytes.data(), bytes.size()) == 0x46DD794Eu);
+}
+
+// Lengths around the 8-byte words and the interleaved strides of the
+// hardware paths, at every alignment, and continued across any split
+void testAgainstReference()
+{
+  std::mt19937 rng(7);
+  std::vector<uint8_t> bytes(3 * 2048 * 2 + 64);
+  for (uint8_t &b : bytes)
+    b = static_cast<uint8_t>(rng());
+
+  const size_t sizes[] = {
+      1, 7, 8, 9, 63, 64, 1000, 6143, 6144, 6145, 12288, 12300};
+  for (size_t size : sizes) {
+    for (size_t offset = 0; offset < 8; ++offset) {
+      const uint8_t *p = bytes.data() + offset;
+      CHECK(crc32c(0, p, size) == referenceCrc32c(p, size));
+    }
+  }
+
+  const size_t size = 12288 + 17;
+  const uint32_t whole = crc32c(0, bytes.data(), size);
+  for (size_t split : {size_t(0), size_t(1), size_t(5), size_t(4096), size})
+    CHECK(crc32c(crc32c(0, bytes.data(), split), bytes.data() + split,
+              size - split)
+        == whole);
+}
+
+class CapturedErrors
+{
+ public:
+  CapturedErrors() : console(std::cerr.rdbuf(errors.rdbuf())) {}
+
+  ~CapturedErrors()
+  {
+    std::cerr.rdbuf(console);
+  }
+
+  bool contains(const std::string &text) const
+  {
+    return errors.str().find(text) != std::string::npos;
+  }
+
+ private:
+  std::ostringstream errors;
+  std::streambuf *console;
+};
+
+// A file of three sections (the constants and two timesteps) of two
+// parameters each
+std::vector<std::vector<float>> makeSections()
+{
+  return {{1.f, 2.f, 3.f}, {4.f, 5.f}, {6.f, 7.f, 8.f, 9.f}};
+}
+
+AGXParamView makeParam(const char *name, const std::vector<float> &values)
+{
+  AGXParamView pv{};
+  pv.name = name;
+  pv.nameLength = static_cast<uint32_t>(std::strlen(name));
+  pv.data = values.data();
+  pv.dataBytes = values.size() * sizeof(float);
+  return pv;
+}
+
+// Feeds 'count' sections; returns false as soon as one does not match
+bool readSections(ChecksumTable &table,
+    const std::vector<std::vector<float>> &sections,
+    size_t count)
+{
+  for (size_t i = 0; i < count; ++i) {
+    table.beginSection();
+    table.add(makeParam("vertex.position", sections[i]));
+    table.add(makeParam("vertex.radius", sections[i]));
+    if (!table.endSection())
+      return false;
+  }
+  return true;
+}
+
+void testChecksumTable()
+{
+  std::remove("checksum.agx.crc32c");
+  const auto sections = makeSections();
+
+  // Recorded on the first read...
+  {
+    ChecksumTable table("checksum.agx");
+    CHECK(!table.isVerifying());
+    CHECK(readSections(table, sections, 3));
+    CHECK(table.finish());
+  }
+  std::ifstream sidecar("checksum.agx.crc32c");
+  std::string line;
+  CHECK(std::getline(sidecar, line) && line == "# agx2usd crc32c v1");
+  CHECK(std::getline(sidecar, line) && line.rfind("constants ", 0) == 0);
+  CHECK(std::getline(sidecar, line) && line.rfind("0 ", 0) == 0);
+  CHECK(std::getline(sidecar, line) && line.rfind("1 ", 0) == 0);
+  CHECK(!std::getline(sidecar, line));
+  sidecar.close();
+
+  // ...and verified on the next ones
+  {
+    ChecksumTable table("checksum.agx");
+    CHECK(table.isVerifying());
+    CHECK(readSections(table, sections, 3));
+    CHECK(table.finish());
+  }
+
+  CapturedErrors errors;
+  {
+    auto changed = sections;
+    changed[2][1] = 7.5f;
+    ChecksumTable table("checksum.agx");
+    CHECK(!readSections(table, changed, 3));
+    CHECK(errors.contains("Checksum mismatch in time step 1 of checksum.agx"));
+  }
+  {
+    ChecksumTable table("checksum.agx");
+    CHECK(readSections(table, sections, 2));
+    CHECK(!table.finish());
+    CHECK(errors.contains("ends after 2 of 3 checksummed sections"));
+  }
+  {
+    auto more = sections;
+    more.push_back({10.f});
+    ChecksumTable table("checksum.agx");
+    CHECK(!readSections(table, more, 4));
+    CHECK(errors.contains("has more sections than checksum.agx.crc32c"));
+  }
+
+  // Other files under the sidecar name are not taken for checksums
+  std::ofstream("checksum.agx.crc32c") << "something else\n";
+  {
+    ChecksumTable table("checksum.agx");
+    CHECK(!table.isVerifying());
+    CHECK(errors.contains("Ignoring checksum.agx.crc32c"));
+  }
+  std::remove("checksum.agx.crc32c");
+}
+
+} // namespace
+
+int main()
+{
+  testKnownValues();
+  testAgainstReference();
+  testChecksumTable();
+  flushLog();
+  return testResult();
+}
@@ -0,0 +1,149 @@
+// Copyright 2025
+// SPDX-License-Identifier: Apache-2.0
+
+#include "test.h"
+
+#include "geometry_writer.h"
+
+// USD
+#include <pxr/usd/usd/stage.h>
+#include <pxr/usd/usdGeom/mesh.h>
+#include <pxr/usd/usdGeom/points.h>
+
+// std
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+using namespace agx2usd;
+
+namespace {
+
+// An array of vec3 elements as the AGX reader returns it
+template <typename T>
+AGXParamView makeVec3Array(
+    const char *name, ANARIDataType elementType, const std::vector<T> &values)
+{
+  AGXParamView pv{};
+  pv.name = name;
+  pv.nameLength = static_cast<uint32_t>(std::strlen(name));
+  pv.type = ANARI_ARRAY1D;
+  pv.isArray = 1;
+  pv.elementType = elementType;
+  pv.elementCount = values.size() / 3;
+  pv.data = values.data();
+  pv.dataBytes = values.size() * sizeof(T);
+  return pv;
+}
+
+// A quad of two triangles whose far edge rises with every timestep, so each
+// timestep is a new point array rather than a rigid transform of the first
+std::vector<float> quadPositions(int timeStep)
+{
+  const float h = 0.5f * timeStep;
+  return {0.f, 0.f, 0.f, 1.f, 0.f, 0.f, 1.f, 1.f, h, 0.f, 1.f, h};
+}
+
+// A generated triangle geometry of constant topology and three timesteps,
+// converted through the writer the file converter uses
+void testMesh()
+{
+  constexpr int timeSteps = 3;
+  auto stage = UsdStage::CreateInMemory();
+  setupStage(stage, timeSteps - 1);
+
+  const SdfPath path("/Geometry/mesh");
+  ConvertOptions options;
+  auto writer = makeGeometryWriter("triangle", stage, path, options);
+  CHECK(writer != nullptr);
+  if (!writer)
+    return;
+
+  const std::vector<uint32_t> indices = {0, 1, 2, 0, 2, 3};
+  writer->setConstant(
+      makeVec3Array("primitive.index", ANARI_UINT32_VEC3, indices));
+  for (int t = 0; t < timeSteps; ++t) {
+    const std::vector<float> positions = quadPositions(t);
+    writer->beginTimeStep(t);
+    writer->setTimeStepParam(
+        makeVec3Array("vertex.position", ANARI_FLOAT32_VEC3, positions));
+    writer->endTimeStep();
+  }
+  writer->finish();
+  CHECK(writer->getLayerBytes() > 0);
+
+  UsdGeomMesh mesh(stage->GetPrimAtPath(path));
+  CHECK(mesh);
+  if (!mesh)
+    return;
+
+  VtArray<int> faceVertexIndices;
+  VtArray<int> faceVertexCounts;
+  mesh.GetFaceVertexIndicesAttr().Get(&faceVertexIndices);
+  mesh.GetFaceVertexCountsAttr().Get(&faceVertexCounts);
+  CHECK(faceVertexIndices.size() == indices.size());
+  for (size_t i = 0; i < faceVertexIndices.size() && i < indices.size(); ++i)
+    CHECK(faceVertexIndices[i] == static_cast<int>(indices[i]));
+  CHECK(faceVertexCounts.size() == 2);
+  for (int count : faceVertexCounts)
+    CHECK(count == 3);
+
+  std::vector<double> times;
+  mesh.GetPointsAttr().GetTimeSamples(&times);
+  CHECK(times.size() == timeSteps);
+  for (int t = 0; t < timeSteps; ++t) {
+    VtVec3fArray points;
+    mesh.GetPointsAttr().Get(&points, UsdTimeCode(t));
+    CHECK(points.size() == 4);
+    if (points.size() == 4) {
+      CHECK_NEAR(points[1][0], 1.f, 1e-6f);
+      CHECK_NEAR(points[2][2], 0.5f * t, 1e-6f);
+      CHECK_NEAR(points[3][2], 0.5f * t, 1e-6f);
+    }
+  }
+}
+
+// Spheres are converted like any other geometry unless --sort-points asks
+// for UsdGeomPoints
+void testPointsGeometry()
+{
+  ConvertOptions options;
+  CHECK(!isPointsGeometry("sphere", options));
+  CHECK(!isPointsGeometry("triangle", options));
+  options.sortPoints = true;
+  CHECK(isPointsGeometry("sphere", options));
+  CHECK(!isPointsGeometry("triangle", options));
+
+  auto stage = UsdStage::CreateInMemory();
+  setupStage(stage, 0.0);
+  const SdfPath path("/Geometry/points");
+  auto writer = makeGeometryWriter("sphere", stage, path, options);
+  CHECK(writer != nullptr);
+  if (!writer)
+    return;
+
+  const std::vector<float> positions = {0.f, 0.f, 0.f, 2.f, 0.f, 0.f};
+  writer->beginTimeStep(0.0);
+  writer->setTimeStepParam(
+      makeVec3Array("vertex.position", ANARI_FLOAT32_VEC3, positions));
+  writer->endTimeStep();
+  writer->finish();
+
+  UsdGeomPoints points(stage->GetPrimAtPath(path));
+  CHECK(points);
+  if (points) {
+    VtVec3fArray values;
+    points.GetPointsAttr().Get(&values, UsdTimeCode(0.0));
+    CHECK(values.size() == 2);
+  }
+}
+
+} // namespace
+
+int main()
+{
+  testMesh();
+  testPointsGeometry();
+  return testResult();
+}
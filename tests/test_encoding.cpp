@@ -0,0 +1,287 @@
+// Copyright 2025
+// SPDX-License-Identifier: Apache-2.0
+
+#include "test.h"
+
+#include "agx2usd_decode.h"
+#include "encoding.h"
+
+// std
+#include <algorithm>
+#include <random>
+
+using namespace agx2usd;
+
+namespace {
+
+VtArray<GfVec3f> randomPoints(size_t count, float lo, float hi, unsigned seed)
+{
+  std::mt19937 rng(seed);
+  std::uniform_real_distribution<float> dist(lo, hi);
+  VtArray<GfVec3f> points(count);
+  for (auto &p : points)
+    p = GfVec3f(dist(rng), dist(rng), dist(rng));
+  return points;
+}
+
+// Decoding quantized points is within half a step of the input
+void testQuantizeRoundTrip()
+{
+  const VtArray<GfVec3f> points = randomPoints(1000, -3.f, 5.f, 1);
+  const QuantizedPoints q = quantizePoints(points);
+  CHECK(q.values.size() == 3 * points.size());
+  CHECK(q.bounds.size() == 2);
+
+  float bounds[6];
+  for (int c = 0; c < 3; ++c) {
+    bounds[c] = q.bounds[0][c];
+    bounds[3 + c] = q.bounds[1][c];
+  }
+  for (const auto &p : points) {
+    for (int c = 0; c < 3; ++c) {
+      CHECK(p[c] >= bounds[c]);
+      CHECK(p[c] <= bounds[3 + c]);
+    }
+  }
+
+  std::vector<float> decoded(3 * points.size());
+  decodeQuantizedPoints(
+      q.values.cdata(), points.size(), bounds, decoded.data());
+  for (size_t i = 0; i < points.size(); ++i) {
+    for (int c = 0; c < 3; ++c) {
+      const float step = (bounds[3 + c] - bounds[c]) / 65535.f;
+      CHECK_NEAR(decoded[3 * i + c], points[i][c], 0.5f * step + 1e-6f);
+    }
+  }
+}
+
+// A flat axis has an empty range and decodes exactly
+void testQuantizeFlatAxis()
+{
+  VtArray<GfVec3f> points = randomPoints(100, 0.f, 1.f, 2);
+  for (auto &p : points)
+    p[2] = 2.5f;
+  const QuantizedPoints q = quantizePoints(points);
+
+  float bounds[6];
+  for (int c = 0; c < 3; ++c) {
+    bounds[c] = q.bounds[0][c];
+    bounds[3 + c] = q.bounds[1][c];
+  }
+  std::vector<float> decoded(3 * points.size());
+  decodeQuantizedPoints(
+      q.values.cdata(), points.size(), bounds, decoded.data());
+  for (size_t i = 0; i < points.size(); ++i)
+    CHECK(decoded[3 * i + 2] == 2.5f);
+}
+
+void testSnapToGrid()
+{
+  const float precision = 0.01f;
+  const VtArray<GfVec3f> points = randomPoints(1000, -10.f, 10.f, 3);
+  VtArray<GfVec3f> snapped = points;
+  snapToGrid(snapped, precision);
+  for (size_t i = 0; i < points.size(); ++i) {
+    for (int c = 0; c < 3; ++c) {
+      CHECK_NEAR(snapped[i][c], points[i][c], 0.5f * precision + 1e-5f);
+      const float steps = snapped[i][c] / precision;
+      CHECK_NEAR(steps, std::round(steps), 1e-3f);
+    }
+  }
+}
+
+// Decoding the deltas like a consumer does stays within half a precision
+// step of every frame, however many deltas follow a keyframe
+void testDeltaRoundTrip()
+{
+  const float precision = 1e-3f;
+  DeltaEncoder encoder("points", 16, precision);
+  VtArray<GfVec3f> frame = randomPoints(257, -1.f, 1.f, 4);
+  std::mt19937 rng(5);
+  std::uniform_real_distribution<float> motion(-0.01f, 0.01f);
+
+  std::vector<float> decoded;
+  for (uint32_t f = 0; f < 48; ++f) {
+    encoder.encode(frame);
+    CHECK(encoder.keyframe == (f % 16 == 0));
+    if (encoder.keyframe) {
+      CHECK(encoder.deltas.empty());
+      const float *values = frame.cdata()->data();
+      decoded.assign(values, values + 3 * frame.size());
+    } else {
+      CHECK(encoder.deltas.size() == decoded.size());
+      applyDeltas(reinterpret_cast<const int32_t *>(encoder.deltas.cdata()),
+          decoded.size(),
+          precision,
+          decoded.data());
+    }
+    for (size_t i = 0; i < frame.size(); ++i) {
+      for (int c = 0; c < 3; ++c)
+        CHECK_NEAR(decoded[3 * i + c], frame[i][c], 0.5f * precision + 1e-6f);
+    }
+
+    for (auto &p : frame)
+      p = GfVec3f(p[0] + motion(rng), p[1] + motion(rng), p[2] + motion(rng));
+  }
+}
+
+// A change of the vertex count, or a delta too large for an int, starts a
+// new keyframe
+void testDeltaForcedKeyframes()
+{
+  DeltaEncoder encoder("normals", 100, 1e-6f);
+  VtArray<GfVec3f> frame = randomPoints(10, 0.f, 1.f, 6);
+  encoder.encode(frame);
+  CHECK(encoder.keyframe);
+  encoder.encode(frame);
+  CHECK(!encoder.keyframe);
+
+  frame.push_back(GfVec3f(0.f, 0.f, 0.f));
+  encoder.encode(frame);
+  CHECK(encoder.keyframe);
+
+  frame[0] = GfVec3f(1e6f, 0.f, 0.f);
+  encoder.encode(frame);
+  CHECK(encoder.keyframe);
+  CHECK(encoder.sinceKey == 0);
+}
+
+// Refilling an array of the same size reuses its buffer
+void testConvertFloatArrayReuse()
+{
+  std::vector<float> a(30), b(30), c(45);
+  for (size_t i = 0; i < a.size(); ++i) {
+    a[i] = float(i);
+    b[i] = -float(i);
+  }
+  for (size_t i = 0; i < c.size(); ++i)
+    c[i] = 0.5f * float(i);
+  VtArray<GfVec3f> out;
+  convertFloatArray(a.data(), 10, out);
+  CHECK(out.size() == 10);
+  const GfVec3f *buffer = out.cdata();
+
+  convertFloatArray(b.data(), 10, out);
+  CHECK(out.cdata() == buffer);
+  for (size_t i = 0; i < 10; ++i)
+    CHECK(out[i][1] == b[3 * i + 1]);
+
+  convertFloatArray(c.data(), 15, out);
+  CHECK(out.size() == 15);
+  CHECK(out[14][2] == c[44]);
+}
+
+// Random unit vectors, plus the axes and the diagonals where the
+// octahedron folds
+VtArray<GfVec3f> testNormals()
+{
+  VtArray<GfVec3f> normals;
+  for (int axis = 0; axis < 3; ++axis) {
+    for (float sign : {1.f, -1.f}) {
+      GfVec3f n(0.f, 0.f, 0.f);
+      n[axis] = sign;
+      normals.push_back(n);
+    }
+  }
+  const float d = 1.f / std::sqrt(2.f);
+  normals.push_back(GfVec3f(d, d, 0.f));
+  normals.push_back(GfVec3f(-d, 0.f, -d));
+
+  std::mt19937 rng(7);
+  std::normal_distribution<float> dist;
+  while (normals.size() < 1003) {
+    GfVec3f n(dist(rng), dist(rng), dist(rng));
+    const float length = std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+    if (length > 1e-3f)
+      normals.push_back(GfVec3f(n[0] / length, n[1] / length, n[2] / length));
+  }
+  return normals;
+}
+
+// Largest angle in radians between the normals and their decoded values
+double maxAngle(const VtArray<GfVec3f> &normals, const std::vector<float> &out)
+{
+  double maxAngle = 0.0;
+  for (size_t i = 0; i < normals.size(); ++i) {
+    const float *d = &out[3 * i];
+    const double n[3] = {normals[i][0], normals[i][1], normals[i][2]};
+    const double length = std::sqrt(
+        double(d[0]) * d[0] + double(d[1]) * d[1] + double(d[2]) * d[2]);
+    CHECK_NEAR(length, 1.0, 1e-6);
+    // The length of the cross product is precise for small angles
+    const double cross[3] = {n[1] * d[2] - n[2] * d[1],
+        n[2] * d[0] - n[0] * d[2],
+        n[0] * d[1] - n[1] * d[0]};
+    const double sine = std::sqrt(cross[0] * cross[0] + cross[1] * cross[1]
+                            + cross[2] * cross[2])
+        / length;
+    const double dot = (n[0] * d[0] + n[1] * d[1] + n[2] * d[2]) / length;
+    maxAngle = std::max(maxAngle, std::atan2(sine, dot));
+  }
+  return maxAngle;
+}
+
+// Decoding gives unit vectors close to the input. The counts are not
+// multiples of 4, so both the SIMD and the scalar paths are used.
+void testOctNormalsRoundTrip()
+{
+  const VtArray<GfVec3f> normals = testNormals();
+  std::vector<float> decoded(3 * normals.size());
+
+  VtArray<unsigned int> q16;
+  encodeOctNormals16(normals, q16);
+  CHECK(q16.size() == normals.size());
+  decodeOctNormals16(q16.cdata(), q16.size(), decoded.data());
+  CHECK(maxAngle(normals, decoded) < 1e-4);
+
+  VtArray<unsigned char> q8;
+  encodeOctNormals8(normals, q8);
+  CHECK(q8.size() == 2 * normals.size());
+  decodeOctNormals8(q8.cdata(), normals.size(), decoded.data());
+  CHECK(maxAngle(normals, decoded) < 0.02);
+}
+
+// The SIMD and scalar paths agree on every element
+void testOctNormalsPaths()
+{
+  const VtArray<GfVec3f> normals = testNormals();
+  VtArray<unsigned int> all;
+  encodeOctNormals16(normals, all);
+  for (size_t i = 0; i < normals.size(); ++i) {
+    VtArray<unsigned int> one;
+    encodeOctNormals16(VtArray<GfVec3f>(1, normals[i]), one);
+    CHECK(one[0] == all[i]);
+  }
+
+  VtArray<unsigned char> all8;
+  encodeOctNormals8(normals, all8);
+  for (size_t i = 0; i < normals.size(); ++i) {
+    VtArray<unsigned char> one;
+    encodeOctNormals8(VtArray<GfVec3f>(1, normals[i]), one);
+    CHECK(one[0] == all8[2 * i] && one[1] == all8[2 * i + 1]);
+  }
+
+  std::vector<float> decoded(3 * normals.size());
+  decodeOctNormals16(all.cdata(), all.size(), decoded.data());
+  for (size_t i = 0; i < normals.size(); ++i) {
+    float one[3];
+    decodeOctNormals16(all.cdata() + i, 1, one);
+    for (int c = 0; c < 3; ++c)
+      CHECK_NEAR(one[c], decoded[3 * i + c], 1e-6f);
+  }
+}
+
+} // namespace
+
+int main()
+{
+  testQuantizeRoundTrip();
+  testQuantizeFlatAxis();
+  testSnapToGrid();
+  testDeltaRoundTrip();
+  testDeltaForcedKeyframes();
+  testConvertFloatArrayReuse();
+  testOctNormalsRoundTrip();
+  testOctNormalsPaths();
+  return testResult();
+}
@@ -0,0 +1,318 @@
+// Copyright 2025
+// SPDX-License-Identifier: Apache-2.0
+
+#include "test.h"
+
+#include "input.h"
+#include "log.h"
+#include "memory.h"
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// std
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace agx2usd;
+
+namespace {
+
+// Captures the log (std::cout) and the errors (std::cerr) while it lives
+class CapturedOutput
+{
+ public:
+  CapturedOutput()
+      : console(std::cout.rdbuf(log.rdbuf())),
+        errorConsole(std::cerr.rdbuf(errors.rdbuf()))
+  {}
+
+  ~CapturedOutput()
+  {
+    flushLog();
+    std::cout.rdbuf(console);
+    std::cerr.rdbuf(errorConsole);
+  }
+
+  std::string getLog()
+  {
+    flushLog();
+    return log.str();
+  }
+
+  std::string getErrors() const
+  {
+    return errors.str();
+  }
+
+ private:
+  std::ostringstream log;
+  std::ostringstream errors;
+  std::streambuf *console;
+  std::streambuf *errorConsole;
+};
+
+using Bytes = std::vector<uint8_t>;
+
+void writeFile(const std::string &path, const Bytes &bytes)
+{
+  std::ofstream out(path, std::ios::binary | std::ios::trunc);
+  out.write(reinterpret_cast<const char *>(bytes.data()), bytes.size());
+}
+
+void append(Bytes &out, const Bytes &bytes)
+{
+  out.insert(out.end(), bytes.begin(), bytes.end());
+}
+
+void putLE32(Bytes &out, uint32_t v)
+{
+  for (int i = 0; i < 4; ++i)
+    out.push_back(uint8_t(v >> (8 * i)));
+}
+
+// Text that is not an AGX file, so the reader rejects it after it was
+// decompressed
+Bytes content(size_t size)
+{
+  Bytes bytes(size);
+  for (size_t i = 0; i < size; ++i)
+    bytes[i] = uint8_t('a' + i % 26);
+  return bytes;
+}
+
+// A zstd frame with its content in a single raw (stored) block, as zstd
+// writes incompressible data. 'data' must be smaller than 128 KiB.
+Bytes zstdFrame(const Bytes &data)
+{
+  Bytes frame;
+  putLE32(frame, 0xFD2FB528);
+  frame.push_back(0xA0); // single segment, 4-byte content size
+  putLE32(frame, uint32_t(data.size()));
+  const uint32_t blockHeader = uint32_t(data.size()) << 3 | 1; // last, raw
+  for (int i = 0; i < 3; ++i)
+    frame.push_back(uint8_t(blockHeader >> (8 * i)));
+  append(frame, data);
+  return frame;
+}
+
+// A skippable frame, as pzstd writes in front of its output
+Bytes skippableFrame()
+{
+  Bytes frame;
+  putLE32(frame, 0x184D2A50);
+  putLE32(frame, 4);
+  putLE32(frame, 0);
+  return frame;
+}
+
+// An LZ4 frame with independent 64 KB blocks: 'stored' in an uncompressed
+// block, then 'literals' in a compressed block of literals only
+Bytes lz4Frame(const Bytes &stored, const Bytes &literals)
+{
+  Bytes frame;
+  putLE32(frame, 0x184D2204);
+  frame.push_back(0x60); // version 1, independent blocks
+  frame.push_back(0x40); // 64 KB blocks
+  frame.push_back(0x82); // header checksum of the two bytes above
+
+  putLE32(frame, uint32_t(stored.size()) | 0x80000000u);
+  append(frame, stored);
+
+  Bytes block;
+  const size_t n = literals.size();
+  block.push_back(uint8_t(std::min<size_t>(n, 15) << 4));
+  if (n >= 15) {
+    size_t rest = n - 15;
+    for (; rest >= 255; rest -= 255)
+      block.push_back(255);
+    block.push_back(uint8_t(rest));
+  }
+  append(block, literals);
+  putLE32(frame, uint32_t(block.size()));
+  append(frame, block);
+
+  putLE32(frame, 0); // end mark
+  return frame;
+}
+
+// Frames are decompressed into memory before the reader opens them, which
+// fails here as the content is not an AGX file
+void testZstd()
+{
+  Bytes file = skippableFrame();
+  append(file, zstdFrame(content(1000)));
+  append(file, zstdFrame(content(5000)));
+  writeFile("input.agx.zst", file);
+
+  CapturedOutput output;
+  CHECK(openInput("input.agx.zst") == nullptr);
+#ifdef AGX2USD_USE_ZSTD
+  CHECK(output.getLog().find(
+            "Decompressed input.agx.zst (2 blocks) into 5.9 KiB in memory")
+      != std::string::npos);
+
+  file.resize(file.size() - 10);
+  writeFile("input.agx.zst", file);
+  CHECK(openInput("input.agx.zst") == nullptr);
+  CHECK(output.getErrors().find(
+            "Corrupt or truncated compressed file: input.agx.zst")
+      != std::string::npos);
+#else
+  CHECK(output.getErrors().find("built without zstd support")
+      != std::string::npos);
+#endif
+  std::remove("input.agx.zst");
+}
+
+void testLz4()
+{
+  writeFile("input.agx.lz4", lz4Frame(content(3000), content(1000)));
+
+  CapturedOutput output;
+  CHECK(openInput("input.agx.lz4") == nullptr);
+#ifdef AGX2USD_USE_LZ4
+  CHECK(output.getLog().find(
+            "Decompressed input.agx.lz4 (2 blocks) into 3.9 KiB in memory")
+      != std::string::npos);
+#else
+  CHECK(output.getErrors().find("built without LZ4 support")
+      != std::string::npos);
+#endif
+  std::remove("input.agx.lz4");
+}
+
+// Decompressed data is limited to options.maxMemoryBytes: zstd frames by
+// the content size they record, before decompressing, LZ4 blocks while
+// they are decompressed
+void testDecompressLimit()
+{
+  ConvertOptions options;
+  options.maxMemoryBytes = 4096;
+
+  Bytes file = zstdFrame(content(1000));
+  append(file, zstdFrame(content(5000)));
+  writeFile("input.agx.zst", file);
+  writeFile("input.agx.lz4", lz4Frame(content(3000), content(3000)));
+
+  CapturedOutput output;
+  CHECK(openInput("input.agx.zst", options) == nullptr);
+  CHECK(openInput("input.agx.lz4", options) == nullptr);
+#if defined(AGX2USD_USE_ZSTD) && defined(AGX2USD_USE_LZ4)
+  const std::string errors = output.getErrors();
+  const std::string message =
+      " decompresses to more than the memory limit of 4.0 KiB";
+  CHECK(errors.find("input.agx.zst" + message) != std::string::npos);
+  CHECK(errors.find("input.agx.lz4" + message) != std::string::npos);
+  CHECK(output.getLog().find("Decompressed") == std::string::npos);
+#endif
+  std::remove("input.agx.zst");
+  std::remove("input.agx.lz4");
+}
+
+#ifdef __linux__
+
+// Writes 'bytes' into the FIFO 'path' from another thread while it lives.
+// The writer stops when the reader closes its end early.
+class FifoWriter
+{
+ public:
+  FifoWriter(const std::string &path, Bytes bytes)
+      : thread([path, bytes = std::move(bytes)]() {
+          const int fd = open(path.c_str(), O_WRONLY);
+          size_t offset = 0;
+          while (fd >= 0 && offset < bytes.size()) {
+            const ssize_t n =
+                write(fd, bytes.data() + offset, bytes.size() - offset);
+            if (n <= 0)
+              break;
+            offset += static_cast<size_t>(n);
+          }
+          if (fd >= 0)
+            close(fd);
+        })
+  {}
+
+  ~FifoWriter()
+  {
+    thread.join();
+  }
+
+ private:
+  std::thread thread;
+};
+
+// Streams are buffered in memory before they are decompressed
+void testCompressedStream()
+{
+  Bytes bytes = zstdFrame(content(1000));
+  append(bytes, zstdFrame(content(5000)));
+  CHECK(mkfifo("input.fifo", 0600) == 0);
+
+  CapturedOutput output;
+  {
+    FifoWriter writer("input.fifo", bytes);
+    CHECK(openInput("input.fifo") == nullptr);
+  }
+  const std::string log = output.getLog();
+  CHECK(log.find("Read " + formatBytes(bytes.size())
+                 + " from input.fifo into memory")
+      != std::string::npos);
+#ifdef AGX2USD_USE_ZSTD
+  CHECK(log.find("Decompressed input.fifo (2 blocks) into 5.9 KiB in memory")
+      != std::string::npos);
+#else
+  CHECK(output.getErrors().find("built without zstd support")
+      != std::string::npos);
+#endif
+  std::remove("input.fifo");
+}
+
+void testStreamLimit()
+{
+  CHECK(mkfifo("input.fifo", 0600) == 0);
+  ConvertOptions options;
+  options.maxMemoryBytes = 1 << 20;
+
+  CapturedOutput output;
+  {
+    FifoWriter writer("input.fifo", content(2 << 20));
+    CHECK(openInput("input.fifo", options) == nullptr);
+  }
+  CHECK(output.getErrors().find(
+            "input.fifo exceeds the memory limit of 1.0 MiB")
+      != std::string::npos);
+  CHECK(output.getLog().find("into memory") == std::string::npos);
+  std::remove("input.fifo");
+}
+
+#endif
+
+} // namespace
+
+int main()
+{
+#ifdef __linux__
+  // The FIFO writer gets EPIPE instead when the input is rejected early
+  signal(SIGPIPE, SIG_IGN);
+  std::remove("input.fifo");
+
+  testZstd();
+  testLz4();
+  testDecompressLimit();
+  testCompressedStream();
+  testStreamLimit();
+#endif
+  return testResult();
+}
@@ -0,0 +1,116 @@
+// Copyright 2025
+// SPDX-License-Identifier: Apache-2.0
+
+#include "test.h"
+
+#include "log.h"
+
+// std
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace agx2usd;
+
+namespace {
+
+// Everything the log thread wrote to std::cout since the last call
+std::string takeOutput(std::ostringstream &out)
+{
+  flushLog();
+  std::string text = out.str();
+  out.str(std::string());
+  return text;
+}
+
+void testParseLogLevel()
+{
+  LogLevel level = LogLevel::Info;
+  CHECK(parseLogLevel("quiet", level) && level == LogLevel::Quiet);
+  CHECK(parseLogLevel("debug", level) && level == LogLevel::Debug);
+  CHECK(parseLogLevel("trace", level) && level == LogLevel::Trace);
+  CHECK(parseLogLevel("info", level) && level == LogLevel::Info);
+  CHECK(!parseLogLevel("verbose", level) && level == LogLevel::Info);
+  CHECK(!parseLogLevel("", level));
+}
+
+void testLevels(std::ostringstream &out)
+{
+  setLogLevel(LogLevel::Info);
+  CHECK(isLogEnabled(LogLevel::Info));
+  CHECK(!isLogEnabled(LogLevel::Debug));
+  logInfo("shown");
+  logDebug("hidden");
+  logTrace("hidden");
+  CHECK(takeOutput(out) == "shown\n");
+
+  setLogLevel(LogLevel::Quiet);
+  logInfo("hidden");
+  CHECK(takeOutput(out).empty());
+
+  setLogLevel(LogLevel::Trace);
+  logTrace("trace");
+  CHECK(takeOutput(out) == "trace\n");
+  setLogLevel(LogLevel::Info);
+}
+
+void testFormatting(std::ostringstream &out)
+{
+  const std::string longText(200, 'x');
+  logInfo("{} {} {} {}", -42, 42u, uint64_t(1) << 40, 1.5);
+  logInfo("[{}] [{}] [{}]", "text", std::string("string"), longText);
+  logInfo("{} and {} left", 1);
+  const std::string expected = "-42 42 1099511627776 1.5\n"
+                               "[text] [string] ["
+      + longText + "]\n1 and {} left\n";
+  CHECK(takeOutput(out) == expected);
+}
+
+// More records than the queue holds, from several threads: none is lost
+// and each thread's records stay in order
+void testManyThreads(std::ostringstream &out)
+{
+  constexpr int kThreads = 4;
+  constexpr int kRecords = 5000;
+  std::vector<std::thread> threads;
+  for (int t = 0; t < kThreads; ++t) {
+    threads.emplace_back([t]() {
+      for (int i = 0; i < kRecords; ++i)
+        logInfo("{} {}", t, i);
+    });
+  }
+  for (auto &thread : threads)
+    thread.join();
+
+  std::istringstream lines(takeOutput(out));
+  std::vector<int> next(kThreads, 0);
+  int t = 0, i = 0, count = 0;
+  while (lines >> t >> i) {
+    CHECK(t >= 0 && t < kThreads);
+    if (t < 0 || t >= kThreads)
+      break;
+    CHECK(i == next[t]);
+    next[t] = i + 1;
+    ++count;
+  }
+  CHECK(count == kThreads * kRecords);
+}
+
+} // namespace
+
+int main()
+{
+  // The log thread writes to std::cout, captured here
+  std::ostringstream out;
+  std::streambuf *console = std::cout.rdbuf(out.rdbuf());
+
+  testParseLogLevel();
+  testLevels(out);
+  testFormatting(out);
+  testManyThreads(out);
+
+  flushLog();
+  std::cout.rdbuf(console);
+  return testResult();
+}
@@ -0,0 +1,108 @@
+// Copyright 2025
+// SPDX-License-Identifier: Apache-2.0
+
+#include "test.h"
+
+#include "memory.h"
+
+// std
+#include <cstring>
+#include <memory>
+#include <vector>
+
+using namespace agx2usd;
+
+namespace {
+
+void testParseByteSize()
+{
+  uint64_t bytes = 0;
+  CHECK(parseByteSize("1536", bytes) && bytes == 1536);
+  CHECK(parseByteSize("512K", bytes) && bytes == 512 * 1024);
+  CHECK(parseByteSize("800m", bytes) && bytes == 800ull << 20);
+  CHECK(parseByteSize("1.5G", bytes) && bytes == 3ull << 29);
+  CHECK(parseByteSize("2TB", bytes) && bytes == 2ull << 40);
+  for (const char *bad : {"", "0", "-1", "M", "12X", "1GiB", "3 G"})
+    CHECK(!parseByteSize(bad, bytes));
+}
+
+void testFormatBytes()
+{
+  CHECK(formatBytes(0) == "0 B");
+  CHECK(formatBytes(1023) == "1023 B");
+  CHECK(formatBytes(1536) == "1.5 KiB");
+  CHECK(formatBytes(800ull << 20) == "800.0 MiB");
+  CHECK(formatBytes(3ull << 40) == "3.0 TiB");
+  CHECK(formatBytes(5ull << 50) == "5120.0 TiB");
+}
+
+// Without a limit nothing can fail, and without a report there is nothing
+// to sample
+void testTrackerWithoutLimit()
+{
+  MemoryTracker idle(0, 10, false);
+  CHECK(!idle.isActive());
+  MemoryTracker reporting(0, 10, true);
+  CHECK(reporting.isActive());
+  for (int i = 0; i < 10; ++i)
+    CHECK(reporting.sample(100, 200, 300));
+}
+
+// Touch 'bytes' of new memory so it counts towards the resident size
+std::unique_ptr<char[]> touch(size_t bytes)
+{
+  std::unique_ptr<char[]> block(new char[bytes]);
+  std::memset(block.get(), 1, bytes);
+  return block;
+}
+
+// Memory that grows by 8 MiB per timestep fails a limit 160 MiB above the
+// current use after a few of 100 timesteps, well before reaching it
+void testTrackerProjection()
+{
+  const uint64_t resident = readProcessMemory().residentBytes;
+  if (resident == 0) // no /proc
+    return;
+
+  MemoryTracker tracker(resident + (160ull << 20), 100, false);
+  std::vector<std::unique_ptr<char[]>> blocks;
+  int samples = 0;
+  while (samples < 10 && tracker.sample(0, 0, 0)) {
+    blocks.push_back(touch(8 << 20));
+    ++samples;
+  }
+  CHECK(samples >= 3);
+  CHECK(samples < 10);
+
+  MemoryTracker exceeded(1, 100, false);
+  CHECK(!exceeded.sample(0, 0, 0));
+}
+
+// Once exceeded, a scene limit fails for every later sample
+void testSceneLimit()
+{
+  if (readProcessMemory().residentBytes == 0)
+    return;
+
+  SceneMemoryLimit generous(1ull << 50);
+  generous.addTimeSteps(10);
+  for (int i = 0; i < 10; ++i)
+    CHECK(generous.sample());
+
+  SceneMemoryLimit tiny(1);
+  tiny.addTimeSteps(10);
+  CHECK(!tiny.sample());
+  CHECK(!tiny.sample());
+}
+
+} // namespace
+
+int main()
+{
+  testParseByteSize();
+  testFormatBytes();
+  testTrackerWithoutLimit();
+  testTrackerProjection();
+  testSceneLimit();
+  return testResult();
+}
@@ -0,0 +1,113 @@
+// Copyright 2025
+// SPDX-License-Identifier: Apache-2.0
+
+#include "test.h"
+
+#include "morton.h"
+
+// std
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <random>
+#include <vector>
+
+using namespace agx2usd;
+
+namespace {
+
+// Matches std::stable_sort on the low 'keyBits' bits, over several chunks
+void testRadixSortStable(int keyBits)
+{
+  const size_t n = 100000;
+  std::mt19937_64 rng(keyBits);
+  std::vector<uint64_t> keys(n);
+  for (auto &k : keys) // few distinct low bits, so ties are common
+    k = (rng() & ~uint64_t(0xffff)) | (rng() & 0x0f0f);
+  std::vector<uint32_t> values(n);
+  std::iota(values.begin(), values.end(), 0u);
+
+  const uint64_t mask = keyBits >= 64 ? ~uint64_t(0)
+                                      : (uint64_t(1) << keyBits) - 1;
+  std::vector<uint32_t> expected = values;
+  std::stable_sort(
+      expected.begin(), expected.end(), [&](uint32_t a, uint32_t b) {
+        return (keys[a] & mask) < (keys[b] & mask);
+      });
+  const std::vector<uint64_t> input = keys;
+
+  radixSortPairs(keys, values, keyBits);
+  CHECK(values == expected);
+  for (size_t i = 0; i < n; ++i)
+    CHECK(keys[i] == input[values[i]]);
+}
+
+// The corners of a cube come out in Z order: x, then y, then z
+void testMortonCorners()
+{
+  const std::vector<int> shuffled = {5, 2, 7, 0, 3, 6, 1, 4};
+  std::vector<float> points;
+  for (int corner : shuffled) {
+    points.push_back(float(corner & 1));
+    points.push_back(float(corner >> 1 & 1));
+    points.push_back(float(corner >> 2 & 1));
+  }
+  const std::vector<uint32_t> order = mortonOrder(points.data(), 8);
+  CHECK(order.size() == 8);
+  for (size_t i = 0; i < order.size() && i < 8; ++i)
+    CHECK(shuffled[order[i]] == int(i));
+}
+
+// The order is a permutation that brings neighbours together
+void testMortonLocality()
+{
+  const size_t n = 20000;
+  std::mt19937 rng(3);
+  std::uniform_real_distribution<float> dist(-50.f, 50.f);
+  std::vector<float> points(3 * n);
+  for (float &v : points)
+    v = dist(rng);
+
+  const std::vector<uint32_t> order = mortonOrder(points.data(), n);
+  std::vector<uint32_t> sorted = order;
+  std::sort(sorted.begin(), sorted.end());
+  std::vector<uint32_t> identity(n);
+  std::iota(identity.begin(), identity.end(), 0u);
+  CHECK(sorted == identity);
+
+  auto meanStep = [&](const std::vector<uint32_t> &o) {
+    double sum = 0.0;
+    for (size_t i = 1; i < o.size(); ++i) {
+      double d2 = 0.0;
+      for (int c = 0; c < 3; ++c) {
+        const double d = points[3 * o[i] + c] - points[3 * o[i - 1] + c];
+        d2 += d * d;
+      }
+      sum += std::sqrt(d2);
+    }
+    return sum / (o.size() - 1);
+  };
+  CHECK(meanStep(order) < 0.2 * meanStep(identity));
+}
+
+void testMortonEmpty()
+{
+  CHECK(mortonOrder(nullptr, 0).empty());
+  std::vector<uint64_t> keys;
+  std::vector<uint32_t> values;
+  radixSortPairs(keys, values, 32);
+  CHECK(keys.empty() && values.empty());
+}
+
+} // namespace
+
+int main()
+{
+  testRadixSortStable(8);
+  testRadixSortStable(32);
+  testRadixSortStable(63);
+  testMortonCorners();
+  testMortonLocality();
+  testMortonEmpty();
+  return testResult();
+}
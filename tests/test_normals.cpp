@@ -0,0 +1,112 @@
+// Copyright 2025
+// SPDX-License-Identifier: Apache-2.0
+
+#include "test.h"
+
+#include "normals.h"
+
+// std
+#include <cmath>
+#include <utility>
+
+using namespace agx2usd;
+
+namespace {
+
+// An n x n grid of quads in the xy plane, as counter-clockwise triangles
+void makeGrid(int n, VtArray<GfVec3f> &points, VtArray<int> &indices)
+{
+  points.clear();
+  indices.clear();
+  for (int y = 0; y <= n; ++y)
+    for (int x = 0; x <= n; ++x)
+      points.push_back(GfVec3f(float(x), float(y), 0.f));
+  for (int y = 0; y < n; ++y) {
+    for (int x = 0; x < n; ++x) {
+      const int v = y * (n + 1) + x;
+      for (int i : {v, v + 1, v + n + 2, v, v + n + 2, v + n + 1})
+        indices.push_back(i);
+    }
+  }
+}
+
+void checkAll(const VtArray<GfVec3f> &normals, const GfVec3f &expected)
+{
+  for (const auto &n : normals) {
+    for (int c = 0; c < 3; ++c)
+      CHECK_NEAR(n[c], expected[c], 1e-6f);
+  }
+}
+
+// Follows the winding, and follows the points when the same topology is
+// computed again
+void testFlatGrid()
+{
+  VtArray<GfVec3f> points;
+  VtArray<int> indices;
+  makeGrid(8, points, indices);
+
+  NormalGenerator generator;
+  VtArray<GfVec3f> normals;
+  CHECK(generator.compute(points, indices, normals));
+  CHECK(normals.size() == points.size());
+  checkAll(normals, GfVec3f(0.f, 0.f, 1.f));
+
+  // (x, y, 0) -> (x, 0, y) rotates the normals to -y
+  for (auto &p : points)
+    p = GfVec3f(p[0], 0.f, p[1]);
+  CHECK(generator.compute(points, indices, normals));
+  checkAll(normals, GfVec3f(0.f, -1.f, 0.f));
+
+  VtArray<int> flipped = indices;
+  for (size_t i = 0; i < flipped.size(); i += 3)
+    std::swap(flipped[i + 1], flipped[i + 2]);
+  CHECK(generator.compute(points, flipped, normals));
+  checkAll(normals, GfVec3f(0.f, 1.f, 0.f));
+}
+
+// A vertex shared by faces of different area leans towards the larger one
+void testAreaWeighting()
+{
+  const VtArray<GfVec3f> points = {GfVec3f(0.f, 0.f, 0.f),
+      GfVec3f(1.f, 0.f, 0.f),
+      GfVec3f(0.f, 1.f, 0.f),
+      GfVec3f(0.f, 2.f, 0.f),
+      GfVec3f(0.f, 0.f, 2.f)};
+  // Area 0.5 facing +z, area 2 facing +x
+  const VtArray<int> indices = {0, 1, 2, 0, 3, 4};
+
+  NormalGenerator generator;
+  VtArray<GfVec3f> normals;
+  CHECK(generator.compute(points, indices, normals));
+  const float length = std::sqrt(17.f);
+  CHECK_NEAR(normals[0][0], 4.f / length, 1e-6f);
+  CHECK_NEAR(normals[0][1], 0.f, 1e-6f);
+  CHECK_NEAR(normals[0][2], 1.f / length, 1e-6f);
+  CHECK_NEAR(normals[1][2], 1.f, 1e-6f);
+  CHECK_NEAR(normals[4][0], 1.f, 1e-6f);
+}
+
+// Out of range indices fail and leave the normals alone
+void testInvalidIndices()
+{
+  const VtArray<GfVec3f> points = {GfVec3f(0.f, 0.f, 0.f),
+      GfVec3f(1.f, 0.f, 0.f),
+      GfVec3f(0.f, 1.f, 0.f)};
+  NormalGenerator generator;
+  VtArray<GfVec3f> normals(1, GfVec3f(1.f, 2.f, 3.f));
+  CHECK(!generator.compute(points, VtArray<int>{0, 1, 3}, normals));
+  CHECK(!generator.compute(points, VtArray<int>{0, -1, 2}, normals));
+  CHECK(normals.size() == 1);
+  CHECK(normals[0] == GfVec3f(1.f, 2.f, 3.f));
+}
+
+} // namespace
+
+int main()
+{
+  testFlatGrid();
+  testAreaWeighting();
+  testInvalidIndices();
+  return testResult();
+}
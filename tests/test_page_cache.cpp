@@ -0,0 +1,174 @@
+// Copyright 2025
+// SPDX-License-Identifier: Apache-2.0
+
+#include "test.h"
+
+#include "page_cache.h"
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+// std
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+using namespace agx2usd;
+
+namespace {
+
+constexpr uint64_t kMiB = 1 << 20;
+
+#ifdef __linux__
+
+void writeFile(const std::string &path, uint64_t size)
+{
+  std::ofstream out(path, std::ios::binary | std::ios::trunc);
+  const std::vector<char> chunk(kMiB, 'x');
+  for (uint64_t i = 0; i < size; i += kMiB)
+    out.write(chunk.data(), chunk.size());
+}
+
+// Pages of [offset, offset + size) of 'path' in the page cache
+size_t residentPages(const std::string &path, uint64_t offset, uint64_t size)
+{
+  const int file = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  void *map = mmap(nullptr, size, PROT_READ, MAP_SHARED, file, offset);
+  close(file);
+  if (map == MAP_FAILED)
+    return 0;
+  const size_t pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+  std::vector<unsigned char> pages((size + pageSize - 1) / pageSize);
+  size_t resident = 0;
+  if (mincore(map, size, pages.data()) == 0) {
+    for (unsigned char page : pages)
+      resident += page & 1;
+  }
+  munmap(map, size);
+  return resident;
+}
+
+// Reads the whole file, as the AGX reader would
+void readFile(const std::string &path)
+{
+  std::ifstream in(path, std::ios::binary);
+  std::vector<char> chunk(kMiB);
+  while (in.read(chunk.data(), chunk.size()))
+    ;
+}
+
+// Whether pages can be evicted on this file system, which is not the case
+// on tmpfs, for instance
+bool canEvict()
+{
+  writeFile("evict.bin", kMiB);
+  const int file = open("evict.bin", O_RDONLY | O_CLOEXEC);
+  fdatasync(file);
+  posix_fadvise(file, 0, 0, POSIX_FADV_DONTNEED);
+  close(file);
+  const bool evicted = residentPages("evict.bin", 0, kMiB) == 0;
+  std::remove("evict.bin");
+  return evicted;
+}
+
+// The output file is written back, so even its dirty pages leave the page
+// cache, and its content is intact
+void testDropFromPageCache(bool evict)
+{
+  writeFile("page_cache.bin", 8 * kMiB);
+  dropFromPageCache("page_cache.bin");
+  if (evict)
+    CHECK(residentPages("page_cache.bin", 0, 8 * kMiB) == 0);
+
+  std::ifstream in("page_cache.bin", std::ios::binary | std::ios::ate);
+  CHECK(uint64_t(in.tellg()) == 8 * kMiB);
+  in.seekg(5 * kMiB);
+  CHECK(in.get() == 'x');
+  in.close();
+  std::remove("page_cache.bin");
+
+  // Missing files are ignored
+  dropFromPageCache("missing.bin");
+}
+
+// Pages far enough behind the reader are dropped as it advances, the rest
+// once it is done
+void testDropBehind(bool evict)
+{
+  CHECK(DropBehind::create("missing.bin") == nullptr);
+
+  writeFile("page_cache.bin", 48 * kMiB);
+  dropFromPageCache("page_cache.bin");
+  readFile("page_cache.bin");
+  CHECK(residentPages("page_cache.bin", 0, 48 * kMiB) > 0);
+
+  auto dropBehind = DropBehind::create("page_cache.bin");
+  CHECK(dropBehind != nullptr);
+  if (dropBehind && evict) {
+    // Less than the lag and a step: nothing dropped yet
+    dropBehind->advance(24 * kMiB);
+    CHECK(residentPages("page_cache.bin", 0, kMiB) > 0);
+
+    // 16 MiB behind the reader and before are dropped
+    dropBehind->advance(16 * kMiB);
+    CHECK(residentPages("page_cache.bin", 0, 24 * kMiB) == 0);
+    CHECK(residentPages("page_cache.bin", 24 * kMiB, 24 * kMiB) > 0);
+
+    dropBehind.reset();
+    CHECK(residentPages("page_cache.bin", 0, 48 * kMiB) == 0);
+  }
+  std::remove("page_cache.bin");
+}
+
+// Pages far enough behind the writer are written back and dropped as it
+// advances, the rest once it is done, and the content is intact
+void testWriteBehind(bool evict)
+{
+  CHECK(WriteBehind::create("missing.bin") == nullptr);
+
+  std::ofstream out("page_cache.bin", std::ios::binary | std::ios::trunc);
+  auto writeBehind = WriteBehind::create("page_cache.bin");
+  CHECK(writeBehind != nullptr);
+  const std::vector<char> chunk(kMiB, 'x');
+  for (int i = 0; i < 48; ++i) {
+    out.write(chunk.data(), chunk.size());
+    out.flush();
+    if (writeBehind)
+      writeBehind->advance(kMiB);
+  }
+  if (writeBehind && evict) {
+    // A step behind the last write back and before are dropped
+    CHECK(residentPages("page_cache.bin", 0, 16 * kMiB) == 0);
+    CHECK(residentPages("page_cache.bin", 32 * kMiB, 16 * kMiB) > 0);
+  }
+  out.close();
+  writeBehind.reset();
+  if (evict)
+    CHECK(residentPages("page_cache.bin", 0, 48 * kMiB) == 0);
+
+  std::ifstream in("page_cache.bin", std::ios::binary | std::ios::ate);
+  CHECK(uint64_t(in.tellg()) == 48 * kMiB);
+  in.seekg(40 * kMiB);
+  CHECK(in.get() == 'x');
+  in.close();
+  std::remove("page_cache.bin");
+}
+
+#endif
+
+} // namespace
+
+int main()
+{
+#ifdef __linux__
+  const bool evict = canEvict();
+  testDropFromPageCache(evict);
+  testDropBehind(evict);
+  testWriteBehind(evict);
+#endif
+  return testResult();
+}
@@ -0,0 +1,92 @@
+// Copyright 2025
+// SPDX-License-Identifier: Apache-2.0
+
+#include "test.h"
+
+#include "encoding.h"
+#include "parallel.h"
+
+// std
+#include <atomic>
+#include <numeric>
+#include <vector>
+
+using namespace agx2usd;
+
+namespace {
+
+// Every index is visited exactly once, whatever the chunking
+void testParallelRange()
+{
+  for (size_t count : {size_t(0), size_t(1), kGrainSize, 3 * kGrainSize + 7}) {
+    std::vector<std::atomic<int>> visits(count);
+    parallelRange(count, [&](size_t b, size_t e) {
+      CHECK(b <= e);
+      CHECK(e <= count);
+      for (size_t i = b; i < e; ++i)
+        ++visits[i];
+    });
+    for (const auto &v : visits)
+      CHECK(v == 1);
+  }
+
+#ifdef AGX2USD_USE_TBB
+  // Split into tasks of about kGrainSize elements
+  std::atomic<size_t> chunks{0};
+  parallelRange(4 * kGrainSize, [&](size_t, size_t) { ++chunks; });
+  CHECK(chunks > 1);
+#endif
+}
+
+void testParallelForEach()
+{
+  for (size_t count : {size_t(0), size_t(1), size_t(100)}) {
+    std::vector<std::atomic<int>> visits(count);
+    parallelForEach(count, [&](size_t i) { ++visits[i]; });
+    for (const auto &v : visits)
+      CHECK(v == 1);
+  }
+}
+
+void testTaskGroup()
+{
+  std::atomic<int> done{0};
+  TaskGroup group;
+  for (int i = 0; i < 8; ++i)
+    group.run([&]() { ++done; });
+  group.wait();
+  CHECK(done == 8);
+}
+
+// The parallel conversion kernels match a serial copy
+void testConvertKernels()
+{
+  const size_t count = 2 * kGrainSize + 3;
+  std::vector<float> floats(3 * count);
+  std::iota(floats.begin(), floats.end(), 0.f);
+  const VtArray<GfVec3f> points =
+      convertFloatArray<GfVec3f>(floats.data(), count);
+  CHECK(points.size() == count);
+  for (size_t i = 0; i < count; ++i) {
+    for (int c = 0; c < 3; ++c)
+      CHECK(points[i][c] == floats[3 * i + c]);
+  }
+
+  std::vector<uint32_t> indices(count);
+  std::iota(indices.begin(), indices.end(), 0u);
+  const VtArray<int> converted = convertIndices(indices.data(), count);
+  CHECK(converted.size() == count);
+  for (size_t i = 0; i < count; ++i)
+    CHECK(converted[i] == static_cast<int>(indices[i]));
+}
+
+} // namespace
+
+int main()
+{
+  testParallelRange();
+  testParallelForEach();
+  testTaskGroup();
+  testConvertKernels();
+  return testResult();
+}
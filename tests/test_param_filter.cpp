@@ -0,0 +1,74 @@
+// Copyright 2025
+// SPDX-License-Identifier: Apache-2.0
+
+#include "test.h"
+
+#include "param_filter.h"
+
+using namespace agx2usd;
+
+namespace {
+
+void testMatchGlob()
+{
+  CHECK(matchGlob("vertex.position", "vertex.position"));
+  CHECK(!matchGlob("vertex.position", "vertex.positions"));
+  CHECK(!matchGlob("vertex.position", "vertex.positio"));
+
+  // '*' matches any run, including '.' and nothing
+  CHECK(matchGlob("*", ""));
+  CHECK(matchGlob("*", "vertex.position"));
+  CHECK(matchGlob("vertex.*", "vertex.position"));
+  CHECK(matchGlob("vertex.*", "vertex."));
+  CHECK(!matchGlob("vertex.*", "primitive.color"));
+  CHECK(matchGlob("*.color", "vertex.color"));
+  CHECK(matchGlob("*color", "vertex.attribute.color"));
+  CHECK(matchGlob("v*.*n", "vertex.normal.position"));
+  CHECK(matchGlob("**", "a.b"));
+
+  // Backtracking to the last '*'
+  CHECK(matchGlob("*ab", "aab"));
+  CHECK(matchGlob("a*b*c", "abbbc"));
+  CHECK(!matchGlob("a*b*c", "abbbcd"));
+
+  // '?' matches exactly one character
+  CHECK(matchGlob("vertex.attribute?", "vertex.attribute0"));
+  CHECK(!matchGlob("vertex.attribute?", "vertex.attribute"));
+  CHECK(!matchGlob("vertex.attribute?", "vertex.attribute10"));
+  CHECK(matchGlob("vertex?position", "vertex.position"));
+
+  CHECK(matchGlob("", ""));
+  CHECK(!matchGlob("", "a"));
+}
+
+void testParamFilter()
+{
+  const ParamFilter all({}, {});
+  CHECK(all.accepts("vertex.position"));
+  CHECK(all.accepts(""));
+
+  const ParamFilter include({"vertex.position", "vertex.attribute?"}, {});
+  CHECK(include.accepts("vertex.position"));
+  CHECK(include.accepts("vertex.attribute3"));
+  CHECK(!include.accepts("vertex.normal"));
+
+  const ParamFilter exclude({}, {"*.color", "primitive.*"});
+  CHECK(exclude.accepts("vertex.position"));
+  CHECK(!exclude.accepts("vertex.color"));
+  CHECK(!exclude.accepts("primitive.index"));
+
+  // Excludes win over includes
+  const ParamFilter both({"vertex.*"}, {"vertex.color"});
+  CHECK(both.accepts("vertex.position"));
+  CHECK(!both.accepts("vertex.color"));
+  CHECK(!both.accepts("primitive.index"));
+}
+
+} // namespace
+
+int main()
+{
+  testMatchGlob();
+  testParamFilter();
+  return testResult();
+}
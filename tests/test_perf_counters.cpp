@@ -0,0 +1,59 @@
+// Copyright 2025
+// SPDX-License-Identifier: Apache-2.0
+
+#include "test.h"
+
+#include "perf_counters.h"
+
+// std
+#include <cstdio>
+#include <sstream>
+#include <string>
+
+using namespace agx2usd;
+
+namespace {
+
+// Some work the compiler cannot drop
+uint64_t work(uint64_t n)
+{
+  volatile uint64_t sum = 0;
+  for (uint64_t i = 0; i < n; ++i)
+    sum = sum + i * i;
+  return sum;
+}
+
+// Only the phases that ran are reported, and nothing at all without
+// counters (not built with them, or refused by the kernel)
+void testReport()
+{
+  PerfCounters counters;
+  {
+    PerfScope scope(counters, PerfPhase::Convert, 1000);
+    scope.addBytes(24);
+    work(1000000);
+  }
+
+  std::ostringstream report;
+  counters.report(report);
+  const std::string text = report.str();
+  if (!counters.isAvailable()) {
+    CHECK(text.empty());
+    return;
+  }
+  const size_t row = text.find("\n  convert ");
+  unsigned long long bytes = 0;
+  CHECK(row != std::string::npos
+      && std::sscanf(text.c_str() + row, " convert %llu", &bytes) == 1);
+  CHECK(bytes == 1024);
+  CHECK(text.find("\n  read ") == std::string::npos);
+  CHECK(text.find("\n  author ") == std::string::npos);
+}
+
+} // namespace
+
+int main()
+{
+  testReport();
+  return testResult();
+}
@@ -0,0 +1,134 @@
+// Copyright 2025
+// SPDX-License-Identifier: Apache-2.0
+
+#include "test.h"
+
+#include "read_ahead.h"
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// std
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace agx2usd;
+
+namespace {
+
+constexpr uint64_t kMiB = 1 << 20;
+
+void writeFile(const std::string &path, uint64_t size)
+{
+  std::ofstream out(path, std::ios::binary | std::ios::trunc);
+  const std::vector<char> chunk(kMiB, 'x');
+  for (uint64_t i = 0; i < size; i += kMiB)
+    out.write(chunk.data(), chunk.size());
+}
+
+void testCreate()
+{
+  writeFile("read_ahead.bin", 4 * kMiB);
+  CHECK(ReadAhead::create("read_ahead.bin", 4) != nullptr);
+  CHECK(ReadAhead::create("read_ahead.bin", 0) == nullptr);
+  CHECK(ReadAhead::create("missing.bin", 4) == nullptr);
+
+  // Windows above the maximum are clamped, not rejected
+  auto readAhead = ReadAhead::create("read_ahead.bin", 1000000);
+  CHECK(readAhead != nullptr);
+  if (readAhead) {
+    readAhead->advance(2 * kMiB);
+    readAhead->advance(100 * kMiB); // past the end of the file
+  }
+  std::remove("read_ahead.bin");
+
+#ifdef __linux__
+  // Only regular files can be read ahead
+  CHECK(ReadAhead::create("/dev/null", 4) == nullptr);
+  CHECK(ReadAhead::create(".", 4) == nullptr);
+#endif
+}
+
+#ifdef __linux__
+
+// Pages of [offset, offset + size) of 'path' in the page cache
+size_t residentPages(const std::string &path, uint64_t offset, uint64_t size)
+{
+  const int file = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  void *map = mmap(nullptr, size, PROT_READ, MAP_SHARED, file, offset);
+  close(file);
+  if (map == MAP_FAILED)
+    return 0;
+  const size_t pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+  std::vector<unsigned char> pages((size + pageSize - 1) / pageSize);
+  size_t resident = 0;
+  if (mincore(map, size, pages.data()) == 0) {
+    for (unsigned char page : pages)
+      resident += page & 1;
+  }
+  munmap(map, size);
+  return resident;
+}
+
+// Waits up to a second for the readahead of [offset, offset + size)
+bool becomesResident(const std::string &path, uint64_t offset, uint64_t size)
+{
+  for (int i = 0; i < 100; ++i) {
+    if (residentPages(path, offset, size) > 0)
+      return true;
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  return false;
+}
+
+// The window of 'windowMiB' MiB ahead of the reader is requested into the
+// page cache, and nothing beyond it
+void testWindow()
+{
+  writeFile("read_ahead.bin", 8 * kMiB);
+  {
+    const int file = open("read_ahead.bin", O_RDONLY | O_CLOEXEC);
+    fdatasync(file);
+    posix_fadvise(file, 0, 0, POSIX_FADV_DONTNEED);
+    close(file);
+  }
+  // Not observable where pages cannot be evicted, e.g. on tmpfs
+  if (residentPages("read_ahead.bin", 0, 8 * kMiB) > 0) {
+    std::remove("read_ahead.bin");
+    return;
+  }
+
+  auto readAhead = ReadAhead::create("read_ahead.bin", 2);
+  CHECK(readAhead != nullptr);
+  if (readAhead) {
+    CHECK(becomesResident("read_ahead.bin", 0, kMiB));
+    CHECK(becomesResident("read_ahead.bin", kMiB, kMiB));
+    CHECK(residentPages("read_ahead.bin", 3 * kMiB, 5 * kMiB) == 0);
+
+    readAhead->advance(3 * kMiB);
+    CHECK(becomesResident("read_ahead.bin", 4 * kMiB, kMiB));
+    CHECK(residentPages("read_ahead.bin", 6 * kMiB, 2 * kMiB) == 0);
+  }
+  std::remove("read_ahead.bin");
+}
+
+#endif
+
+} // namespace
+
+int main()
+{
+  testCreate();
+#ifdef __linux__
+  testWindow();
+#endif
+  return testResult();
+}
@@ -0,0 +1,146 @@
+// Copyright 2025
+// SPDX-License-Identifier: Apache-2.0
+
+#include "test.h"
+
+#include "reorder.h"
+
+// std
+#include <algorithm>
+#include <array>
+#include <random>
+#include <vector>
+
+using namespace agx2usd;
+
+namespace {
+
+// An n x n grid of quads as triangles, in random order
+VtArray<int> shuffledGrid(int n, unsigned seed)
+{
+  std::vector<std::array<int, 3>> triangles;
+  for (int y = 0; y < n; ++y) {
+    for (int x = 0; x < n; ++x) {
+      const int v = y * (n + 1) + x;
+      triangles.push_back({v, v + 1, v + n + 2});
+      triangles.push_back({v, v + n + 2, v + n + 1});
+    }
+  }
+  std::mt19937 rng(seed);
+  std::shuffle(triangles.begin(), triangles.end(), rng);
+  VtArray<int> indices;
+  for (const auto &t : triangles) {
+    for (int v : t)
+      indices.push_back(v);
+  }
+  return indices;
+}
+
+// Triangles rotated to start at their smallest index, which keeps the
+// winding, and sorted
+std::vector<std::array<int, 3>> canonical(const VtArray<int> &indices)
+{
+  std::vector<std::array<int, 3>> triangles;
+  for (size_t i = 0; i + 2 < indices.size(); i += 3) {
+    std::array<int, 3> t = {indices[i], indices[i + 1], indices[i + 2]};
+    std::rotate(t.begin(), std::min_element(t.begin(), t.end()), t.end());
+    triangles.push_back(t);
+  }
+  std::sort(triangles.begin(), triangles.end());
+  return triangles;
+}
+
+// Average cache misses per triangle with an LRU cache of 'cacheSize'
+double missesPerTriangle(const VtArray<int> &indices, size_t cacheSize)
+{
+  std::vector<int> cache;
+  size_t misses = 0;
+  for (int v : indices) {
+    auto it = std::find(cache.begin(), cache.end(), v);
+    if (it == cache.end()) {
+      ++misses;
+    } else {
+      cache.erase(it);
+    }
+    cache.insert(cache.begin(), v);
+    if (cache.size() > cacheSize)
+      cache.pop_back();
+  }
+  return double(misses) / (indices.size() / 3);
+}
+
+// The reordered mesh has the same triangles with the same winding, numbers
+// vertices in order of first use and misses the cache less
+void testGrid()
+{
+  const int n = 40;
+  const VtArray<int> source = shuffledGrid(n, 1);
+  VertexReorder reorder;
+  reorder.compute(source);
+  CHECK(reorder.isValid());
+  CHECK(reorder.getSourceIndices() == source);
+
+  const VtArray<int> &indices = reorder.getIndices();
+  CHECK(indices.size() == source.size());
+  int next = 0;
+  for (int v : indices) {
+    CHECK(v <= next);
+    next = std::max(next, v + 1);
+  }
+  CHECK(next == (n + 1) * (n + 1));
+
+  // Per-vertex values that are the old vertex number map new indices back
+  VtArray<int> oldVertex(size_t((n + 1) * (n + 1)));
+  for (size_t i = 0; i < oldVertex.size(); ++i)
+    oldVertex[i] = int(i);
+  CHECK(reorder.apply(oldVertex));
+  VtArray<int> mapped;
+  for (int v : indices)
+    mapped.push_back(oldVertex[v]);
+  CHECK(canonical(mapped) == canonical(source));
+
+  CHECK(missesPerTriangle(indices, 32) < 0.8);
+  CHECK(missesPerTriangle(indices, 32) < missesPerTriangle(source, 32));
+}
+
+// Vertices past the largest index keep their place; arrays that do not
+// cover the referenced vertices are left alone
+void testUnreferencedVertices()
+{
+  const VtArray<int> source = {2, 1, 0, 0, 1, 3};
+  VertexReorder reorder;
+  reorder.compute(source);
+  CHECK(reorder.getVertexCount() == 4);
+
+  VtArray<float> values = {0.f, 1.f, 2.f, 3.f, 4.f, 5.f};
+  CHECK(reorder.apply(values));
+  CHECK(values.size() == 6);
+  CHECK(values[4] == 4.f);
+  CHECK(values[5] == 5.f);
+  VtArray<float> sorted(values.begin(), values.begin() + 4);
+  std::sort(sorted.begin(), sorted.end());
+  CHECK(sorted == VtArray<float>({0.f, 1.f, 2.f, 3.f}));
+
+  VtArray<float> small = {0.f, 1.f, 2.f};
+  CHECK(!reorder.apply(small));
+  CHECK(small == VtArray<float>({0.f, 1.f, 2.f}));
+}
+
+void testInvalidIndices()
+{
+  VertexReorder reorder;
+  reorder.compute(VtArray<int>({0, -1, 2}));
+  CHECK(!reorder.isValid());
+  reorder.compute(VtArray<int>());
+  CHECK(!reorder.isValid());
+}
+
+} // namespace
+
+int main()
+{
+  testGrid();
+  testUnreferencedVertices();
+  testInvalidIndices();
+  return testResult();
+}
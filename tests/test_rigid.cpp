@@ -0,0 +1,142 @@
+// Copyright 2025
+// SPDX-License-Identifier: Apache-2.0
+
+#include "test.h"
+
+#include "rigid.h"
+
+// std
+#include <cmath>
+#include <random>
+#include <vector>
+
+using namespace agx2usd;
+
+namespace {
+
+constexpr double kPi = 3.14159265358979323846;
+
+std::vector<float> randomPoints(size_t count, unsigned seed)
+{
+  std::mt19937 rng(seed);
+  std::uniform_real_distribution<float> dist(-1.f, 1.f);
+  std::vector<float> points(3 * count);
+  for (float &v : points)
+    v = dist(rng);
+  return points;
+}
+
+// Rotation by 'angle' around the unit vector of 'axis' (Rodrigues)
+RigidTransform makeTransform(
+    const double axis[3], double angle, const double translation[3])
+{
+  const double length =
+      std::sqrt(axis[0] * axis[0] + axis[1] * axis[1] + axis[2] * axis[2]);
+  const double x = axis[0] / length, y = axis[1] / length,
+               z = axis[2] / length;
+  const double c = std::cos(angle), s = std::sin(angle), t = 1.0 - c;
+
+  RigidTransform transform;
+  auto &r = transform.rotation;
+  r[0][0] = t * x * x + c;
+  r[0][1] = t * x * y - s * z;
+  r[0][2] = t * x * z + s * y;
+  r[1][0] = t * x * y + s * z;
+  r[1][1] = t * y * y + c;
+  r[1][2] = t * y * z - s * x;
+  r[2][0] = t * x * z - s * y;
+  r[2][1] = t * y * z + s * x;
+  r[2][2] = t * z * z + c;
+  for (int i = 0; i < 3; ++i)
+    transform.translation[i] = translation[i];
+  return transform;
+}
+
+std::vector<float> transformPoints(
+    const RigidTransform &transform, const std::vector<float> &points)
+{
+  std::vector<float> out(points.size());
+  const auto &r = transform.rotation;
+  for (size_t i = 0; i < points.size(); i += 3) {
+    for (int k = 0; k < 3; ++k) {
+      out[i + k] = static_cast<float>(r[k][0] * points[i]
+          + r[k][1] * points[i + 1] + r[k][2] * points[i + 2]
+          + transform.translation[k]);
+    }
+  }
+  return out;
+}
+
+// The fit recovers the transform of a rotated and moved point set, and
+// apply() reproduces the frame from the reference
+void testFitRotatedMesh(double angle)
+{
+  const std::vector<float> reference = randomPoints(500, 1);
+  const double axis[3] = {1.0, 2.0, 3.0};
+  const double translation[3] = {5.0, -2.0, 10.0};
+  const RigidTransform truth = makeTransform(axis, angle, translation);
+  const std::vector<float> frame = transformPoints(truth, reference);
+
+  RigidFitter fitter;
+  fitter.setReference(reference.data(), 500);
+  CHECK(fitter.size() == 500);
+
+  RigidTransform fitted;
+  CHECK(fitter.fit(frame.data(), 500, 1e-4, fitted));
+  for (int r = 0; r < 3; ++r) {
+    for (int c = 0; c < 3; ++c)
+      CHECK_NEAR(fitted.rotation[r][c], truth.rotation[r][c], 1e-5);
+    CHECK_NEAR(fitted.translation[r], truth.translation[r], 1e-4);
+  }
+
+  std::vector<float> applied(reference.size());
+  fitter.apply(fitted, applied.data());
+  for (size_t i = 0; i < frame.size(); ++i)
+    CHECK_NEAR(applied[i], frame[i], 1e-4);
+}
+
+// Deformation beyond the tolerance, or another vertex count, is not rigid
+void testRejectDeformation()
+{
+  const std::vector<float> reference = randomPoints(100, 2);
+  RigidFitter fitter;
+  fitter.setReference(reference.data(), 100);
+
+  std::vector<float> frame = reference;
+  frame[3 * 42 + 1] += 0.1f;
+  RigidTransform fitted;
+  CHECK(!fitter.fit(frame.data(), 100, 1e-3, fitted));
+  CHECK(fitter.fit(frame.data(), 100, 0.2, fitted));
+  CHECK(!fitter.fit(reference.data(), 99, 1.0, fitted));
+}
+
+// Rotated normals match the rotation matrix, also in place
+void testRotateVectors()
+{
+  const double axis[3] = {0.0, 0.0, 1.0};
+  const double translation[3] = {7.0, 8.0, 9.0};
+  const RigidTransform quarter = makeTransform(axis, kPi / 2, translation);
+
+  std::vector<float> normals = {1.f, 0.f, 0.f, 0.f, 1.f, 0.f, 0.f, 0.f, 1.f};
+  const std::vector<float> expected = {
+      0.f, 1.f, 0.f, -1.f, 0.f, 0.f, 0.f, 0.f, 1.f};
+  std::vector<float> out(normals.size());
+  rotateVectors(quarter, normals.data(), 3, out.data());
+  for (size_t i = 0; i < out.size(); ++i)
+    CHECK_NEAR(out[i], expected[i], 1e-6);
+
+  rotateVectors(quarter, normals.data(), 3, normals.data());
+  CHECK(normals == out);
+}
+
+} // namespace
+
+int main()
+{
+  testFitRotatedMesh(0.0);
+  testFitRotatedMesh(0.7);
+  testFitRotatedMesh(kPi);
+  testRejectDeformation();
+  testRotateVectors();
+  return testResult();
+}
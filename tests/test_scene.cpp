@@ -0,0 +1,256 @@
+// Copyright 2025
+// SPDX-License-Identifier: Apache-2.0
+
+#include "test.h"
+
+#include "geometry_writer.h"
+#include "scene.h"
+
+// USD
+#include <pxr/usd/sdf/layer.h>
+#include <pxr/usd/sdf/listOp.h>
+#include <pxr/usd/sdf/schema.h>
+#include <pxr/usd/usd/prim.h>
+#include <pxr/usd/usd/stage.h>
+
+// std
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+using namespace agx2usd;
+
+namespace {
+
+constexpr float kTolerance = 1e-3f;
+
+AGXParamView makeVec3Array(
+    const char *name, ANARIDataType elementType, const void *data, size_t count)
+{
+  AGXParamView pv{};
+  pv.name = name;
+  pv.nameLength = static_cast<uint32_t>(std::strlen(name));
+  pv.type = ANARI_ARRAY1D;
+  pv.isArray = 1;
+  pv.elementType = elementType;
+  pv.elementCount = count;
+  pv.data = data;
+  pv.dataBytes = count * 3 * 4;
+  return pv;
+}
+
+// A single triangle of one timestep, fingerprinted the way analyzeObject()
+// reads it from its file
+SceneObject makeObject(const std::string &name,
+    const std::vector<float> &positions,
+    float tolerance = kTolerance)
+{
+  const std::vector<uint32_t> indices = {0, 1, 2};
+
+  ContentHasher hasher(tolerance);
+  hasher.addBytes("triangle", 8);
+  hasher.addValue(1);
+  hasher.add(makeVec3Array(
+      "primitive.index", ANARI_UINT32_VEC3, indices.data(), 1));
+  hasher.addTimeStep(0);
+  hasher.add(makeVec3Array("vertex.position",
+      ANARI_FLOAT32_VEC3,
+      positions.data(),
+      positions.size() / 3));
+
+  SceneObject object;
+  object.primName = name;
+  object.timeSteps = 1;
+  object.fingerprint = hasher.fingerprint;
+  object.centroid = hasher.centroid;
+  return object;
+}
+
+// Translated by (dx, 0, 0), with its second vertex moved by 'error' in y
+std::vector<float> triangle(float dx = 0.f, float error = 0.f)
+{
+  return {dx, 0.f, 0.f, 3.f + dx, error, 0.f, dx, 3.f, 0.f};
+}
+
+bool sameFingerprint(const SceneObject &a, const SceneObject &b)
+{
+  return !(a.fingerprint < b.fingerprint) && !(b.fingerprint < a.fingerprint);
+}
+
+// Indices as prototype references after findPrototypes()
+std::vector<size_t> prototypesOf(std::vector<SceneObject> &objects)
+{
+  for (size_t i = 0; i < objects.size(); ++i)
+    objects[i].prototype = i;
+  findPrototypes(objects);
+  std::vector<size_t> prototypes;
+  for (const auto &object : objects)
+    prototypes.push_back(object.prototype);
+  return prototypes;
+}
+
+// The object layers are in-memory stages, so the references of the root
+// stage resolve
+struct Scene
+{
+  std::vector<UsdStageRefPtr> objectStages;
+  UsdStageRefPtr stage;
+  SdfPath rootPath;
+};
+
+Scene defineScene(std::vector<SceneObject> &objects)
+{
+  Scene scene;
+  for (auto &object : objects) {
+    auto objectStage = UsdStage::CreateInMemory();
+    setupStage(objectStage, 0.0);
+    object.assetPath = objectStage->GetRootLayer()->GetIdentifier();
+    scene.objectStages.push_back(objectStage);
+  }
+  scene.stage = UsdStage::CreateInMemory();
+  scene.rootPath = setupStage(scene.stage, 0.0).GetPrim().GetPath();
+  defineSceneObjects(scene.stage, scene.rootPath, objects);
+  return scene;
+}
+
+std::vector<std::string> referencedAssets(const UsdPrim &prim)
+{
+  SdfReferenceListOp references;
+  prim.GetMetadata(SdfFieldKeys->References, &references);
+  std::vector<std::string> assets;
+  for (const auto &reference : references.GetPrependedItems())
+    assets.push_back(reference.GetAssetPath());
+  return assets;
+}
+
+// Copies of the same geometry fingerprint equal, whatever they are named;
+// other geometry does not
+void testFingerprint()
+{
+  const SceneObject a = makeObject("a", triangle());
+  const SceneObject b = makeObject("b", triangle());
+  CHECK(sameFingerprint(a, b));
+  CHECK_NEAR(a.centroid[0], 1.0, 1e-9);
+  CHECK_NEAR(a.centroid[1], 1.0, 1e-9);
+  CHECK_NEAR(a.centroid[2], 0.0, 1e-9);
+
+  const SceneObject scaled = makeObject("scaled",
+      {0.f, 0.f, 0.f, 6.f, 0.f, 0.f, 0.f, 6.f, 0.f});
+  CHECK(!sameFingerprint(a, scaled));
+}
+
+// All fields of the fingerprint must match
+void testFindPrototypes()
+{
+  std::vector<SceneObject> objects = {makeObject("a", triangle()),
+      makeObject("b", triangle()),
+      makeObject("c", triangle())};
+  objects[1].fingerprint.crc ^= 1; // the same but for the CRC
+
+  const std::vector<size_t> prototypes = prototypesOf(objects);
+  CHECK(prototypes == std::vector<size_t>({0, 1, 0}));
+  CHECK(objects[0].instanceCount == 2);
+  CHECK(objects[1].instanceCount == 1);
+  CHECK(objects[2].instanceCount == 2);
+}
+
+// Distinct objects each reference their own layer, as plain references
+void testDistinctObjects()
+{
+  std::vector<SceneObject> objects = {makeObject("a", triangle()),
+      makeObject("b", {0.f, 0.f, 0.f, 1.f, 0.f, 0.f, 0.f, 2.f, 0.f})};
+  prototypesOf(objects);
+  CHECK(objects[1].prototype == 1);
+
+  Scene scene = defineScene(objects);
+  for (const auto &object : objects) {
+    UsdGeomXform xform(scene.stage->GetPrimAtPath(
+        scene.rootPath.AppendChild(TfToken(object.primName))));
+    CHECK(xform);
+    if (!xform)
+      continue;
+    CHECK(!xform.GetPrim().IsInstanceable());
+    CHECK(referencedAssets(xform.GetPrim())
+        == std::vector<std::string>({object.assetPath}));
+    bool resetsXformStack = false;
+    CHECK(xform.GetOrderedXformOps(&resetsXformStack).empty());
+  }
+}
+
+// A copy translated by (0.5, 0, 0) becomes an instance of the first: both
+// are instanceable references to its layer, the copy placed by the offset
+void testTranslatedDuplicate()
+{
+  std::vector<SceneObject> objects = {
+      makeObject("a", triangle()), makeObject("b", triangle(0.5f))};
+  CHECK(prototypesOf(objects) == std::vector<size_t>({0, 0}));
+  CHECK(objects[1].instanceCount == 2);
+
+  Scene scene = defineScene(objects);
+  UsdGeomXform a(scene.stage->GetPrimAtPath(
+      scene.rootPath.AppendChild(TfToken("a"))));
+  UsdGeomXform b(scene.stage->GetPrimAtPath(
+      scene.rootPath.AppendChild(TfToken("b"))));
+  CHECK(a && b);
+  if (!a || !b)
+    return;
+
+  const std::vector<std::string> prototypeAsset = {objects[0].assetPath};
+  CHECK(a.GetPrim().IsInstanceable());
+  CHECK(b.GetPrim().IsInstanceable());
+  CHECK(referencedAssets(a.GetPrim()) == prototypeAsset);
+  CHECK(referencedAssets(b.GetPrim()) == prototypeAsset);
+
+  bool resetsXformStack = false;
+  CHECK(a.GetOrderedXformOps(&resetsXformStack).empty());
+  const auto ops = b.GetOrderedXformOps(&resetsXformStack);
+  CHECK(ops.size() == 1);
+  if (ops.size() == 1) {
+    CHECK(ops[0].GetOpType() == UsdGeomXformOp::TypeTranslate);
+    GfVec3d translate(0.0, 0.0, 0.0);
+    CHECK(ops[0].Get(&translate));
+    CHECK_NEAR(translate[0], 0.5, 1e-6);
+    CHECK_NEAR(translate[1], 0.0, 1e-6);
+    CHECK_NEAR(translate[2], 0.0, 1e-6);
+  }
+}
+
+// Copies are instanced while their positions differ by less than the
+// tolerance, and converted on their own once they differ by more
+void testInstanceTolerance()
+{
+  const SceneObject a = makeObject("a", triangle());
+  CHECK(sameFingerprint(a, makeObject("b", triangle(0.5f, 1e-4f))));
+  CHECK(!sameFingerprint(a, makeObject("b", triangle(0.5f, 1e-2f))));
+  CHECK(sameFingerprint(makeObject("a", triangle(0.f, 0.f), 0.1f),
+      makeObject("b", triangle(0.5f, 1e-2f), 0.1f)));
+
+  std::vector<SceneObject> objects = {
+      a, makeObject("b", triangle(0.5f, 1e-2f))};
+  CHECK(prototypesOf(objects) == std::vector<size_t>({0, 1}));
+
+  Scene scene = defineScene(objects);
+  UsdGeomXform b(scene.stage->GetPrimAtPath(
+      scene.rootPath.AppendChild(TfToken("b"))));
+  CHECK(b);
+  if (b) {
+    CHECK(!b.GetPrim().IsInstanceable());
+    CHECK(referencedAssets(b.GetPrim())
+        == std::vector<std::string>({objects[1].assetPath}));
+    bool resetsXformStack = false;
+    CHECK(b.GetOrderedXformOps(&resetsXformStack).empty());
+  }
+}
+
+} // namespace
+
+int main()
+{
+  testFingerprint();
+  testFindPrototypes();
+  testDistinctObjects();
+  testTranslatedDuplicate();
+  testInstanceTolerance();
+  return testResult();
+}
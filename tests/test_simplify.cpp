@@ -0,0 +1,129 @@
+// Copyright 2025
+// SPDX-License-Identifier: Apache-2.0
+
+#include "test.h"
+
+#include "simplify.h"
+
+// std
+#include <cmath>
+#include <vector>
+
+using namespace agx2usd;
+
+namespace {
+
+// An n x n grid of quads in the xy plane, as counter-clockwise triangles
+void makeGrid(int n, VtArray<GfVec3f> &points, VtArray<int> &indices)
+{
+  for (int y = 0; y <= n; ++y)
+    for (int x = 0; x <= n; ++x)
+      points.push_back(GfVec3f(float(x), float(y), 0.f));
+  for (int y = 0; y < n; ++y) {
+    for (int x = 0; x < n; ++x) {
+      const int v = y * (n + 1) + x;
+      for (int i : {v, v + 1, v + n + 2, v, v + n + 2, v + n + 1})
+        indices.push_back(i);
+    }
+  }
+}
+
+// Twice the signed area of every triangle, projected to the xy plane
+std::vector<float> signedAreas(
+    const VtArray<GfVec3f> &points, const VtArray<int> &indices)
+{
+  std::vector<float> areas;
+  for (size_t t = 0; t + 2 < indices.size(); t += 3) {
+    const GfVec3f &a = points[indices[t]];
+    const GfVec3f &b = points[indices[t + 1]];
+    const GfVec3f &c = points[indices[t + 2]];
+    areas.push_back(
+        (b[0] - a[0]) * (c[1] - a[1]) - (b[1] - a[1]) * (c[0] - a[0]));
+  }
+  return areas;
+}
+
+// A flat grid loses most of its interior, but keeps its outline and area
+// and flips no triangle
+void testFlatGrid()
+{
+  const int n = 32;
+  VtArray<GfVec3f> points;
+  VtArray<int> indices;
+  makeGrid(n, points, indices);
+  const size_t sourceTriangles = indices.size() / 3;
+
+  MeshSimplifier simplifier;
+  CHECK(simplifier.compute(points, indices, sourceTriangles / 10));
+  CHECK(simplifier.isValid());
+
+  VtArray<GfVec3f> simplified;
+  CHECK(simplifier.apply(points, simplified));
+  const VtArray<int> &result = simplifier.getIndices();
+  CHECK(result.size() % 3 == 0);
+  CHECK(result.size() / 3 < sourceTriangles / 4);
+  for (int v : result)
+    CHECK(v >= 0 && size_t(v) < simplified.size());
+
+  double area = 0.0;
+  for (float a : signedAreas(simplified, result)) {
+    CHECK(a > 0.f);
+    area += 0.5 * a;
+  }
+  CHECK_NEAR(area, n * n, 1e-3);
+
+  // Every simplified vertex is an input vertex, and the corners remain
+  int corners = 0;
+  for (const auto &p : simplified) {
+    CHECK(p[0] == std::round(p[0]) && p[1] == std::round(p[1]));
+    if ((p[0] == 0.f || p[0] == n) && (p[1] == 0.f || p[1] == n))
+      ++corners;
+  }
+  CHECK(corners == 4);
+}
+
+// Later frames follow through the vertex map without simplifying again
+void testApplyLaterFrame()
+{
+  VtArray<GfVec3f> points;
+  VtArray<int> indices;
+  makeGrid(16, points, indices);
+  MeshSimplifier simplifier;
+  CHECK(simplifier.compute(points, indices, 64));
+
+  VtArray<GfVec3f> first, moved = points, second;
+  for (auto &p : moved)
+    p = GfVec3f(p[0] + 1.f, p[1], p[2] + 2.f);
+  CHECK(simplifier.apply(points, first));
+  CHECK(simplifier.apply(moved, second));
+  CHECK(first.size() == second.size());
+  for (size_t i = 0; i < first.size(); ++i)
+    CHECK(second[i] == GfVec3f(first[i][0] + 1.f, first[i][1], 2.f));
+
+  VtArray<GfVec3f> shorter(points.begin(), points.end() - 1);
+  CHECK(!simplifier.apply(shorter, second));
+}
+
+void testInvalidInput()
+{
+  VtArray<GfVec3f> points;
+  VtArray<int> indices;
+  makeGrid(2, points, indices);
+  indices[4] = int(points.size());
+
+  MeshSimplifier simplifier;
+  CHECK(!simplifier.compute(points, indices, 2));
+  CHECK(!simplifier.isValid());
+  VtArray<GfVec3f> out;
+  CHECK(!simplifier.apply(points, out));
+}
+
+} // namespace
+
+int main()
+{
+  testFlatGrid();
+  testApplyLaterFrame();
+  testInvalidInput();
+  return testResult();
+}
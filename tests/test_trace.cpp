@@ -0,0 +1,97 @@
+// Copyright 2025
+// SPDX-License-Identifier: Apache-2.0
+
+#include "test.h"
+
+#include "log.h"
+#include "trace.h"
+
+// std
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+
+using namespace agx2usd;
+
+namespace {
+
+std::string readFile(const std::string &path)
+{
+  std::ifstream in(path);
+  std::stringstream text;
+  text << in.rdbuf();
+  return text.str();
+}
+
+// Thread, start and duration of the event named 'name'
+bool findEvent(const std::string &trace,
+    const std::string &name,
+    double &ts,
+    double &dur,
+    int &tid)
+{
+  const size_t at = trace.find("{\"name\":\"" + name + "\"");
+  if (at == std::string::npos)
+    return false;
+  const size_t fields = trace.find("\"tid\":", at);
+  return fields != std::string::npos
+      && std::sscanf(trace.c_str() + fields,
+             "\"tid\":%d,\"ts\":%lf,\"dur\":%lf",
+             &tid,
+             &ts,
+             &dur)
+      == 3;
+}
+
+// Nested spans on two threads, with details that need escaping
+void testTraceFile()
+{
+  { TraceSpan ignored("before"); }
+
+  CHECK(!isTracing());
+  CHECK(startTrace("test_trace.json"));
+  CHECK(isTracing());
+  CHECK(!startTrace("other.json"));
+  {
+    TraceSpan outer("outer", "say \"hi\"\n");
+    { TraceSpan inner("inner"); }
+    std::thread([]() { TraceSpan worker("worker"); }).join();
+  }
+  CHECK(stopTrace());
+  CHECK(!isTracing());
+  CHECK(!stopTrace());
+  { TraceSpan ignored("after"); }
+
+  const std::string trace = readFile("test_trace.json");
+  std::remove("test_trace.json");
+  CHECK(trace.rfind("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[", 0) == 0);
+  CHECK(trace.find("\n]}\n") == trace.size() - 4);
+  CHECK(trace.find("\"before\"") == std::string::npos);
+  CHECK(trace.find("\"after\"") == std::string::npos);
+  CHECK(trace.find("\"args\":{\"detail\":\"say \\\"hi\\\"\\u000a\"}")
+      != std::string::npos);
+
+  double outerTs = 0, outerDur = 0, innerTs = 0, innerDur = 0;
+  double workerTs = 0, workerDur = 0;
+  int outerTid = 0, innerTid = 0, workerTid = 0;
+  CHECK(findEvent(trace, "outer", outerTs, outerDur, outerTid));
+  CHECK(findEvent(trace, "inner", innerTs, innerDur, innerTid));
+  CHECK(findEvent(trace, "worker", workerTs, workerDur, workerTid));
+  CHECK(outerTid == 1 && innerTid == 1);
+  CHECK(workerTid != 1);
+  // Times are written with three decimals
+  CHECK(innerTs >= outerTs);
+  CHECK(innerTs + innerDur <= outerTs + outerDur + 0.002);
+  CHECK(workerTs + workerDur <= outerTs + outerDur + 0.002);
+}
+
+} // namespace
+
+int main()
+{
+  setLogLevel(LogLevel::Quiet);
+  testTraceFile();
+  return testResult();
+}
@@ -0,0 +1,125 @@
+// Copyright 2025
+// SPDX-License-Identifier: Apache-2.0
+
+#include "test.h"
+
+#include "usdz.h"
+
+// std
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace agx2usd;
+
+namespace {
+
+std::vector<uint8_t> readFile(const std::string &path)
+{
+  std::ifstream in(path, std::ios::binary);
+  return std::vector<uint8_t>(std::istreambuf_iterator<char>(in), {});
+}
+
+bool fileExists(const std::string &path)
+{
+  return std::ifstream(path).good();
+}
+
+uint32_t le16(const std::vector<uint8_t> &b, size_t at)
+{
+  return b[at] | b[at + 1] << 8;
+}
+
+uint32_t le32(const std::vector<uint8_t> &b, size_t at)
+{
+  return le16(b, at) | le16(b, at + 2) << 16;
+}
+
+// Bitwise CRC-32 of the zip format
+uint32_t referenceCrc32(const std::vector<uint8_t> &data)
+{
+  uint32_t crc = 0xFFFFFFFFu;
+  for (uint8_t byte : data) {
+    crc ^= byte;
+    for (int k = 0; k < 8; ++k)
+      crc = (crc & 1) ? 0xEDB88320u ^ (crc >> 1) : crc >> 1;
+  }
+  return ~crc;
+}
+
+// The package holds the crate as a single stored entry whose data starts at
+// a multiple of 64 bytes, with a valid CRC and central directory, also
+// when it is written back and dropped from the page cache as it is written
+void testPackageLayout(size_t crateSize, bool bypassPageCache = false)
+{
+  std::vector<uint8_t> crate(crateSize);
+  std::mt19937 rng(static_cast<uint32_t>(crateSize));
+  for (auto &b : crate)
+    b = uint8_t(rng());
+  {
+    std::ofstream out("layout.partial.usdc", std::ios::binary);
+    out.write(reinterpret_cast<const char *>(crate.data()), crate.size());
+  }
+
+  CHECK(writeUsdzPackage(
+      "layout.partial.usdc", "layout.usdz", bypassPageCache));
+  CHECK(!fileExists("layout.partial.usdc"));
+
+  const std::vector<uint8_t> zip = readFile("layout.usdz");
+  std::remove("layout.usdz");
+  if (zip.size() < 30 + 46 + 22) {
+    CHECK(zip.size() >= 30 + 46 + 22);
+    return;
+  }
+
+  // Local file header
+  CHECK(le32(zip, 0) == 0x04034b50);
+  CHECK(le16(zip, 8) == 0); // stored
+  const uint32_t crc = le32(zip, 14);
+  CHECK(crc == referenceCrc32(crate));
+  CHECK(le32(zip, 18) == crateSize);
+  CHECK(le32(zip, 22) == crateSize);
+  const size_t nameLength = le16(zip, 26);
+  const size_t dataOffset = 30 + nameLength + le16(zip, 28);
+  CHECK(std::string(zip.begin() + 30, zip.begin() + 30 + nameLength)
+      == "layout.usdc");
+  CHECK(dataOffset % 64 == 0);
+  CHECK(dataOffset + crateSize <= zip.size());
+  CHECK(std::equal(crate.begin(), crate.end(), zip.begin() + dataOffset));
+
+  // End of central directory, and the one entry it points to
+  const size_t eocd = zip.size() - 22;
+  CHECK(le32(zip, eocd) == 0x06054b50);
+  CHECK(le16(zip, eocd + 10) == 1);
+  const size_t cd = le32(zip, eocd + 16);
+  CHECK(cd == dataOffset + crateSize);
+  CHECK(le32(zip, cd) == 0x02014b50);
+  CHECK(le32(zip, cd + 16) == crc);
+  CHECK(le32(zip, cd + 42) == 0); // local header offset
+}
+
+void testMissingLayer()
+{
+  CHECK(!writeUsdzPackage("missing.partial.usdc", "missing.usdz", false));
+  CHECK(!fileExists("missing.usdz"));
+}
+
+} // namespace
+
+int main()
+{
+  CHECK(referenceCrc32({'1', '2', '3', '4', '5', '6', '7', '8', '9'})
+      == 0xCBF43926u);
+  testPackageLayout(0);
+  testPackageLayout(1);
+  testPackageLayout(100003);
+  testPackageLayout(5 << 20);
+  testPackageLayout(40 << 20, true);
+  testMissingLayer();
+  return testResult();
+}